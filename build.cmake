@@ -34,6 +34,10 @@ asm_generic(
     ${BFDEV_HEADER_PATH}/bfdev/asm-generic
 )
 
+check_include_files(sys/mman.h BFDEV_HAVE_MMAN)
+check_include_files(sys/uio.h BFDEV_HAVE_UIO)
+check_include_files(linux/futex.h BFDEV_HAVE_FUTEX)
+
 configure_file(
     ${BFDEV_MODULE_PATH}/config.h.in
     ${BFDEV_GENERATED_PATH}/bfdev/config.h
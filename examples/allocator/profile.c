@@ -0,0 +1,77 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "allocator-profile"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <bfdev/log.h>
+#include <bfdev/allocprof.h>
+#include <bfdev/array.h>
+#include <bfdev/btree.h>
+#include <bfdev/radix.h>
+
+#define TEST_LOOP 4096
+
+static const bfdev_btree_ops_t
+test_btree_ops = {
+    .alloc = bfdev_btree_alloc,
+    .free = bfdev_btree_free,
+    .find = bfdev_btree_key_find,
+};
+
+int
+main(int argc, const char *argv[])
+{
+    bfdev_allocprof_t prof_radix, prof_btree, prof_array;
+    BFDEV_DECLARE_RADIX(radix, unsigned long);
+    bfdev_btree_root_t btree;
+    bfdev_array_t array;
+    unsigned long count, *value;
+    uintptr_t key;
+
+    /* One tag per container */
+    bfdev_allocprof_init(&prof_radix, "radix", NULL);
+    bfdev_allocprof_init(&prof_btree, "btree", NULL);
+    bfdev_allocprof_init(&prof_array, "array", NULL);
+
+    radix = BFDEV_RADIX_INIT(&radix, bfdev_allocprof_allocator(&prof_radix));
+    bfdev_btree_init(&btree, &bfdev_btree_layout32,
+                     (bfdev_btree_ops_t *)&test_btree_ops, NULL);
+    btree.alloc = bfdev_allocprof_allocator(&prof_btree);
+    bfdev_array_init(&array, bfdev_allocprof_allocator(&prof_array),
+                     sizeof(*value));
+
+    for (count = 0; count < TEST_LOOP; ++count) {
+        value = bfdev_radix_alloc(&radix, count * 7);
+        if (!value)
+            return 1;
+        *value = count;
+
+        key = count + 1;
+        if (bfdev_btree_insert(&btree, &key, (void *)(count + 1)))
+            return 1;
+
+        value = bfdev_array_push(&array, 1);
+        if (!value)
+            return 1;
+        *value = count;
+    }
+
+    bfdev_allocprof_report(&prof_radix);
+    bfdev_allocprof_report(&prof_btree);
+    bfdev_allocprof_report(&prof_array);
+
+    bfdev_radix_release(&radix);
+    bfdev_btree_release(&btree, NULL, NULL);
+    bfdev_array_release(&array);
+
+    /* Everything handed out came back */
+    if (prof_radix.live || prof_btree.live || prof_array.live)
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "arena-simple"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <bfdev/log.h>
+#include <bfdev/arena.h>
+#include <bfdev/array.h>
+
+#define TEST_CHUNK 1024
+#define TEST_LOOP 4096
+
+int
+main(int argc, const char *argv[])
+{
+    bfdev_arena_mark_t mark;
+    bfdev_arena_t arena;
+    bfdev_array_t array;
+    unsigned long count, *value;
+    void *first, *block;
+
+    bfdev_arena_init(&arena, NULL, TEST_CHUNK);
+
+    /* Spill over many chunks, some oversized */
+    first = bfdev_arena_alloc(&arena, 16, 0);
+    bfdev_arena_mark(&arena, &mark);
+
+    for (count = 0; count < TEST_LOOP; ++count) {
+        block = bfdev_arena_alloc(&arena, count % 2048 + 1, 1UL << (count % 7));
+        if (!block || (uintptr_t)block & ((1UL << (count % 7)) - 1))
+            return 1;
+    }
+
+    /* Everything after the savepoint comes back */
+    bfdev_arena_rollback(&arena, &mark);
+    block = bfdev_arena_alloc(&arena, 16, 0);
+    if (block != first + 16)
+        return 1;
+    bfdev_log_info("rollback reuses %p\n", block);
+
+    /* Temporary container torn down for free */
+    bfdev_arena_reset(&arena);
+    bfdev_array_init(&array, bfdev_arena_allocator(&arena), sizeof(*value));
+
+    for (count = 0; count < TEST_LOOP; ++count) {
+        value = bfdev_array_push(&array, 1);
+        if (!value)
+            return 1;
+        *value = count;
+    }
+
+    value = array.data;
+    for (count = 0; count < TEST_LOOP; ++count) {
+        if (value[count] != count)
+            return 1;
+    }
+
+    bfdev_log_info("array of %lu elements\n", array.index);
+    bfdev_arena_reset(&arena);
+
+    if (bfdev_arena_alloc(&arena, 16, 0) != first)
+        return 1;
+
+    bfdev_arena_release(&arena);
+
+    return 0;
+}
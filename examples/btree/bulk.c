@@ -0,0 +1,161 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "btree-bulk"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <bfdev/log.h>
+#include <bfdev/btree.h>
+#include <bfdev/macro.h>
+#include "../time.h"
+
+#define TEST_LEN 100000
+
+static const bfdev_btree_ops_t
+bench_ops = {
+    .alloc = bfdev_btree_alloc,
+    .free = bfdev_btree_free,
+    .find = bfdev_btree_key_find,
+};
+
+static void *
+bench_stream(uintptr_t *key, void *pdata)
+{
+    uintptr_t *next;
+
+    /* Even keys only, odd ones are inserted afterwards */
+    next = pdata;
+    if (*next > TEST_LEN * 2)
+        return NULL;
+
+    *key = *next;
+    *next += 2;
+
+    return (void *)*key;
+}
+
+static int
+bench_verify(bfdev_btree_root_t *root, uintptr_t step)
+{
+    bfdev_btree_cursor_t cursor;
+    uintptr_t key, expect;
+    void *value;
+
+    /* The cursor starts from the largest key */
+    expect = TEST_LEN * 2;
+    bfdev_btree_cursor_init(&cursor, root);
+    bfdev_btree_cursor_for_each(&cursor, value) {
+        if (*bfdev_btree_cursor_key(&cursor) != expect ||
+            value != (void *)expect)
+            return 1;
+        expect -= step;
+    }
+
+    if (expect)
+        return 1;
+
+    for (key = step; key <= TEST_LEN * 2; key += step) {
+        if (bfdev_btree_lookup(root, &key) != (void *)key)
+            return 1;
+    }
+
+    return 0;
+}
+
+static int
+bench_shape(bfdev_btree_root_t *root, bfdev_btree_node_t *node,
+            unsigned int height)
+{
+    bfdev_btree_layout_t *layout;
+    unsigned int index;
+    void *child;
+
+    layout = root->layout;
+    for (index = 0; index < layout->keynum; ++index) {
+        child = (void *)node->block[layout->ptrindex + index];
+        if (!child)
+            break;
+
+        if (height > 1 && bench_shape(root, child, height - 1))
+            return 1;
+    }
+
+    /* Every node but the root is at least half full */
+    return node != root->node && index < layout->keynum / 2;
+}
+
+static int
+bench_bulk(unsigned int fill)
+{
+    uintptr_t key, next;
+    int retval;
+
+    BFDEV_BTREE_ROOT(
+        root, &bfdev_btree_layoutptr,
+        &bench_ops, NULL
+    );
+
+    bfdev_log_info("Bulk load fill %u%%:\n", fill);
+    next = 2;
+    retval = EXAMPLE_TIME_STATISTICAL(
+        bfdev_btree_bulk_load(&root, fill, bench_stream, &next);
+    );
+    if (retval || bench_verify(&root, 2) ||
+        bench_shape(&root, root.node, root.height))
+        return 1;
+
+    bfdev_log_info("Insert odd keys after fill %u%%:\n", fill);
+    retval = EXAMPLE_TIME_STATISTICAL(
+        for (key = 1; key < TEST_LEN * 2; key += 2) {
+            retval = bfdev_btree_insert(&root, &key, (void *)key);
+            if (retval)
+                break;
+        }
+        retval;
+    );
+    if (retval || bench_verify(&root, 1))
+        return 1;
+
+    bfdev_btree_release(&root, NULL, NULL);
+
+    return 0;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    static const unsigned int fills[] = {100, 70, 50};
+    unsigned int index;
+    uintptr_t key;
+    int retval;
+
+    BFDEV_BTREE_ROOT(
+        root, &bfdev_btree_layoutptr,
+        &bench_ops, NULL
+    );
+
+    bfdev_log_info("Insert one by one:\n");
+    retval = EXAMPLE_TIME_STATISTICAL(
+        for (key = 2; key <= TEST_LEN * 2; key += 2) {
+            retval = bfdev_btree_insert(&root, &key, (void *)key);
+            if (retval)
+                break;
+        }
+        retval;
+    );
+    if (retval || bench_verify(&root, 2))
+        return 1;
+
+    bfdev_btree_release(&root, NULL, NULL);
+
+    for (index = 0; index < BFDEV_ARRAY_SIZE(fills); ++index) {
+        if (bench_bulk(fills[index]))
+            return 1;
+    }
+
+    return 0;
+}
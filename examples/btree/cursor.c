@@ -0,0 +1,183 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "btree-cursor"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <bfdev/log.h>
+#include <bfdev/btree.h>
+#include "../time.h"
+
+#define TEST_LEN 1000000
+#define TEST_MIN (TEST_LEN / 4)
+#define TEST_MAX (TEST_LEN / 4 * 3)
+
+struct bench_range {
+    uintptr_t next;
+    uintptr_t last;
+};
+
+static const bfdev_btree_ops_t
+bench_ops = {
+    .alloc = bfdev_btree_alloc,
+    .free = bfdev_btree_free,
+    .find = bfdev_btree_key_find,
+};
+
+static void *
+bench_stream(uintptr_t *key, void *pdata)
+{
+    struct bench_range *range;
+
+    range = pdata;
+    if (range->next > range->last)
+        return NULL;
+
+    *key = range->next++;
+    return (void *)*key;
+}
+
+static int
+bench_verify(bfdev_btree_root_t *root, uintptr_t hole)
+{
+    bfdev_btree_cursor_t cursor;
+    uintptr_t expect;
+    void *value;
+
+    /* Forward from the largest key, skipping the removed range */
+    expect = TEST_LEN;
+    bfdev_btree_cursor_init(&cursor, root);
+    bfdev_btree_cursor_for_each(&cursor, value) {
+        if (*bfdev_btree_cursor_key(&cursor) != expect ||
+            value != (void *)expect)
+            return 1;
+
+        if (--expect == TEST_MAX && hole)
+            expect = TEST_MIN - 1;
+    }
+
+    if (expect)
+        return 1;
+
+    expect = 1;
+    bfdev_btree_cursor_for_each_reverse(&cursor, value) {
+        if (value != (void *)expect)
+            return 1;
+
+        if (++expect == TEST_MIN && hole)
+            expect = TEST_MAX + 1;
+    }
+
+    return expect != TEST_LEN + 1;
+}
+
+static int
+bench_query(bfdev_btree_root_t *root)
+{
+    bfdev_btree_cursor_t cursor;
+    uintptr_t key, count;
+    void *value;
+
+    /* Seeking between two keys lands on the smaller one */
+    key = TEST_MAX;
+    bfdev_btree_cursor_init(&cursor, root);
+    value = bfdev_btree_cursor_seek(&cursor, &key);
+
+    count = 0;
+    bfdev_btree_cursor_for_each_from(&cursor, value) {
+        if (*bfdev_btree_cursor_key(&cursor) < TEST_MIN)
+            break;
+        count++;
+    }
+
+    return count != TEST_MAX - TEST_MIN + 1;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    struct bench_range range;
+    bfdev_btree_cursor_t cursor;
+    uintptr_t key, sum, min, max;
+    unsigned long removed;
+    void *value;
+    int retval;
+
+    BFDEV_BTREE_ROOT(
+        root, &bfdev_btree_layoutptr,
+        &bench_ops, NULL
+    );
+
+    range.next = 1;
+    range.last = TEST_LEN;
+
+    bfdev_log_info("Batch insert %u keys:\n", TEST_LEN);
+    retval = EXAMPLE_TIME_STATISTICAL(
+        bfdev_btree_insert_batch(&root, bench_stream, &range);
+    );
+    if (retval || bench_verify(&root, 0))
+        return 1;
+
+    bfdev_log_info("Scan by key:\n");
+    sum = 0;
+    EXAMPLE_TIME_STATISTICAL(
+        bfdev_btree_for_each(&root, &key, value)
+            sum += key;
+        0;
+    );
+    if (sum != (uintptr_t)TEST_LEN * (TEST_LEN + 1) / 2)
+        return 1;
+
+    bfdev_log_info("Scan by cursor:\n");
+    sum = 0;
+    bfdev_btree_cursor_init(&cursor, &root);
+    EXAMPLE_TIME_STATISTICAL(
+        bfdev_btree_cursor_for_each(&cursor, value)
+            sum += (uintptr_t)value;
+        0;
+    );
+    if (sum != (uintptr_t)TEST_LEN * (TEST_LEN + 1) / 2)
+        return 1;
+
+    bfdev_log_info("Range query by cursor:\n");
+    retval = EXAMPLE_TIME_STATISTICAL(
+        bench_query(&root);
+    );
+    if (retval)
+        return 1;
+
+    bfdev_log_info("Range remove:\n");
+    min = TEST_MIN;
+    max = TEST_MAX;
+    removed = 0;
+    EXAMPLE_TIME_STATISTICAL(
+        removed = bfdev_btree_remove_range(&root, &min, &max, NULL, NULL);
+        0;
+    );
+    if (removed != TEST_MAX - TEST_MIN + 1 || bench_verify(&root, 1))
+        return 1;
+
+    bfdev_log_info("Batch insert back the range:\n");
+    range.next = TEST_MIN;
+    range.last = TEST_MAX;
+    retval = EXAMPLE_TIME_STATISTICAL(
+        bfdev_btree_insert_batch(&root, bench_stream, &range);
+    );
+    if (retval || bench_verify(&root, 0))
+        return 1;
+
+    /* Removing everything leaves an empty walk */
+    min = 1;
+    max = TEST_LEN;
+    removed = bfdev_btree_remove_range(&root, &min, &max, NULL, NULL);
+    if (removed != TEST_LEN || bfdev_btree_cursor_first(&cursor))
+        return 1;
+
+    bfdev_btree_release(&root, NULL, NULL);
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "buddy-simple"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <bfdev/log.h>
+#include <bfdev/buddy.h>
+#include <bfdev/size.h>
+
+#define TEST_REGION BFDEV_SZ_16MiB
+#define TEST_PAGE BFDEV_SZ_4KiB
+#define TEST_SLOTS 256
+#define TEST_LOOP 65536
+#define TEST_ORDER 6
+
+struct test_slot {
+    unsigned char *block;
+    unsigned int order;
+};
+
+int
+main(int argc, const char *argv[])
+{
+    struct test_slot slots[TEST_SLOTS];
+    unsigned long count, pages;
+    unsigned int index, seed;
+    bfdev_buddy_t buddy;
+    void *memory, *block;
+    size_t size;
+    int retval;
+
+    memory = malloc(TEST_REGION);
+    if (!memory)
+        return 1;
+
+    retval = bfdev_buddy_init(&buddy, memory, TEST_REGION, TEST_PAGE);
+    if (retval)
+        return retval;
+
+    pages = buddy.avail;
+    bfdev_log_info("managing %lu pages\n", pages);
+    memset(slots, 0, sizeof(slots));
+
+    seed = 0;
+    for (count = 0; count < TEST_LOOP; ++count) {
+        index = rand_r(&seed) % TEST_SLOTS;
+
+        if (slots[index].block) {
+            /* A damaged pattern means two blocks overlapped */
+            size = (size_t)TEST_PAGE << slots[index].order;
+            if (slots[index].block[0] != (unsigned char)index ||
+                slots[index].block[size - 1] != (unsigned char)index)
+                return 1;
+
+            bfdev_buddy_free(&buddy, slots[index].block);
+            slots[index].block = NULL;
+            continue;
+        }
+
+        slots[index].order = rand_r(&seed) % (TEST_ORDER + 1);
+        slots[index].block = bfdev_buddy_alloc(&buddy, slots[index].order);
+        if (!slots[index].block)
+            continue;
+
+        /* Blocks are aligned to their own size */
+        size = (size_t)TEST_PAGE << slots[index].order;
+        if (((void *)slots[index].block - buddy.base) & (size - 1))
+            return 1;
+
+        memset(slots[index].block, index, size);
+    }
+
+    for (index = 0; index < TEST_SLOTS; ++index) {
+        if (slots[index].block)
+            bfdev_buddy_free(&buddy, slots[index].block);
+    }
+
+    /* Everything coalesced back */
+    if (buddy.avail != pages)
+        return 1;
+
+    block = bfdev_malloc(bfdev_buddy_allocator(&buddy), TEST_PAGE + 1);
+    if (!block || buddy.avail != pages - 2)
+        return 1;
+
+    block = bfdev_realloc(bfdev_buddy_allocator(&buddy), block, TEST_PAGE * 3);
+    if (!block || buddy.avail != pages - 4)
+        return 1;
+
+    bfdev_free(bfdev_buddy_allocator(&buddy), block);
+    bfdev_log_info("available %lu pages\n", buddy.avail);
+    free(memory);
+
+    return buddy.avail != pages;
+}
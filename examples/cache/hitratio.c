@@ -0,0 +1,201 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "cache-hitratio"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <bfdev/log.h>
+#include <bfdev/cache.h>
+#include <bfdev/macro.h>
+
+#define TEST_SIZE 1024
+#define TEST_KEYS (TEST_SIZE * 64)
+#define TEST_TRACE (1UL << 19)
+#define TEST_SCAN_PERIOD (TEST_SIZE * 16)
+#define TEST_SCAN_LENGTH (TEST_SIZE * 2)
+
+static unsigned long
+cache_hash(const void *tag, void *pdata)
+{
+    return (unsigned long)(uintptr_t)tag;
+}
+
+static long
+cache_find(const void *node, const void *tag, void *pdata)
+{
+    return node != tag;
+}
+
+static const bfdev_cache_ops_t
+cache_ops = {
+    .hash = cache_hash,
+    .find = cache_find,
+};
+
+static inline unsigned long
+test_random(unsigned long *seed)
+{
+    unsigned long value;
+
+    value = *seed;
+    value ^= value << 13;
+    value ^= value >> 7;
+    value ^= value << 17;
+    *seed = value;
+
+    return value;
+}
+
+static unsigned long
+trace_generate(unsigned long *trace)
+{
+    unsigned long count, index, seed, scan;
+    unsigned long min, max, mid;
+    double *cdf, sum, value;
+
+    cdf = malloc(sizeof(*cdf) * TEST_KEYS);
+    if (!cdf)
+        return 0;
+
+    /* Zipf distribution with s = 1 */
+    for (sum = 0, index = 0; index < TEST_KEYS; ++index) {
+        sum += 1.0 / (index + 1);
+        cdf[index] = sum;
+    }
+
+    seed = 0x9e3779b97f4a7c15UL;
+    scan = TEST_KEYS;
+
+    for (count = 0; count < TEST_TRACE; ++count) {
+        /* Periodic one-shot scans flush recency based policies */
+        if (count % TEST_SCAN_PERIOD < TEST_SCAN_LENGTH) {
+            trace[count] = ++scan;
+            continue;
+        }
+
+        value = (double)(test_random(&seed) >> 11) / (1UL << 53) * sum;
+        for (min = 0, max = TEST_KEYS - 1; min < max;) {
+            mid = (min + max) / 2;
+            if (cdf[mid] < value)
+                min = mid + 1;
+            else
+                max = mid;
+        }
+
+        /* Tag 0 would collide with a cleared data pointer */
+        trace[count] = min + 1;
+    }
+
+    free(cdf);
+
+    return TEST_TRACE;
+}
+
+static unsigned long
+trace_load(const char *path, unsigned long **ptrace)
+{
+    unsigned long *trace, *nblock, value, count, size;
+    FILE *file;
+
+    file = fopen(path, "r");
+    if (!file)
+        return 0;
+
+    trace = NULL;
+    count = size = 0;
+
+    while (fscanf(file, "%lu", &value) == 1) {
+        if (count == size) {
+            size = size ? size * 2 : TEST_TRACE;
+            nblock = realloc(trace, sizeof(*trace) * size);
+            if (!nblock) {
+                count = 0;
+                break;
+            }
+            trace = nblock;
+        }
+
+        trace[count++] = value + 1;
+    }
+
+    fclose(file);
+    *ptrace = trace;
+
+    return count;
+}
+
+static int
+trace_replay(const char *name, const unsigned long *trace,
+             unsigned long length)
+{
+    bfdev_cache_head_t *cache;
+    bfdev_cache_node_t *node;
+    bfdev_cache_stats_t stats;
+    unsigned long count;
+
+    cache = bfdev_cache_create(name, NULL, &cache_ops, TEST_SIZE, 1, NULL);
+    if (!cache)
+        return 1;
+
+    for (count = 0; count < length; ++count) {
+        node = bfdev_cache_get(cache, (void *)trace[count]);
+        if (!node)
+            return 1;
+
+        if (node->status == BFDEV_CACHE_PENDING) {
+            node->data = (void *)trace[count];
+            bfdev_cache_committed(cache);
+        }
+
+        bfdev_cache_put(cache, node);
+    }
+
+    bfdev_cache_stats(cache, &stats);
+    bfdev_log_info("\t%-8s hits %8lu misses %8lu ratio %.2f%%\n",
+                   name, stats.hits, stats.misses,
+                   (double)stats.hits * 100 / length);
+    bfdev_cache_destroy(cache);
+
+    return 0;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    const char *algos[] = {"lru", "lfu", "lfuo1", "clock", "clockpro", "arc", "tinylfu"};
+    unsigned long *trace, length;
+    unsigned int index;
+    int retval;
+
+    if (argc > 1) {
+        trace = NULL;
+        length = trace_load(argv[1], &trace);
+        bfdev_log_info("Replay %s (%lu accesses):\n", argv[1], length);
+    } else {
+        trace = malloc(sizeof(*trace) * TEST_TRACE);
+        length = trace ? trace_generate(trace) : 0;
+        bfdev_log_info("Replay zipf with scans (%lu accesses):\n", length);
+    }
+
+    if (!length) {
+        bfdev_log_err("Failed to prepare trace!\n");
+        free(trace);
+        return 1;
+    }
+
+    for (index = 0; index < BFDEV_ARRAY_SIZE(algos); ++index) {
+        retval = trace_replay(algos[index], trace, length);
+        if (retval)
+            goto finish;
+    }
+
+    bfdev_log_info("Done.\n");
+
+finish:
+    free(trace);
+    return retval;
+}
@@ -0,0 +1,114 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "cache-lfu"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <bfdev/log.h>
+#include <bfdev/cache.h>
+#include "../time.h"
+
+#define TEST_SIZE (1UL << 20)
+#define TEST_RANGE (TEST_SIZE * 2)
+#define TEST_LOOP (TEST_SIZE * 4)
+
+static unsigned long
+cache_hash(const void *tag, void *pdata)
+{
+    return (unsigned long)(uintptr_t)tag;
+}
+
+static long
+cache_find(const void *node, const void *tag, void *pdata)
+{
+    return node != tag;
+}
+
+static const bfdev_cache_ops_t
+cache_ops = {
+    .hash = cache_hash,
+    .find = cache_find,
+};
+
+static inline unsigned long
+test_random(unsigned long *seed)
+{
+    unsigned long value;
+
+    value = *seed;
+    value ^= value << 13;
+    value ^= value >> 7;
+    value ^= value << 17;
+    *seed = value;
+
+    return value;
+}
+
+static int
+cache_bench(const char *name)
+{
+    bfdev_cache_head_t *cache;
+    bfdev_cache_node_t *node;
+    unsigned long count, value, seed;
+    int retval;
+
+    bfdev_log_info("Benchmark %s:\n", name);
+    cache = bfdev_cache_create(name, NULL, &cache_ops, TEST_SIZE, 1, NULL);
+    if (!cache)
+        return 1;
+
+    seed = 0x9e3779b97f4a7c15UL;
+    retval = EXAMPLE_TIME_STATISTICAL(
+        for (count = 0; count < TEST_LOOP; ++count) {
+            value = test_random(&seed);
+
+            /* 80% of the accesses go to 20% of the tags */
+            if (value % 10 < 8)
+                value = (value >> 8) % (TEST_RANGE / 5);
+            else
+                value = (value >> 8) % TEST_RANGE;
+
+            /* Tag 0 would collide with a cleared data pointer */
+            value++;
+
+            node = bfdev_cache_get(cache, (void *)value);
+            if (!node)
+                break;
+
+            if (node->status == BFDEV_CACHE_PENDING) {
+                node->data = (void *)value;
+                bfdev_cache_committed(cache);
+            }
+
+            bfdev_cache_put(cache, node);
+        }
+        count != TEST_LOOP;
+    );
+
+    bfdev_log_debug("\thits %lu misses %lu\n", cache->hits, cache->misses);
+    bfdev_cache_destroy(cache);
+
+    return retval;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    int retval;
+
+    retval = cache_bench("lfu");
+    if (retval)
+        return retval;
+
+    retval = cache_bench("lfuo1");
+    if (retval)
+        return retval;
+
+    bfdev_log_info("Done.\n");
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "cache-sharded"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <bfdev/log.h>
+#include <bfdev/cache-shard.h>
+#include <bfdev/macro.h>
+#include <bfdev/bug.h>
+
+#define TEST_SIZE 4096
+#define TEST_RANGE (TEST_SIZE * 4)
+#define TEST_LOOP (1UL << 16)
+#define TEST_THREADS 16
+#define TEST_SHARDS 16
+
+struct test_thread {
+    pthread_t thread;
+    bfdev_cache_shard_t *shard;
+    unsigned long seed;
+};
+
+static unsigned long
+cache_hash(const void *tag, void *pdata)
+{
+    return (unsigned long)(uintptr_t)tag;
+}
+
+static long
+cache_find(const void *node, const void *tag, void *pdata)
+{
+    return node != tag;
+}
+
+static const bfdev_cache_ops_t
+cache_ops = {
+    .hash = cache_hash,
+    .find = cache_find,
+};
+
+static inline unsigned long
+test_random(unsigned long *seed)
+{
+    unsigned long value;
+
+    value = *seed;
+    value ^= value << 13;
+    value ^= value >> 7;
+    value ^= value << 17;
+    *seed = value;
+
+    return value;
+}
+
+static void *
+cache_worker(void *data)
+{
+    struct test_thread *tdata;
+    bfdev_cache_node_t *node;
+    unsigned long count, value;
+
+    tdata = data;
+    for (count = 0; count < TEST_LOOP; ++count) {
+        value = test_random(&tdata->seed);
+
+        /* 80% of the accesses go to 20% of the tags */
+        if (value % 10 < 8)
+            value = (value >> 8) % (TEST_RANGE / 5);
+        else
+            value = (value >> 8) % TEST_RANGE;
+
+        /* Tag 0 would collide with a cleared data pointer */
+        value++;
+
+        node = bfdev_cache_shard_get(tdata->shard, (void *)value);
+        if (!node)
+            continue;
+
+        if (node->status == BFDEV_CACHE_PENDING) {
+            node->data = (void *)value;
+            BFDEV_BUG_ON(bfdev_cache_shard_commit(tdata->shard, node));
+        }
+
+        BFDEV_BUG_ON(node->data != (void *)value);
+        bfdev_cache_shard_put(tdata->shard, node);
+    }
+
+    return NULL;
+}
+
+static uint64_t
+current_nsec(void)
+{
+    struct timespec ts;
+
+    BFDEV_BUG_ON(clock_gettime(CLOCK_MONOTONIC, &ts));
+
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int
+cache_bench(const char *name, unsigned long shards, unsigned int threads)
+{
+    struct test_thread tdata[TEST_THREADS];
+    bfdev_cache_shard_t *shard;
+    bfdev_cache_stats_t stats;
+    unsigned int count;
+    uint64_t start, time;
+
+    shard = bfdev_cache_shard_create(name, NULL, &cache_ops, shards,
+                                     TEST_SIZE, TEST_SIZE, NULL);
+    if (!shard)
+        return 1;
+
+    start = current_nsec();
+    for (count = 0; count < threads; ++count) {
+        tdata[count].shard = shard;
+        tdata[count].seed = count * 2654435761UL + 1;
+        pthread_create(&tdata[count].thread, NULL, cache_worker, &tdata[count]);
+    }
+
+    for (count = 0; count < threads; ++count)
+        pthread_join(tdata[count].thread, NULL);
+    time = current_nsec() - start;
+
+    bfdev_cache_shard_stats(shard, &stats);
+    bfdev_log_debug("\t%s shards %2lu threads %2u: %.2f Mops/s, "
+                    "hits %lu misses %lu starve %lu\n",
+                    name, shards, threads,
+                    (double)TEST_LOOP * threads * 1000 / time,
+                    stats.hits, stats.misses, stats.starve);
+
+    bfdev_cache_shard_destroy(shard);
+
+    return 0;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    const char *algos[] = {"lru", "lfu", "lfuo1", "clock", "clockpro", "arc", "tinylfu"};
+    unsigned int index, threads;
+    int retval;
+
+    for (index = 0; index < BFDEV_ARRAY_SIZE(algos); ++index) {
+        bfdev_log_info("Benchmark %s:\n", algos[index]);
+        for (threads = 1; threads <= TEST_THREADS; threads <<= 1) {
+            retval = cache_bench(algos[index], 1, threads);
+            if (retval)
+                return retval;
+
+            retval = cache_bench(algos[index], TEST_SHARDS, threads);
+            if (retval)
+                return retval;
+        }
+    }
+
+    bfdev_log_info("Done.\n");
+
+    return 0;
+}
@@ -96,5 +96,25 @@ main(int argc, const char *argv[])
     if (retval)
         return retval;
 
+    retval = cache_test("lfuo1");
+    if (retval)
+        return retval;
+
+    retval = cache_test("clock");
+    if (retval)
+        return retval;
+
+    retval = cache_test("clockpro");
+    if (retval)
+        return retval;
+
+    retval = cache_test("arc");
+    if (retval)
+        return retval;
+
+    retval = cache_test("tinylfu");
+    if (retval)
+        return retval;
+
     return 0;
 }
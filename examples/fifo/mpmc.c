@@ -0,0 +1,214 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "fifo-mpmc"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <sched.h>
+#include <pthread.h>
+#include <bfdev/log.h>
+#include <bfdev/fifo.h>
+#include <bfdev/fifo-mpmc.h>
+#include <bfdev/atomic.h>
+#include <bfdev/minmax.h>
+#include <bfdev/macro.h>
+#include "../time.h"
+
+#define TEST_SIZE 4096
+#define TEST_LOOP (1UL << 18)
+#define TEST_BATCH 16
+#define TEST_THREADS 64
+
+struct test_bench {
+    unsigned long batch;
+    unsigned long producers;
+    bool locked;
+};
+
+struct test_worker {
+    struct test_bench *bench;
+    unsigned long start;
+    unsigned long count;
+};
+
+static bfdev_fifo_mpmc_t mpmc;
+static BFDEV_DEFINE_FIFO(fifo, unsigned long, TEST_SIZE);
+static pthread_mutex_t fifo_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static bfdev_atomic_t consumed;
+static bfdev_atomic_t checksum;
+
+static unsigned long
+test_in(struct test_bench *bench, const unsigned long *buff, unsigned long len)
+{
+    unsigned long retval;
+
+    if (!bench->locked)
+        return bfdev_fifo_mpmc_in(&mpmc, buff, len);
+
+    pthread_mutex_lock(&fifo_lock);
+    retval = bfdev_fifo_in(&fifo, buff, len);
+    pthread_mutex_unlock(&fifo_lock);
+
+    return retval;
+}
+
+static unsigned long
+test_out(struct test_bench *bench, unsigned long *buff, unsigned long len)
+{
+    unsigned long retval;
+
+    if (!bench->locked)
+        return bfdev_fifo_mpmc_out(&mpmc, buff, len);
+
+    pthread_mutex_lock(&fifo_lock);
+    retval = bfdev_fifo_out(&fifo, buff, len);
+    pthread_mutex_unlock(&fifo_lock);
+
+    return retval;
+}
+
+static void *
+test_producer(void *pdata)
+{
+    struct test_worker *worker;
+    struct test_bench *bench;
+    unsigned long buff[TEST_BATCH];
+    unsigned long count, index, len, done, batch;
+
+    worker = pdata;
+    bench = worker->bench;
+
+    for (count = 0; count < worker->count; count += batch) {
+        batch = bfdev_min(bench->batch, worker->count - count);
+        for (index = 0; index < batch; ++index)
+            buff[index] = worker->start + count + index;
+
+        for (done = 0; done < batch; done += len) {
+            len = test_in(bench, buff + done, batch - done);
+            if (!len)
+                sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void *
+test_consumer(void *pdata)
+{
+    struct test_worker *worker;
+    unsigned long buff[TEST_BATCH];
+    unsigned long index, len, sum;
+
+    worker = pdata;
+    sum = 0;
+
+    while ((unsigned long)bfdev_atomic_read(&consumed) < TEST_LOOP) {
+        len = test_out(worker->bench, buff, worker->bench->batch);
+        if (!len) {
+            sched_yield();
+            continue;
+        }
+
+        for (index = 0; index < len; ++index)
+            sum += buff[index];
+        bfdev_atomic_add(&consumed, len);
+    }
+
+    bfdev_atomic_add(&checksum, sum);
+
+    return NULL;
+}
+
+static int
+test_spawn(struct test_bench *bench)
+{
+    struct test_worker workers[TEST_THREADS];
+    pthread_t threads[TEST_THREADS];
+    unsigned long count, threadn, share;
+
+    threadn = bench->producers * 2;
+    share = TEST_LOOP / bench->producers;
+
+    for (count = 0; count < threadn; ++count) {
+        workers[count].bench = bench;
+        if (count < bench->producers) {
+            workers[count].start = count * share;
+            workers[count].count = share;
+            pthread_create(&threads[count], NULL, test_producer,
+                           &workers[count]);
+        } else
+            pthread_create(&threads[count], NULL, test_consumer,
+                           &workers[count]);
+    }
+
+    for (count = 0; count < threadn; ++count)
+        pthread_join(threads[count], NULL);
+
+    /* Every element must be delivered exactly once */
+    if ((unsigned long)bfdev_atomic_read(&checksum) !=
+        TEST_LOOP * (TEST_LOOP - 1) / 2)
+        return 1;
+
+    return 0;
+}
+
+static int
+test_run(struct test_bench *bench)
+{
+    int retval;
+
+    bfdev_log_info("%s threads %lu batch %lu:\n", bench->locked ?
+                   "locked fifo" : "mpmc fifo", bench->producers * 2,
+                   bench->batch);
+
+    bfdev_atomic_write(&consumed, 0);
+    bfdev_atomic_write(&checksum, 0);
+
+    retval = EXAMPLE_TIME_STATISTICAL(
+        retval = test_spawn(bench);
+        retval;
+    );
+
+    return retval;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    static const unsigned long batches[] = {1, TEST_BATCH};
+    struct test_bench bench;
+    unsigned int index;
+    int retval;
+
+    retval = bfdev_fifo_mpmc_alloc(&mpmc, NULL, sizeof(unsigned long),
+                                   TEST_SIZE);
+    if (retval)
+        return retval;
+
+    /* Equal numbers of producers and consumers, 2 to 64 threads in total */
+    for (bench.producers = 1; bench.producers <= TEST_THREADS / 2;
+         bench.producers *= 2) {
+        for (index = 0; index < BFDEV_ARRAY_SIZE(batches); ++index) {
+            bench.batch = batches[index];
+
+            bench.locked = true;
+            bfdev_fifo_reset(&fifo);
+            if ((retval = test_run(&bench)))
+                goto finish;
+
+            bench.locked = false;
+            if ((retval = test_run(&bench)))
+                goto finish;
+        }
+    }
+
+finish:
+    bfdev_fifo_mpmc_free(&mpmc);
+
+    return retval;
+}
@@ -0,0 +1,155 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "fifo-spsc"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <sched.h>
+#include <pthread.h>
+#include <bfdev/log.h>
+#include <bfdev/fifo.h>
+#include <bfdev/fifo-spsc.h>
+#include <bfdev/spinlock.h>
+#include <bfdev/macro.h>
+#include "../time.h"
+
+#define TEST_SIZE 4096
+#define TEST_LOOP (1UL << 20)
+#define TEST_BATCH 256
+
+struct test_bench {
+    unsigned long batch;
+    bool locked;
+};
+
+static bfdev_fifo_spsc_t spsc;
+static BFDEV_DEFINE_FIFO(fifo, unsigned long, TEST_SIZE);
+static BFDEV_DEFINE_SPINLOCK(fifo_lock);
+
+static unsigned long
+test_in(struct test_bench *bench, const unsigned long *buff, unsigned long len)
+{
+    unsigned long retval;
+
+    if (!bench->locked)
+        return bfdev_fifo_spsc_in(&spsc, buff, len);
+
+    bfdev_spin_lock(&fifo_lock);
+    retval = bfdev_fifo_in(&fifo, buff, len);
+    bfdev_spin_unlock(&fifo_lock);
+
+    return retval;
+}
+
+static unsigned long
+test_out(struct test_bench *bench, unsigned long *buff, unsigned long len)
+{
+    unsigned long retval;
+
+    if (!bench->locked)
+        return bfdev_fifo_spsc_out(&spsc, buff, len);
+
+    bfdev_spin_lock(&fifo_lock);
+    retval = bfdev_fifo_out(&fifo, buff, len);
+    bfdev_spin_unlock(&fifo_lock);
+
+    return retval;
+}
+
+static void *
+test_producer(void *pdata)
+{
+    struct test_bench *bench;
+    unsigned long buff[TEST_BATCH];
+    unsigned long count, index, len, done;
+
+    bench = pdata;
+    for (count = 0; count < TEST_LOOP; count += bench->batch) {
+        for (index = 0; index < bench->batch; ++index)
+            buff[index] = count + index;
+
+        for (done = 0; done < bench->batch; done += len) {
+            len = test_in(bench, buff + done, bench->batch - done);
+            if (!len)
+                sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static int
+test_consumer(struct test_bench *bench)
+{
+    unsigned long buff[TEST_BATCH];
+    unsigned long count, index, len;
+
+    for (count = 0; count < TEST_LOOP; count += len) {
+        len = test_out(bench, buff, bench->batch);
+        if (!len) {
+            sched_yield();
+            continue;
+        }
+
+        /* Elements must arrive complete and in order */
+        for (index = 0; index < len; ++index) {
+            if (buff[index] != count + index)
+                return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+test_run(struct test_bench *bench)
+{
+    pthread_t thread;
+    int retval;
+
+    bfdev_log_info("%s batch %lu:\n", bench->locked ?
+                   "locked fifo" : "spsc fifo", bench->batch);
+
+    retval = EXAMPLE_TIME_STATISTICAL(
+        pthread_create(&thread, NULL, test_producer, bench);
+        retval = test_consumer(bench);
+        pthread_join(thread, NULL);
+        retval;
+    );
+
+    return retval;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    static const unsigned long batches[] = {1, 16, TEST_BATCH};
+    struct test_bench bench;
+    unsigned int index;
+    int retval;
+
+    retval = bfdev_fifo_spsc_alloc(&spsc, NULL, sizeof(unsigned long),
+                                   TEST_SIZE);
+    if (retval)
+        return retval;
+
+    for (index = 0; index < BFDEV_ARRAY_SIZE(batches); ++index) {
+        bench.batch = batches[index];
+
+        bench.locked = true;
+        bfdev_fifo_reset(&fifo);
+        if ((retval = test_run(&bench)))
+            break;
+
+        bench.locked = false;
+        if ((retval = test_run(&bench)))
+            break;
+    }
+
+    bfdev_fifo_spsc_free(&spsc);
+
+    return retval;
+}
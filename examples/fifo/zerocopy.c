@@ -0,0 +1,153 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "fifo-zerocopy"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <bfdev/log.h>
+#include <bfdev/fifo.h>
+#include <bfdev/span.h>
+#include "../time.h"
+
+#ifdef BFDEV_HAVE_UIO
+#include <sys/socket.h>
+
+#define TEST_SIZE 65536
+#define TEST_CHUNK 32768
+#define TEST_LOOP (1UL << 26)
+
+static BFDEV_DEFINE_FIFO(txfifo, uint8_t, TEST_SIZE);
+static BFDEV_DEFINE_FIFO(rxfifo, uint8_t, TEST_SIZE);
+static uint8_t bounce[TEST_CHUNK];
+
+static void
+test_generate(uint8_t *buff, size_t len, unsigned long offset)
+{
+    while (len--)
+        *buff++ = (uint8_t)offset++;
+}
+
+static int
+test_verify(const uint8_t *buff, size_t len, unsigned long offset)
+{
+    while (len--) {
+        if (*buff++ != (uint8_t)offset++)
+            return 1;
+    }
+
+    return 0;
+}
+
+static int
+test_zerocopy(int *sock)
+{
+    bfdev_span_t span[2];
+    struct iovec iov[2];
+    unsigned long produced, count, index, len;
+    ssize_t retval;
+
+    produced = 0;
+    for (count = 0; count < TEST_LOOP; count += len) {
+        /* Produce straight into the transmit ring */
+        len = bfdev_fifo_reserve(&txfifo, span, TEST_CHUNK);
+        test_generate(span[0].base, span[0].len, produced);
+        test_generate(span[1].base, span[1].len, produced + span[0].len);
+        produced += bfdev_fifo_commit(&txfifo, len);
+
+        len = bfdev_fifo_peek_span(&txfifo, span, TEST_CHUNK);
+        retval = writev(sock[0], iov, bfdev_span_iovec(iov, span));
+        if (retval < 0)
+            return 1;
+        bfdev_fifo_consume(&txfifo, retval);
+
+        /* Receive straight into the receive ring */
+        bfdev_fifo_reserve(&rxfifo, span, retval);
+        retval = readv(sock[1], iov, bfdev_span_iovec(iov, span));
+        if (retval <= 0)
+            return 1;
+        bfdev_fifo_commit(&rxfifo, retval);
+
+        len = bfdev_fifo_peek_span(&rxfifo, span, TEST_CHUNK);
+        for (index = 0; index < 2; ++index) {
+            if (test_verify(span[index].base, span[index].len,
+                            count + (index ? span[0].len : 0)))
+                return 1;
+        }
+        bfdev_fifo_consume(&rxfifo, len);
+    }
+
+    return 0;
+}
+
+static int
+test_copy(int *sock)
+{
+    unsigned long produced, count, len;
+    ssize_t retval;
+
+    produced = 0;
+    for (count = 0; count < TEST_LOOP; count += len) {
+        test_generate(bounce, TEST_CHUNK, produced);
+        produced += bfdev_fifo_in(&txfifo, bounce, TEST_CHUNK);
+
+        len = bfdev_fifo_out(&txfifo, bounce, TEST_CHUNK);
+        retval = write(sock[0], bounce, len);
+        if (retval != (ssize_t)len)
+            return 1;
+
+        retval = read(sock[1], bounce, len);
+        if (retval <= 0)
+            return 1;
+        bfdev_fifo_in(&rxfifo, bounce, retval);
+
+        len = bfdev_fifo_out(&rxfifo, bounce, TEST_CHUNK);
+        if (test_verify(bounce, len, count))
+            return 1;
+    }
+
+    return 0;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    int sock[2], retval;
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sock))
+        return 1;
+
+    bfdev_log_info("copy through bounce buffer:\n");
+    retval = EXAMPLE_TIME_STATISTICAL(
+        test_copy(sock);
+    );
+    if (retval)
+        goto finish;
+
+    bfdev_fifo_reset(&txfifo);
+    bfdev_fifo_reset(&rxfifo);
+
+    bfdev_log_info("zero-copy spans with readv/writev:\n");
+    retval = EXAMPLE_TIME_STATISTICAL(
+        test_zerocopy(sock);
+    );
+
+finish:
+    close(sock[0]);
+    close(sock[1]);
+
+    return retval;
+}
+
+#else /* !BFDEV_HAVE_UIO */
+
+int
+main(int argc, const char *argv[])
+{
+    bfdev_log_notice("readv/writev not supported\n");
+    return 0;
+}
+
+#endif /* BFDEV_HAVE_UIO */
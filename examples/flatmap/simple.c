@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <bfdev/flatmap.h>
+
+#define TEST_LOOP 100
+
+struct test_node {
+    unsigned long value;
+};
+
+static inline unsigned long
+flatmap_hash_key(const void *key, void *pdata)
+{
+    return (unsigned long)key;
+}
+
+static inline unsigned long
+flatmap_hash_node(const void *node, void *pdata)
+{
+    const struct test_node *tnode;
+
+    tnode = node;
+
+    return tnode->value;
+}
+
+static inline long
+flatmap_equal(const void *node1, const void *node2, void *pdata)
+{
+    const struct test_node *tnode1, *tnode2;
+
+    tnode1 = node1;
+    tnode2 = node2;
+
+    return tnode1->value - tnode2->value;
+}
+
+static inline long
+flatmap_find(const void *node, const void *key, void *pdata)
+{
+    const struct test_node *tnode;
+
+    tnode = node;
+
+    return tnode->value - (unsigned long)key;
+}
+
+static bfdev_flatmap_ops_t
+test_ops = {
+    .hash_key = flatmap_hash_key,
+    .hash_node = flatmap_hash_node,
+    .equal = flatmap_equal,
+    .find = flatmap_find,
+};
+
+int
+main(int argc, const char *argv[])
+{
+    struct test_node *nodes, *find;
+    unsigned long value, index;
+    unsigned int count;
+    int retval;
+
+    BFDEV_DEFINE_FLATMAP(test_map, NULL, &test_ops, NULL);
+    nodes = malloc(sizeof(*nodes) * TEST_LOOP);
+    if (!nodes)
+        return 1;
+
+    printf("flatmap 'bfdev_flatmap_add':\n");
+    srand(time(NULL));
+    for (count = 0; count < TEST_LOOP; ++count) {
+        value = ((uint64_t)rand() << 32) | rand();
+        nodes[count].value = value;
+
+        printf("\ttest %02u: value %lu\n", count, value);
+        retval = bfdev_flatmap_add(&test_map, &nodes[count]);
+        if (retval)
+            return retval;
+    }
+
+    printf("flatmap 'bfdev_flatmap_find':\n");
+    for (count = 0; count < TEST_LOOP; ++count) {
+        value = nodes[count].value;
+        find = bfdev_flatmap_find(&test_map, (void *)value);
+        if (!find)
+            return 1;
+
+        printf("\ttest %02u: value %lu\n", count, find->value);
+    }
+
+    printf("flatmap 'bfdev_flatmap_for_each':\n");
+    count = 0;
+    bfdev_flatmap_for_each(find, &test_map, index)
+        printf("\ttest %02u: slot %lu value %lu\n", count++, index, find->value);
+
+    if (count != TEST_LOOP)
+        return 1;
+
+    printf("flatmap 'bfdev_flatmap_del':\n");
+    for (count = 0; count < TEST_LOOP; ++count) {
+        value = nodes[count].value;
+        retval = bfdev_flatmap_del(&test_map, (void *)value, (void **)&find);
+        if (retval)
+            return retval;
+
+        printf("\ttest %02u: value %lu\n", count, find->value);
+    }
+
+    bfdev_flatmap_release(&test_map);
+    free(nodes);
+
+    return 0;
+}
@@ -10,11 +10,13 @@
 #include <stdlib.h>
 #include <bfdev/log.h>
 #include <bfdev/hashmap.h>
+#include <bfdev/flatmap.h>
 #include "../time.h"
 
 #define TEST_LOOP 3
 #define TEST_WARMUP 32
 #define TEST_SIZE 1000000
+#define TEST_BATCH 32
 
 struct test_node {
     bfdev_hlist_node_t node;
@@ -62,6 +64,37 @@ test_find(const bfdev_hlist_node_t *node, const void *key, void *pdata)
     return tnode->value - (unsigned long)key;
 }
 
+static inline unsigned long
+test_flat_hash_node(const void *node, void *pdata)
+{
+    const struct test_node *tnode;
+
+    tnode = node;
+
+    return tnode->value;
+}
+
+static inline long
+test_flat_equal(const void *node1, const void *node2, void *pdata)
+{
+    const struct test_node *tnode1, *tnode2;
+
+    tnode1 = node1;
+    tnode2 = node2;
+
+    return tnode1->value - tnode2->value;
+}
+
+static inline long
+test_flat_find(const void *node, const void *key, void *pdata)
+{
+    const struct test_node *tnode;
+
+    tnode = node;
+
+    return tnode->value - (unsigned long)key;
+}
+
 static bfdev_hashmap_ops_t
 test_ops = {
     .hash_key = test_hash_key,
@@ -70,29 +103,26 @@ test_ops = {
     .find = test_find,
 };
 
-int
-main(int argc, const char *argv[])
+static bfdev_flatmap_ops_t
+test_flat_ops = {
+    .hash_key = test_hash_key,
+    .hash_node = test_flat_hash_node,
+    .equal = test_flat_equal,
+    .find = test_flat_find,
+};
+
+static int
+bench_hashmap(struct test_node *nodes)
 {
-    struct test_node *nodes;
-    bfdev_hlist_node_t *hnode;
+    bfdev_hlist_node_t *hnode, *hnodes[TEST_BATCH];
+    const void *keys[TEST_BATCH];
     unsigned long value;
-    unsigned int count, loop;
-    void *block;
+    unsigned int count, index, loop;
     int retval;
 
     BFDEV_DEFINE_HASHMAP(test_map, NULL, &test_ops, NULL);
-    nodes = block = malloc(sizeof(*nodes) * TEST_SIZE);
-    if (!block) {
-        bfdev_log_err("Insufficient memory!\n");
-        return 1;
-    }
 
-    srand(time(NULL));
-    bfdev_log_info("Generate %u node:\n", TEST_SIZE);
-    for (count = 0; count < TEST_SIZE; ++count)
-        nodes[count].value = count;
-
-    bfdev_log_info("Insert nodes:\n");
+    bfdev_log_info("Hashmap insert nodes:\n");
     EXAMPLE_TIME_STATISTICAL(
         for (count = 0; count < TEST_SIZE; ++count) {
             retval = bfdev_hashmap_add(&test_map, &nodes[count].node);
@@ -113,7 +143,7 @@ main(int argc, const char *argv[])
     }
 
     for (loop = 0; loop < TEST_LOOP; ++loop) {
-        bfdev_log_info("Find nodes loop%u...\n", loop);
+        bfdev_log_info("Hashmap find nodes loop%u...\n", loop);
         EXAMPLE_TIME_STATISTICAL(
             for (count = 0; count < TEST_SIZE; ++count) {
                 value = nodes[count].value;
@@ -125,7 +155,21 @@ main(int argc, const char *argv[])
         );
     }
 
-    bfdev_log_info("Delete nodes:\n");
+    for (loop = 0; loop < TEST_LOOP; ++loop) {
+        bfdev_log_info("Hashmap find batch nodes loop%u...\n", loop);
+        EXAMPLE_TIME_STATISTICAL(
+            for (count = 0; count + TEST_BATCH <= TEST_SIZE; count += TEST_BATCH) {
+                for (index = 0; index < TEST_BATCH; ++index)
+                    keys[index] = (void *)nodes[count + index].value;
+                if (bfdev_hashmap_find_batch(&test_map, keys, hnodes,
+                                             TEST_BATCH) != TEST_BATCH)
+                    return 1;
+            }
+            0;
+        );
+    }
+
+    bfdev_log_info("Hashmap delete nodes:\n");
     EXAMPLE_TIME_STATISTICAL(
         for (count = 0; count < TEST_SIZE; ++count) {
             value = nodes[count].value;
@@ -136,9 +180,100 @@ main(int argc, const char *argv[])
         0;
     );
 
-    bfdev_log_info("Done.\n");
     bfdev_hashmap_release(&test_map);
-    free(nodes);
 
     return 0;
 }
+
+static int
+bench_flatmap(struct test_node *nodes)
+{
+    unsigned long value;
+    unsigned int count, loop;
+    void *fnode;
+    int retval;
+
+    BFDEV_DEFINE_FLATMAP(test_map, NULL, &test_flat_ops, NULL);
+
+    bfdev_log_info("Flatmap insert nodes:\n");
+    EXAMPLE_TIME_STATISTICAL(
+        for (count = 0; count < TEST_SIZE; ++count) {
+            retval = bfdev_flatmap_add(&test_map, &nodes[count]);
+            if (retval)
+                return retval;
+        }
+        0;
+    );
+
+    bfdev_log_notice("Warmup cache...\n");
+    for (loop = 0; loop < TEST_WARMUP; ++loop) {
+        for (count = 0; count < TEST_SIZE; ++count) {
+            value = nodes[count].value;
+            fnode = bfdev_flatmap_find(&test_map, (void *)value);
+            if (!fnode)
+                return 1;
+        }
+    }
+
+    for (loop = 0; loop < TEST_LOOP; ++loop) {
+        bfdev_log_info("Flatmap find nodes loop%u...\n", loop);
+        EXAMPLE_TIME_STATISTICAL(
+            for (count = 0; count < TEST_SIZE; ++count) {
+                value = nodes[count].value;
+                fnode = bfdev_flatmap_find(&test_map, (void *)value);
+                if (!fnode)
+                    return 1;
+            }
+            0;
+        );
+    }
+
+    bfdev_log_info("Flatmap delete nodes:\n");
+    EXAMPLE_TIME_STATISTICAL(
+        for (count = 0; count < TEST_SIZE; ++count) {
+            value = nodes[count].value;
+            retval = bfdev_flatmap_del(&test_map, (void *)value, &fnode);
+            if (retval)
+                return retval;
+        }
+        0;
+    );
+
+    bfdev_flatmap_release(&test_map);
+
+    return 0;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    struct test_node *nodes;
+    unsigned int count;
+    void *block;
+    int retval;
+
+    nodes = block = malloc(sizeof(*nodes) * TEST_SIZE);
+    if (!block) {
+        bfdev_log_err("Insufficient memory!\n");
+        return 1;
+    }
+
+    srand(time(NULL));
+    bfdev_log_info("Generate %u node:\n", TEST_SIZE);
+    for (count = 0; count < TEST_SIZE; ++count)
+        nodes[count].value = count;
+
+    retval = bench_hashmap(nodes);
+    if (retval)
+        goto finish;
+
+    retval = bench_flatmap(nodes);
+    if (retval)
+        goto finish;
+
+    bfdev_log_info("Done.\n");
+
+finish:
+    free(nodes);
+    return retval;
+}
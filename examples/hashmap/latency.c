@@ -0,0 +1,165 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "hashmap-latency"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <bfdev/log.h>
+#include <bfdev/hashmap.h>
+#include <bfdev/sort.h>
+#include <bfdev/bug.h>
+
+#define TEST_SIZE 1000000
+
+struct test_node {
+    bfdev_hlist_node_t node;
+    unsigned long value;
+};
+
+#define node_to_test(ptr) \
+    bfdev_container_of(ptr, struct test_node, node)
+
+static inline unsigned long
+test_hash_key(const void *key, void *pdata)
+{
+    return (unsigned long)key;
+}
+
+static inline unsigned long
+test_hash_node(const bfdev_hlist_node_t *node, void *pdata)
+{
+    struct test_node *tnode;
+
+    tnode = node_to_test(node);
+
+    return tnode->value;
+}
+
+static inline long
+test_equal(const bfdev_hlist_node_t *node1,
+           const bfdev_hlist_node_t *node2, void *pdata)
+{
+    struct test_node *tnode1, *tnode2;
+
+    tnode1 = node_to_test(node1);
+    tnode2 = node_to_test(node2);
+
+    return tnode1->value - tnode2->value;
+}
+
+static inline long
+test_find(const bfdev_hlist_node_t *node, const void *key, void *pdata)
+{
+    struct test_node *tnode;
+
+    tnode = node_to_test(node);
+
+    return tnode->value - (unsigned long)key;
+}
+
+static bfdev_hashmap_ops_t
+test_ops = {
+    .hash_key = test_hash_key,
+    .hash_node = test_hash_node,
+    .equal = test_equal,
+    .find = test_find,
+};
+
+static long
+latency_cmp(const void *a, const void *b, void *pdata)
+{
+    const uint64_t *la, *lb;
+
+    la = a;
+    lb = b;
+
+    if (*la == *lb)
+        return 0;
+
+    return bfdev_cmp(*la > *lb);
+}
+
+static uint64_t
+current_nsec(void)
+{
+    struct timespec ts;
+
+    BFDEV_BUG_ON(clock_gettime(CLOCK_MONOTONIC, &ts));
+
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int
+test_latency(struct test_node *nodes, uint64_t *latency, bool incremental)
+{
+    unsigned int count;
+    uint64_t start;
+    int retval;
+
+    BFDEV_DEFINE_HASHMAP(test_map, NULL, &test_ops, NULL);
+    if (incremental)
+        bfdev_hashmap_incremental_set(&test_map);
+
+    for (count = 0; count < TEST_SIZE; ++count) {
+        start = current_nsec();
+        retval = bfdev_hashmap_add(&test_map, &nodes[count].node);
+        latency[count] = current_nsec() - start;
+        if (retval)
+            return retval;
+    }
+
+    for (count = 0; count < TEST_SIZE; ++count) {
+        if (!bfdev_hashmap_find(&test_map, (void *)nodes[count].value))
+            return 1;
+    }
+
+    bfdev_sort(latency, TEST_SIZE, sizeof(*latency), latency_cmp, NULL);
+    bfdev_log_info("%s insert latency:\n", incremental ? "Incremental" : "Burst");
+    bfdev_log_debug("\tp50: %luns\n", (unsigned long)latency[TEST_SIZE / 2]);
+    bfdev_log_debug("\tp99: %luns\n", (unsigned long)latency[TEST_SIZE / 100 * 99]);
+    bfdev_log_debug("\tp99.99: %luns\n", (unsigned long)latency[TEST_SIZE / 10000 * 9999]);
+    bfdev_log_debug("\tmax: %luns\n", (unsigned long)latency[TEST_SIZE - 1]);
+
+    bfdev_hashmap_release(&test_map);
+
+    return 0;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    struct test_node *nodes;
+    uint64_t *latency;
+    unsigned int count;
+    int retval;
+
+    nodes = malloc(sizeof(*nodes) * TEST_SIZE);
+    latency = malloc(sizeof(*latency) * TEST_SIZE);
+    if (!nodes || !latency) {
+        bfdev_log_err("Insufficient memory!\n");
+        return 1;
+    }
+
+    for (count = 0; count < TEST_SIZE; ++count)
+        nodes[count].value = count;
+
+    retval = test_latency(nodes, latency, false);
+    if (retval)
+        goto finish;
+
+    retval = test_latency(nodes, latency, true);
+    if (retval)
+        goto finish;
+
+    bfdev_log_info("Done.\n");
+
+finish:
+    free(latency);
+    free(nodes);
+    return retval;
+}
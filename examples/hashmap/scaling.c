@@ -0,0 +1,314 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "hashmap-scaling"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <bfdev/log.h>
+#include <bfdev/hashmap.h>
+#include <bfdev/shardmap.h>
+#include <bfdev/bug.h>
+
+#define TEST_BITS 16
+#define TEST_KEYS (1UL << TEST_BITS)
+#define TEST_LOOP (1UL << 17)
+#define TEST_THREADS 16
+#define TEST_WRITE 10
+#define TEST_PENDING 64
+
+enum test_state {
+    TEST_FREE = 0,
+    TEST_INSERTED,
+    TEST_PENDING_FREE,
+};
+
+struct test_node {
+    bfdev_hlist_node_t node;
+    unsigned long value;
+    enum test_state state;
+};
+
+struct test_thread {
+    pthread_t thread;
+    unsigned int index;
+    unsigned int threads;
+    unsigned long hits;
+};
+
+#define node_to_test(ptr) \
+    bfdev_container_of(ptr, struct test_node, node)
+
+static struct test_node *test_nodes;
+static bfdev_shardmap_t test_shard;
+static bfdev_hashmap_t test_map;
+static pthread_rwlock_t test_lock;
+
+static inline unsigned long
+test_hash_key(const void *key, void *pdata)
+{
+    return (unsigned long)key;
+}
+
+static inline unsigned long
+test_hash_node(const bfdev_hlist_node_t *node, void *pdata)
+{
+    struct test_node *tnode;
+
+    tnode = node_to_test(node);
+
+    return tnode->value;
+}
+
+static inline long
+test_equal(const bfdev_hlist_node_t *node1,
+           const bfdev_hlist_node_t *node2, void *pdata)
+{
+    struct test_node *tnode1, *tnode2;
+
+    tnode1 = node_to_test(node1);
+    tnode2 = node_to_test(node2);
+
+    return tnode1->value - tnode2->value;
+}
+
+static inline long
+test_find(const bfdev_hlist_node_t *node, const void *key, void *pdata)
+{
+    struct test_node *tnode;
+
+    tnode = node_to_test(node);
+
+    return tnode->value - (unsigned long)key;
+}
+
+static bfdev_hashmap_ops_t
+test_ops = {
+    .hash_key = test_hash_key,
+    .hash_node = test_hash_node,
+    .equal = test_equal,
+    .find = test_find,
+};
+
+static inline unsigned long
+test_random(unsigned long *seed)
+{
+    unsigned long value;
+
+    /* xorshift, cheap enough not to dominate the loop */
+    value = *seed;
+    value ^= value << 13;
+    value ^= value >> 7;
+    value ^= value << 17;
+    *seed = value;
+
+    return value;
+}
+
+static inline unsigned long
+test_own_key(struct test_thread *tdata, unsigned long random)
+{
+    unsigned long range;
+
+    /* Each thread only writes its own keys, so node states are private */
+    range = TEST_KEYS / tdata->threads;
+
+    return tdata->index + (random % range) * tdata->threads;
+}
+
+static void *
+shardmap_worker(void *data)
+{
+    struct test_node *pending[TEST_PENDING];
+    struct test_thread *tdata;
+    bfdev_epoch_reader_t reader;
+    struct test_node *node;
+    unsigned long count, random, seed;
+    unsigned int npending, index;
+
+    tdata = data;
+    seed = tdata->index * 2654435761UL + 1;
+    npending = 0;
+
+    bfdev_shardmap_reader_register(&test_shard, &reader);
+    for (count = 0; count < TEST_LOOP; ++count) {
+        random = test_random(&seed);
+
+        if (random % 100 >= TEST_WRITE) {
+            bfdev_shardmap_read_lock(&test_shard, &reader);
+            if (bfdev_shardmap_find(&test_shard, (void *)((random >> 8) % TEST_KEYS)))
+                tdata->hits++;
+            bfdev_shardmap_read_unlock(&test_shard, &reader);
+            continue;
+        }
+
+        node = &test_nodes[test_own_key(tdata, random >> 8)];
+        switch (node->state) {
+            case TEST_INSERTED:
+                BFDEV_BUG_ON(bfdev_shardmap_del(&test_shard,
+                             (void *)node->value, NULL));
+                node->state = TEST_PENDING_FREE;
+                pending[npending++] = node;
+
+                /* Wait a grace period before nodes are reused */
+                if (npending == TEST_PENDING) {
+                    bfdev_shardmap_synchronize(&test_shard);
+                    for (index = 0; index < npending; ++index)
+                        pending[index]->state = TEST_FREE;
+                    npending = 0;
+                }
+                break;
+
+            case TEST_FREE:
+                BFDEV_BUG_ON(bfdev_shardmap_add(&test_shard, &node->node));
+                node->state = TEST_INSERTED;
+                break;
+
+            default:
+                break;
+        }
+    }
+    bfdev_shardmap_reader_unregister(&test_shard, &reader);
+
+    return NULL;
+}
+
+static void *
+hashmap_worker(void *data)
+{
+    struct test_thread *tdata;
+    struct test_node *node;
+    unsigned long count, random, seed;
+
+    tdata = data;
+    seed = tdata->index * 2654435761UL + 1;
+
+    for (count = 0; count < TEST_LOOP; ++count) {
+        random = test_random(&seed);
+
+        if (random % 100 >= TEST_WRITE) {
+            pthread_rwlock_rdlock(&test_lock);
+            if (bfdev_hashmap_find(&test_map, (void *)((random >> 8) % TEST_KEYS)))
+                tdata->hits++;
+            pthread_rwlock_unlock(&test_lock);
+            continue;
+        }
+
+        node = &test_nodes[test_own_key(tdata, random >> 8)];
+        pthread_rwlock_wrlock(&test_lock);
+        if (node->state == TEST_INSERTED) {
+            BFDEV_BUG_ON(bfdev_hashmap_del(&test_map, (void *)node->value, NULL));
+            node->state = TEST_FREE;
+        } else {
+            BFDEV_BUG_ON(bfdev_hashmap_add(&test_map, &node->node));
+            node->state = TEST_INSERTED;
+        }
+        pthread_rwlock_unlock(&test_lock);
+    }
+
+    return NULL;
+}
+
+static uint64_t
+current_nsec(void)
+{
+    struct timespec ts;
+
+    BFDEV_BUG_ON(clock_gettime(CLOCK_MONOTONIC, &ts));
+
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static double
+test_run(void *(*worker)(void *), unsigned int threads)
+{
+    struct test_thread tdata[TEST_THREADS];
+    unsigned int count;
+    uint64_t start;
+
+    for (count = 0; count < threads; ++count) {
+        tdata[count].index = count;
+        tdata[count].threads = threads;
+        tdata[count].hits = 0;
+    }
+
+    start = current_nsec();
+    for (count = 0; count < threads; ++count)
+        pthread_create(&tdata[count].thread, NULL, worker, &tdata[count]);
+    for (count = 0; count < threads; ++count)
+        pthread_join(tdata[count].thread, NULL);
+
+    return (double)TEST_LOOP * threads * 1000 / (current_nsec() - start);
+}
+
+static int
+test_prepare(bool shard)
+{
+    unsigned long count;
+    int retval;
+
+    for (count = 0; count < TEST_KEYS; ++count) {
+        test_nodes[count].value = count;
+        test_nodes[count].state = TEST_INSERTED;
+
+        if (shard)
+            retval = bfdev_shardmap_add(&test_shard, &test_nodes[count].node);
+        else
+            retval = bfdev_hashmap_add(&test_map, &test_nodes[count].node);
+
+        if (retval)
+            return retval;
+    }
+
+    return 0;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    unsigned int threads;
+    double shard, rwlock;
+    int retval;
+
+    test_nodes = malloc(sizeof(*test_nodes) * TEST_KEYS);
+    if (!test_nodes) {
+        bfdev_log_err("Insufficient memory!\n");
+        return 1;
+    }
+
+    pthread_rwlock_init(&test_lock, NULL);
+    bfdev_log_info("Read %d%%, write %d%%, Mops/s:\n",
+                   100 - TEST_WRITE, TEST_WRITE);
+
+    for (threads = 1; threads <= TEST_THREADS; threads <<= 1) {
+        retval = bfdev_shardmap_init(&test_shard, NULL, &test_ops,
+                                     TEST_BITS, BFDEV_SHARDMAP_STRIPE_BITS, NULL);
+        if (retval || (retval = test_prepare(true)))
+            goto finish;
+
+        shard = test_run(shardmap_worker, threads);
+        bfdev_shardmap_release(&test_shard);
+
+        bfdev_hashmap_init(&test_map, NULL, &test_ops, NULL);
+        if ((retval = test_prepare(false)))
+            goto finish;
+
+        rwlock = test_run(hashmap_worker, threads);
+        bfdev_hashmap_release(&test_map);
+
+        bfdev_log_debug("\tthreads %2u: shardmap %.2f rwlock-hashmap %.2f\n",
+                        threads, shard, rwlock);
+    }
+
+    bfdev_log_info("Done.\n");
+
+finish:
+    pthread_rwlock_destroy(&test_lock);
+    free(test_nodes);
+    return retval;
+}
@@ -0,0 +1,141 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "hashmap-string"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <bfdev/log.h>
+#include <bfdev/hashmap.h>
+#include <bfdev/stringhash.h>
+#include "../time.h"
+
+#define TEST_SIZE 500000
+#define TEST_KEYLEN 48
+
+struct test_node {
+    bfdev_hashmap_node_t node;
+    char key[TEST_KEYLEN];
+};
+
+#define node_to_test(ptr) \
+    bfdev_container_of(ptr, struct test_node, node.node)
+
+static inline unsigned long
+test_hash_key(const void *key, void *pdata)
+{
+    return bfdev_pjwhash(key);
+}
+
+static inline unsigned long
+test_hash_node(const bfdev_hlist_node_t *node, void *pdata)
+{
+    struct test_node *tnode;
+
+    tnode = node_to_test(node);
+
+    return bfdev_pjwhash(tnode->key);
+}
+
+static inline long
+test_equal(const bfdev_hlist_node_t *node1,
+           const bfdev_hlist_node_t *node2, void *pdata)
+{
+    struct test_node *tnode1, *tnode2;
+
+    tnode1 = node_to_test(node1);
+    tnode2 = node_to_test(node2);
+
+    return strcmp(tnode1->key, tnode2->key);
+}
+
+static inline long
+test_find(const bfdev_hlist_node_t *node, const void *key, void *pdata)
+{
+    struct test_node *tnode;
+
+    tnode = node_to_test(node);
+
+    return strcmp(tnode->key, key);
+}
+
+static bfdev_hashmap_ops_t
+test_ops = {
+    .hash_key = test_hash_key,
+    .hash_node = test_hash_node,
+    .equal = test_equal,
+    .find = test_find,
+};
+
+static int
+bench_string(struct test_node *nodes, unsigned long flags)
+{
+    bfdev_hlist_node_t *hnode;
+    unsigned int count;
+    int retval;
+
+    BFDEV_DEFINE_HASHMAP(test_map, NULL, &test_ops, NULL);
+    test_map.flags = flags;
+
+    bfdev_log_info("%s insert nodes:\n", flags ? "Cached" : "Plain");
+    EXAMPLE_TIME_STATISTICAL(
+        for (count = 0; count < TEST_SIZE; ++count) {
+            retval = bfdev_hashmap_add(&test_map, &nodes[count].node.node);
+            if (retval)
+                return retval;
+        }
+        0;
+    );
+
+    bfdev_log_info("%s find nodes:\n", flags ? "Cached" : "Plain");
+    EXAMPLE_TIME_STATISTICAL(
+        for (count = 0; count < TEST_SIZE; ++count) {
+            hnode = bfdev_hashmap_find(&test_map, nodes[count].key);
+            if (!hnode)
+                return 1;
+        }
+        0;
+    );
+
+    bfdev_hashmap_release(&test_map);
+
+    return 0;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    struct test_node *nodes;
+    unsigned int count;
+    int retval;
+
+    nodes = malloc(sizeof(*nodes) * TEST_SIZE);
+    if (!nodes) {
+        bfdev_log_err("Insufficient memory!\n");
+        return 1;
+    }
+
+    /* Long common prefix makes each comparison expensive */
+    for (count = 0; count < TEST_SIZE; ++count) {
+        snprintf(nodes[count].key, TEST_KEYLEN,
+                 "bfdev-hashmap-string-benchmark-%08x", count);
+    }
+
+    retval = bench_string(nodes, 0);
+    if (retval)
+        goto finish;
+
+    retval = bench_string(nodes, BFDEV_HASHMAP_CACHED);
+    if (retval)
+        goto finish;
+
+    bfdev_log_info("Done.\n");
+
+finish:
+    free(nodes);
+    return retval;
+}
@@ -0,0 +1,130 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "hugealloc-bench"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <bfdev/log.h>
+#include <bfdev/hugealloc.h>
+#include <bfdev/bloom.h>
+#include <bfdev/hash.h>
+#include "../time.h"
+
+#define TABLE_SIZE (1UL << 23)
+#define BLOOM_SIZE (1U << 29)
+#define BLOOM_KEYS (1UL << 20)
+#define TEST_LOOP (1UL << 23)
+
+static inline unsigned long
+test_random(unsigned long *seed)
+{
+    unsigned long value;
+
+    value = *seed;
+    value ^= value << 13;
+    value ^= value >> 7;
+    value ^= value << 17;
+    *seed = value;
+
+    return value;
+}
+
+static unsigned int
+bloom_hash(unsigned int func, const void *key, void *pdata)
+{
+    return bfdev_hashl((uintptr_t)key * (func + 1), 32);
+}
+
+static int
+bench_table(const bfdev_alloc_t *alloc)
+{
+    unsigned long *table, count, seed, sum;
+
+    table = bfdev_malloc(alloc, TABLE_SIZE * sizeof(*table));
+    if (!table)
+        return 1;
+
+    for (count = 0; count < TABLE_SIZE; ++count)
+        table[count] = count;
+
+    /* Random lookups, one tlb entry each on small pages */
+    seed = 0x2545f4914f6cdd1dUL;
+    sum = EXAMPLE_TIME_STATISTICAL(
+        sum = 0;
+        for (count = 0; count < TEST_LOOP; ++count)
+            sum += table[test_random(&seed) % TABLE_SIZE];
+        sum;
+    );
+
+    bfdev_log_debug("\tchecksum %lx\n", sum);
+    bfdev_free(alloc, table);
+
+    return 0;
+}
+
+static int
+bench_bloom(const bfdev_alloc_t *alloc)
+{
+    bfdev_bloom_t *bloom;
+    unsigned long count, seed, hits;
+
+    bloom = bfdev_bloom_create(alloc, BLOOM_SIZE, bloom_hash, 3, NULL);
+    if (!bloom)
+        return 1;
+
+    seed = 0x2545f4914f6cdd1dUL;
+    for (count = 0; count < BLOOM_KEYS; ++count)
+        bfdev_bloom_push(bloom, (void *)test_random(&seed));
+
+    seed = 0x9e3779b97f4a7c15UL;
+    hits = EXAMPLE_TIME_STATISTICAL(
+        hits = 0;
+        for (count = 0; count < TEST_LOOP; ++count)
+            hits += bfdev_bloom_peek(bloom, (void *)test_random(&seed));
+        hits;
+    );
+
+    bfdev_log_debug("\tfalse positives %lu\n", hits);
+    bfdev_bloom_destroy(bloom);
+
+    return 0;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    bfdev_hugealloc_t huge;
+    const bfdev_alloc_t *alloc;
+    int retval;
+
+    retval = bfdev_hugealloc_init(&huge, NULL, 0, BFDEV_HUGEALLOC_HUGETLB |
+                                  BFDEV_HUGEALLOC_THP);
+    if (retval)
+        return retval;
+    alloc = bfdev_hugealloc_allocator(&huge);
+
+    bfdev_log_info("table lookup, default allocator:\n");
+    if ((retval = bench_table(NULL)))
+        return retval;
+
+    bfdev_log_info("table lookup, huge page allocator:\n");
+    if ((retval = bench_table(alloc)))
+        return retval;
+
+    bfdev_log_info("bloom peek, default allocator:\n");
+    if ((retval = bench_bloom(NULL)))
+        return retval;
+
+    bfdev_log_info("bloom peek, huge page allocator:\n");
+    if ((retval = bench_bloom(alloc)))
+        return retval;
+
+    bfdev_log_info("huge page blocks: %ld reserved, %ld hinted\n",
+                   (long)huge.hugetlb, (long)huge.mapped);
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "memalloc-bench"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <bfdev/log.h>
+#include <bfdev/memalloc.h>
+#include <bfdev/macro.h>
+#include <bfdev/size.h>
+#include "../time.h"
+
+#define POOL_SIZE BFDEV_SZ_64MiB
+#define TEST_SLOTS 8192
+#define TEST_LOOP (1UL << 17)
+
+struct test_algo {
+    const char *name;
+    bfdev_memalloc_find_t find;
+};
+
+static const struct test_algo
+test_algos[] = {
+    { "first-fit", bfdev_memalloc_first_fit },
+    { "best-fit", bfdev_memalloc_best_fit },
+    { "worst-fit", bfdev_memalloc_worst_fit },
+    { "tlsf", bfdev_memalloc_tlsf },
+};
+
+static inline unsigned long
+test_random(unsigned long *seed)
+{
+    unsigned long value;
+
+    value = *seed;
+    value ^= value << 13;
+    value ^= value >> 7;
+    value ^= value << 17;
+    *seed = value;
+
+    return value;
+}
+
+static size_t
+test_size(unsigned long value)
+{
+    /* Mostly small objects, now and then a large buffer */
+    if (value % 4)
+        return (value >> 8) % 240 + 16;
+
+    return (value >> 8) % 16128 + 256;
+}
+
+static int
+test_workload(bfdev_memalloc_head_t *head, void **slots)
+{
+    unsigned long count, value, seed, failed;
+    unsigned int index;
+
+    seed = 0x2545f4914f6cdd1dUL;
+    failed = 0;
+
+    for (count = 0; count < TEST_LOOP; ++count) {
+        value = test_random(&seed);
+        index = value % TEST_SLOTS;
+
+        if (slots[index]) {
+            bfdev_memalloc_free(head, slots[index]);
+            slots[index] = NULL;
+            continue;
+        }
+
+        slots[index] = bfdev_memalloc_alloc(head, test_size(value >> 13));
+        if (!slots[index])
+            failed++;
+    }
+
+    return failed;
+}
+
+static void
+test_fragment(bfdev_memalloc_head_t *head)
+{
+    bfdev_memalloc_chunk_t *node;
+    size_t size, largest;
+    unsigned long chunks;
+
+    largest = 0;
+    chunks = 0;
+
+    bfdev_list_for_each_entry(node, &head->block_list, block) {
+        if (node->usize & 1)
+            continue;
+
+        size = node->usize;
+        if (size > largest)
+            largest = size;
+        chunks++;
+    }
+
+    bfdev_log_info("\tfree chunks: %lu\n", chunks);
+    bfdev_log_info("\tavailable: %lu largest: %lu\n",
+                   (unsigned long)head->avail, (unsigned long)largest);
+    bfdev_log_info("\tfragmentation: %.2f%%\n",
+                   100.0 - (double)largest * 100 / head->avail);
+}
+
+int
+main(int argc, const char *argv[])
+{
+    bfdev_memalloc_tlsf_t *tlsf;
+    bfdev_memalloc_head_t *head;
+    void **slots, *memory;
+    unsigned int index, count;
+    int failed;
+
+    tlsf = malloc(sizeof(*tlsf));
+    memory = malloc(POOL_SIZE);
+    slots = malloc(sizeof(*slots) * TEST_SLOTS);
+    if (!tlsf || !memory || !slots)
+        return 1;
+
+    for (index = 0; index < BFDEV_ARRAY_SIZE(test_algos); ++index) {
+        head = &tlsf->head;
+        if (test_algos[index].find == bfdev_memalloc_tlsf)
+            bfdev_memalloc_tlsf_init(tlsf, memory, POOL_SIZE);
+        else
+            bfdev_memalloc_init(head, test_algos[index].find,
+                                memory, POOL_SIZE);
+
+        for (count = 0; count < TEST_SLOTS; ++count)
+            slots[count] = NULL;
+
+        bfdev_log_info("%s:\n", test_algos[index].name);
+        failed = EXAMPLE_TIME_STATISTICAL(
+            test_workload(head, slots);
+        );
+
+        bfdev_log_info("\tfailed allocations: %d\n", failed);
+        test_fragment(head);
+    }
+
+    free(slots);
+    free(memory);
+    free(tlsf);
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "ringbuf-broadcast"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <bfdev/log.h>
+#include <bfdev/broadcast.h>
+#include <bfdev/macro.h>
+#include "../time.h"
+
+#define TEST_SIZE 1024
+#define TEST_LOOP (1UL << 16)
+#define TEST_BATCH 64
+#define TEST_CONSUMERS 4
+
+struct test_event {
+    unsigned long value;
+    uint64_t stamp;
+};
+
+struct test_consumer {
+    unsigned int index;
+    uint64_t latency;
+    uint64_t worst;
+    int retval;
+};
+
+static const char *
+test_waits[] = {
+    [BFDEV_BROADCAST_SPIN] = "spin",
+    [BFDEV_BROADCAST_YIELD] = "yield",
+    [BFDEV_BROADCAST_FUTEX] = "futex",
+};
+
+static bfdev_broadcast_t broadcast;
+
+static uint64_t
+test_clock(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void *
+test_consumer(void *pdata)
+{
+    struct test_consumer *consumer;
+    struct test_event *event;
+    unsigned long sequence, count, index;
+    uint64_t latency;
+
+    consumer = pdata;
+    for (sequence = 0; sequence < TEST_LOOP; sequence += count) {
+        count = bfdev_broadcast_next(&broadcast, consumer->index, &sequence);
+
+        /* Every consumer sees every event in order, read in place */
+        for (index = 0; index < count; ++index) {
+            event = bfdev_broadcast_slot(&broadcast, sequence + index);
+            if (event->value != sequence + index) {
+                consumer->retval = 1;
+                return NULL;
+            }
+
+            latency = test_clock() - event->stamp;
+            consumer->latency += latency;
+            if (latency > consumer->worst)
+                consumer->worst = latency;
+        }
+
+        bfdev_broadcast_consume(&broadcast, consumer->index, count);
+    }
+
+    return NULL;
+}
+
+static void
+test_producer(unsigned long batch)
+{
+    struct test_event *event;
+    unsigned long sequence, count, index, len;
+    uint64_t stamp;
+
+    for (count = 0; count < TEST_LOOP; count += len) {
+        len = bfdev_broadcast_claim(&broadcast, batch, &sequence);
+
+        stamp = test_clock();
+        for (index = 0; index < len; ++index) {
+            event = bfdev_broadcast_slot(&broadcast, sequence + index);
+            event->value = sequence + index;
+            event->stamp = stamp;
+        }
+
+        bfdev_broadcast_publish(&broadcast);
+    }
+}
+
+static int
+test_spawn(unsigned int consumers, unsigned long batch)
+{
+    struct test_consumer workers[TEST_CONSUMERS];
+    pthread_t threads[TEST_CONSUMERS];
+    uint64_t latency, worst;
+    unsigned int count;
+    int retval;
+
+    for (count = 0; count < consumers; ++count) {
+        workers[count] = (struct test_consumer) {.index = count};
+        pthread_create(&threads[count], NULL, test_consumer, &workers[count]);
+    }
+
+    test_producer(batch);
+
+    latency = worst = 0;
+    retval = 0;
+
+    for (count = 0; count < consumers; ++count) {
+        pthread_join(threads[count], NULL);
+        retval |= workers[count].retval;
+        latency += workers[count].latency;
+        if (workers[count].worst > worst)
+            worst = workers[count].worst;
+    }
+
+    bfdev_log_info("\tlatency avg %lluns max %lluns\n",
+                   (unsigned long long)(latency / (TEST_LOOP * consumers)),
+                   (unsigned long long)worst);
+
+    return retval;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    static const unsigned long batches[] = {1, TEST_BATCH};
+    unsigned int consumers, wait, index;
+    int retval;
+
+    for (wait = BFDEV_BROADCAST_SPIN; wait <= BFDEV_BROADCAST_FUTEX; ++wait) {
+        for (consumers = 1; consumers <= TEST_CONSUMERS; consumers *= 2) {
+            for (index = 0; index < BFDEV_ARRAY_SIZE(batches); ++index) {
+                retval = bfdev_broadcast_init(&broadcast, NULL,
+                    sizeof(struct test_event), TEST_SIZE, consumers, wait);
+                if (retval)
+                    return retval;
+
+                bfdev_log_info("%s consumers %u batch %lu:\n",
+                               test_waits[wait], consumers, batches[index]);
+
+                retval = EXAMPLE_TIME_STATISTICAL(
+                    test_spawn(consumers, batches[index]);
+                );
+
+                bfdev_broadcast_release(&broadcast);
+                if (retval)
+                    return retval;
+            }
+        }
+    }
+
+    return 0;
+}
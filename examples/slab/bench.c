@@ -0,0 +1,166 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "slab-bench"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <bfdev/log.h>
+#include <bfdev/slab.h>
+#include <bfdev/macro.h>
+#include "../time.h"
+
+#define TEST_OBJSIZE 64
+#define TEST_BATCH 256
+#define TEST_LOOP (1UL << 20)
+#define TEST_THREADS 8
+#define TEST_DRAIN 64
+
+enum test_mode {
+    TEST_MALLOC,
+    TEST_SLAB,
+    TEST_ADAPTER,
+};
+
+struct test_thread {
+    pthread_t thread;
+    bfdev_slab_t *slab;
+    enum test_mode mode;
+    unsigned long loop;
+    int retval;
+};
+
+static const char *
+test_names[] = {
+    [TEST_MALLOC] = "malloc",
+    [TEST_SLAB] = "slab",
+    [TEST_ADAPTER] = "adapter",
+};
+
+static void *
+test_alloc(struct test_thread *tdata)
+{
+    switch (tdata->mode) {
+        case TEST_MALLOC:
+            return bfdev_malloc(NULL, TEST_OBJSIZE);
+
+        case TEST_SLAB:
+            return bfdev_slab_alloc(tdata->slab);
+
+        default:
+            return bfdev_malloc(bfdev_slab_allocator(tdata->slab),
+                                TEST_OBJSIZE - bfdev_slab_header(tdata->slab));
+    }
+}
+
+static void
+test_free(struct test_thread *tdata, void *block)
+{
+    switch (tdata->mode) {
+        case TEST_MALLOC:
+            bfdev_free(NULL, block);
+            break;
+
+        case TEST_SLAB:
+            bfdev_slab_free(tdata->slab, block);
+            break;
+
+        default:
+            bfdev_free(bfdev_slab_allocator(tdata->slab), block);
+            break;
+    }
+}
+
+static void *
+test_worker(void *data)
+{
+    struct test_thread *tdata;
+    void *blocks[TEST_BATCH];
+    unsigned long count;
+    unsigned int index;
+
+    tdata = data;
+    for (count = 0; count < tdata->loop; count += TEST_BATCH) {
+        for (index = 0; index < TEST_BATCH; ++index) {
+            blocks[index] = test_alloc(tdata);
+            if (!blocks[index]) {
+                tdata->retval = 1;
+                return NULL;
+            }
+            *(unsigned long *)blocks[index] = count + index;
+        }
+
+        for (index = 0; index < TEST_BATCH; ++index) {
+            if (*(unsigned long *)blocks[index] != count + index) {
+                tdata->retval = 1;
+                return NULL;
+            }
+            test_free(tdata, blocks[index]);
+        }
+
+        /* Drains race with the other workers on purpose */
+        if (tdata->mode != TEST_MALLOC && !(count % (TEST_BATCH * TEST_DRAIN)))
+            bfdev_slab_drain(tdata->slab);
+    }
+
+    return NULL;
+}
+
+static int
+test_bench(bfdev_slab_t *slab, enum test_mode mode, unsigned int nthreads)
+{
+    struct test_thread tdata[TEST_THREADS];
+    unsigned int count;
+    int retval;
+
+    bfdev_log_info("%s %u threads:\n", test_names[mode], nthreads);
+    retval = EXAMPLE_TIME_STATISTICAL(
+        for (count = 0; count < nthreads; ++count) {
+            tdata[count].slab = slab;
+            tdata[count].mode = mode;
+            tdata[count].loop = TEST_LOOP / nthreads;
+            tdata[count].retval = 0;
+            pthread_create(&tdata[count].thread, NULL,
+                           test_worker, &tdata[count]);
+        }
+
+        retval = 0;
+        for (count = 0; count < nthreads; ++count) {
+            pthread_join(tdata[count].thread, NULL);
+            retval |= tdata[count].retval;
+        }
+
+        retval;
+    );
+
+    return retval;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    bfdev_slab_t slab;
+    unsigned int nthreads;
+    enum test_mode mode;
+    int retval;
+
+    retval = bfdev_slab_init(&slab, NULL, TEST_OBJSIZE, 0);
+    if (retval)
+        return retval;
+
+    for (nthreads = 1; nthreads <= TEST_THREADS; nthreads <<= 1) {
+        for (mode = TEST_MALLOC; mode <= TEST_ADAPTER; ++mode) {
+            retval = test_bench(&slab, mode, nthreads);
+            if (retval)
+                goto failed;
+        }
+    }
+
+failed:
+    bfdev_slab_release(&slab);
+    return retval;
+}
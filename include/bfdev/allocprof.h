@@ -0,0 +1,94 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_ALLOCPROF_H_
+#define _BFDEV_ALLOCPROF_H_
+
+#include <bfdev/config.h>
+#include <bfdev/types.h>
+#include <bfdev/stddef.h>
+#include <bfdev/allocator.h>
+
+BFDEV_BEGIN_DECLS
+
+#ifndef BFDEV_ALLOCPROF_HISTOGRAM
+# define BFDEV_ALLOCPROF_HISTOGRAM 16
+#endif
+
+#ifndef BFDEV_ALLOCPROF_HEADER
+# define BFDEV_ALLOCPROF_HEADER (sizeof(size_t) * 2)
+#endif
+
+typedef struct bfdev_allocprof bfdev_allocprof_t;
+
+/**
+ * struct bfdev_allocprof - profiling allocator of one tag.
+ * @name: tag shown in the report.
+ * @alloc: wrapped allocator.
+ * @allocs: successful allocations.
+ * @frees: blocks freed.
+ * @reallocs: successful reallocations.
+ * @failed: failed requests.
+ * @live: bytes currently allocated.
+ * @peak: highest value of @live.
+ * @histogram: requests per size class, 8 bytes then doubling.
+ * @allocator: allocator interface handed to the container.
+ */
+struct bfdev_allocprof {
+    const char *name;
+    const bfdev_alloc_t *alloc;
+
+    bfdev_atomic_t allocs;
+    bfdev_atomic_t frees;
+    bfdev_atomic_t reallocs;
+    bfdev_atomic_t failed;
+    bfdev_atomic_t live;
+    bfdev_atomic_t peak;
+    bfdev_atomic_t histogram[BFDEV_ALLOCPROF_HISTOGRAM];
+
+    bfdev_alloc_ops_t ops;
+    bfdev_alloc_t allocator;
+};
+
+/**
+ * bfdev_allocprof_init() - initialize a profiling allocator.
+ * @prof: the profile to initialize.
+ * @name: tag shown in the report.
+ * @alloc: wrapped allocator.
+ */
+extern void
+bfdev_allocprof_init(bfdev_allocprof_t *prof, const char *name,
+                     const bfdev_alloc_t *alloc);
+
+/**
+ * bfdev_allocprof_reset() - clear the counters, keeping live bytes.
+ * @prof: the profile to reset.
+ */
+extern void
+bfdev_allocprof_reset(bfdev_allocprof_t *prof);
+
+/**
+ * bfdev_allocprof_report() - dump the counters through bfdev_log.
+ * @prof: the profile to report.
+ */
+extern void
+bfdev_allocprof_report(bfdev_allocprof_t *prof);
+
+/**
+ * bfdev_allocprof_allocator() - allocator interface of a profile.
+ * @prof: the profile to use.
+ *
+ * Every block carries a small header holding its size, so that
+ * frees can be accounted for.
+ */
+static inline const bfdev_alloc_t *
+bfdev_allocprof_allocator(bfdev_allocprof_t *prof)
+{
+    return &prof->allocator;
+}
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_ALLOCPROF_H_ */
@@ -0,0 +1,135 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_ARENA_H_
+#define _BFDEV_ARENA_H_
+
+#include <bfdev/config.h>
+#include <bfdev/types.h>
+#include <bfdev/stddef.h>
+#include <bfdev/allocator.h>
+#include <bfdev/allocpool.h>
+
+BFDEV_BEGIN_DECLS
+
+#ifndef BFDEV_ARENA_CHUNK
+# define BFDEV_ARENA_CHUNK 4096
+#endif
+
+typedef struct bfdev_arena bfdev_arena_t;
+typedef struct bfdev_arena_chunk bfdev_arena_chunk_t;
+typedef struct bfdev_arena_mark bfdev_arena_mark_t;
+
+/**
+ * struct bfdev_arena_chunk - memory chunk of an arena.
+ * @next: following chunk, kept for reuse after a rollback.
+ * @pool: bump allocator over the chunk payload.
+ */
+struct bfdev_arena_chunk {
+    bfdev_arena_chunk_t *next;
+    bfdev_allocpool_t pool;
+};
+
+/**
+ * struct bfdev_arena_mark - savepoint of an arena.
+ * @chunk: chunk in use when the mark was taken.
+ * @last: offset within that chunk.
+ */
+struct bfdev_arena_mark {
+    bfdev_arena_chunk_t *chunk;
+    uintptr_t last;
+};
+
+/**
+ * struct bfdev_arena - growable multi-chunk arena.
+ * @alloc: backing allocator of the chunks.
+ * @chunks: first chunk.
+ * @current: chunk serving allocations.
+ * @latest: latest block, which realloc can grow in place.
+ * @chunk_size: payload size of a regular chunk.
+ * @allocator: allocator interface on top of this arena.
+ */
+struct bfdev_arena {
+    const bfdev_alloc_t *alloc;
+    bfdev_arena_chunk_t *chunks;
+    bfdev_arena_chunk_t *current;
+    void *latest;
+    size_t chunk_size;
+
+    bfdev_alloc_ops_t ops;
+    bfdev_alloc_t allocator;
+};
+
+/**
+ * bfdev_arena_alloc() - allocate memory from an arena.
+ * @arena: the arena to allocate from.
+ * @size: size to allocate.
+ * @align: alignment to allocate.
+ */
+extern __bfdev_malloc void *
+bfdev_arena_alloc(bfdev_arena_t *arena, size_t size, size_t align);
+
+/**
+ * bfdev_arena_mark() - take a savepoint.
+ * @arena: the arena to mark.
+ * @mark: the savepoint to fill.
+ */
+static inline void
+bfdev_arena_mark(bfdev_arena_t *arena, bfdev_arena_mark_t *mark)
+{
+    mark->chunk = arena->current;
+    mark->last = arena->current ? arena->current->pool.last : 0;
+}
+
+/**
+ * bfdev_arena_rollback() - free everything allocated after a savepoint.
+ * @arena: the arena to rollback.
+ * @mark: savepoint taken before.
+ *
+ * Chunks beyond the savepoint are kept for reuse.
+ */
+extern void
+bfdev_arena_rollback(bfdev_arena_t *arena, const bfdev_arena_mark_t *mark);
+
+/**
+ * bfdev_arena_reset() - free everything but keep the chunks.
+ * @arena: the arena to reset.
+ */
+extern void
+bfdev_arena_reset(bfdev_arena_t *arena);
+
+/**
+ * bfdev_arena_init() - initialize an arena.
+ * @arena: the arena to initialize.
+ * @alloc: backing allocator of the chunks.
+ * @chunk_size: payload size of a chunk, zero for the default.
+ */
+extern void
+bfdev_arena_init(bfdev_arena_t *arena, const bfdev_alloc_t *alloc,
+                 size_t chunk_size);
+
+/**
+ * bfdev_arena_release() - return every chunk to the backing allocator.
+ * @arena: the arena to release.
+ */
+extern void
+bfdev_arena_release(bfdev_arena_t *arena);
+
+/**
+ * bfdev_arena_allocator() - allocator interface of an arena.
+ * @arena: the arena to use.
+ *
+ * Free is a no-op, the memory comes back on rollback, reset or
+ * release. Realloc grows the latest block in place when it can.
+ */
+static inline const bfdev_alloc_t *
+bfdev_arena_allocator(bfdev_arena_t *arena)
+{
+    return &arena->allocator;
+}
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_ARENA_H_ */
@@ -0,0 +1,51 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_ASM_GENERIC_BARRIER_H_
+#define _BFDEV_ASM_GENERIC_BARRIER_H_
+
+#include <bfdev/config.h>
+
+BFDEV_BEGIN_DECLS
+
+#ifndef BFDEV_CACHELINE_SIZE
+# define BFDEV_CACHELINE_SIZE 64
+#endif
+
+#ifndef bfdev_arch_mb
+# define bfdev_arch_mb() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+#ifndef bfdev_arch_rmb
+# define bfdev_arch_rmb() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#endif
+
+#ifndef bfdev_arch_wmb
+# define bfdev_arch_wmb() __atomic_thread_fence(__ATOMIC_RELEASE)
+#endif
+
+#ifndef bfdev_arch_load_acquire
+# define bfdev_arch_load_acquire(ptr) \
+    __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#endif
+
+#ifndef bfdev_arch_store_release
+# define bfdev_arch_store_release(ptr, value) \
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+#endif
+
+#ifndef bfdev_arch_cpu_relax
+# if defined(__i386__) || defined(__x86_64__)
+#  define bfdev_arch_cpu_relax() __asm__ __volatile__("pause":::"memory")
+# elif defined(__aarch64__)
+#  define bfdev_arch_cpu_relax() __asm__ __volatile__("yield":::"memory")
+# else
+#  define bfdev_arch_cpu_relax() bfdev_barrier()
+# endif
+#endif
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_ASM_GENERIC_BARRIER_H_ */
@@ -0,0 +1,64 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_BARRIER_H_
+#define _BFDEV_BARRIER_H_
+
+#include <bfdev/config.h>
+#include <bfdev/asm/barrier.h>
+
+BFDEV_BEGIN_DECLS
+
+#define __bfdev_cacheline_aligned \
+    __bfdev_aligned(BFDEV_CACHELINE_SIZE)
+
+/**
+ * bfdev_mb - full memory barrier.
+ */
+#ifndef bfdev_mb
+# define bfdev_mb() bfdev_arch_mb()
+#endif
+
+/**
+ * bfdev_rmb - read memory barrier.
+ */
+#ifndef bfdev_rmb
+# define bfdev_rmb() bfdev_arch_rmb()
+#endif
+
+/**
+ * bfdev_wmb - write memory barrier.
+ */
+#ifndef bfdev_wmb
+# define bfdev_wmb() bfdev_arch_wmb()
+#endif
+
+/**
+ * bfdev_load_acquire - load a variable with acquire semantics.
+ * @ptr: pointer of the variable.
+ */
+#ifndef bfdev_load_acquire
+# define bfdev_load_acquire(ptr) bfdev_arch_load_acquire(ptr)
+#endif
+
+/**
+ * bfdev_store_release - store a variable with release semantics.
+ * @ptr: pointer of the variable.
+ * @value: required value.
+ */
+#ifndef bfdev_store_release
+# define bfdev_store_release(ptr, value) bfdev_arch_store_release(ptr, value)
+#endif
+
+/**
+ * bfdev_cpu_relax - hint the cpu that we are in a spin loop.
+ */
+#ifndef bfdev_cpu_relax
+# define bfdev_cpu_relax() bfdev_arch_cpu_relax()
+#endif
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_BARRIER_H_ */
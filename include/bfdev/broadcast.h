@@ -0,0 +1,169 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_BROADCAST_H_
+#define _BFDEV_BROADCAST_H_
+
+#include <bfdev/config.h>
+#include <bfdev/types.h>
+#include <bfdev/stddef.h>
+#include <bfdev/errno.h>
+#include <bfdev/barrier.h>
+#include <bfdev/allocator.h>
+
+BFDEV_BEGIN_DECLS
+
+typedef struct bfdev_broadcast bfdev_broadcast_t;
+typedef struct bfdev_broadcast_cursor bfdev_broadcast_cursor_t;
+
+enum bfdev_broadcast_wait {
+    BFDEV_BROADCAST_SPIN = 0,
+    BFDEV_BROADCAST_YIELD,
+    BFDEV_BROADCAST_FUTEX,
+};
+
+/**
+ * struct bfdev_broadcast_cursor - read position of one consumer.
+ * @sequence: next sequence the consumer reads.
+ */
+struct bfdev_broadcast_cursor {
+    bfdev_atomic_t sequence;
+} __bfdev_cacheline_aligned;
+
+/**
+ * struct bfdev_broadcast - single producer ring read by every consumer.
+ * @wait: how to wait, one of enum bfdev_broadcast_wait.
+ * @cursors: one cursor per consumer, the producer gates on the slowest.
+ * @claimed: end of the sequences claimed by the producer.
+ * @gate: cached sequence of the slowest consumer.
+ * @published: end of the sequences visible to consumers.
+ * @pfutex: bumped whenever a consumer frees slots.
+ * @cfutex: bumped whenever the producer publishes.
+ *
+ * Events are stored once and read in place by all consumers, each
+ * consumer tracks its own progress.
+ */
+struct bfdev_broadcast {
+    const bfdev_alloc_t *alloc;
+    unsigned long mask;
+    unsigned long esize;
+    void *data;
+
+    unsigned int wait;
+    unsigned int consumers;
+    bfdev_broadcast_cursor_t *cursors;
+    void *block;
+
+    unsigned long claimed __bfdev_cacheline_aligned;
+    unsigned long gate;
+    bfdev_atomic_t pwaiters;
+    bfdev_atomic_t pfutex;
+
+    bfdev_atomic_t published __bfdev_cacheline_aligned;
+    bfdev_atomic_t cwaiters;
+    bfdev_atomic_t cfutex;
+};
+
+/**
+ * bfdev_broadcast_slot() - get the element of a sequence.
+ * @broadcast: the ring to access.
+ * @sequence: the sequence of the element.
+ */
+static inline void *
+bfdev_broadcast_slot(bfdev_broadcast_t *broadcast, unsigned long sequence)
+{
+    return broadcast->data + (sequence & broadcast->mask) * broadcast->esize;
+}
+
+/**
+ * bfdev_broadcast_size() - get the size of the ring in elements.
+ * @broadcast: the ring to get size.
+ */
+static inline unsigned long
+bfdev_broadcast_size(bfdev_broadcast_t *broadcast)
+{
+    return broadcast->mask + 1;
+}
+
+/**
+ * bfdev_broadcast_claim() - claim a batch of slots to write.
+ * @broadcast: the ring to claim from.
+ * @len: number of slots, clamped to the ring size.
+ * @sequence: receives the first claimed sequence.
+ *
+ * Waits until the slowest consumer has left room for the batch.
+ * Returns the number of slots claimed.
+ */
+extern unsigned long
+bfdev_broadcast_claim(bfdev_broadcast_t *broadcast, unsigned long len,
+                      unsigned long *sequence);
+
+/**
+ * bfdev_broadcast_publish() - make every claimed slot visible.
+ * @broadcast: the ring to publish.
+ */
+extern void
+bfdev_broadcast_publish(bfdev_broadcast_t *broadcast);
+
+/**
+ * bfdev_broadcast_poll() - get the events pending for a consumer.
+ * @broadcast: the ring to read.
+ * @consumer: index of the consumer.
+ * @sequence: receives the first pending sequence.
+ *
+ * Returns the number of pending events, zero if there are none.
+ */
+extern unsigned long
+bfdev_broadcast_poll(bfdev_broadcast_t *broadcast, unsigned int consumer,
+                     unsigned long *sequence);
+
+/**
+ * bfdev_broadcast_next() - wait for events pending for a consumer.
+ * @broadcast: the ring to read.
+ * @consumer: index of the consumer.
+ * @sequence: receives the first pending sequence.
+ *
+ * Like bfdev_broadcast_poll() but waits for at least one event.
+ */
+extern unsigned long
+bfdev_broadcast_next(bfdev_broadcast_t *broadcast, unsigned int consumer,
+                     unsigned long *sequence);
+
+/**
+ * bfdev_broadcast_consume() - mark events of a consumer as read.
+ * @broadcast: the ring to read.
+ * @consumer: index of the consumer.
+ * @len: number of events read.
+ */
+extern void
+bfdev_broadcast_consume(bfdev_broadcast_t *broadcast, unsigned int consumer,
+                        unsigned long len);
+
+/**
+ * bfdev_broadcast_init() - initialize a broadcast ring.
+ * @broadcast: the ring to initialize.
+ * @alloc: allocator of the ring.
+ * @esize: element size.
+ * @size: number of elements, rounded up to a power of two.
+ * @consumers: number of consumers.
+ * @wait: how to wait, one of enum bfdev_broadcast_wait.
+ *
+ * Futex waits fall back to yielding where futexes are not supported.
+ */
+extern int
+bfdev_broadcast_init(bfdev_broadcast_t *broadcast, const bfdev_alloc_t *alloc,
+                     size_t esize, size_t size, unsigned int consumers,
+                     unsigned int wait);
+
+/**
+ * bfdev_broadcast_release() - release a broadcast ring.
+ * @broadcast: the ring to release.
+ */
+extern void
+bfdev_broadcast_release(bfdev_broadcast_t *broadcast);
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_BROADCAST_H_ */
@@ -18,6 +18,20 @@ typedef struct bfdev_btree_layout bfdev_btree_layout_t;
 typedef struct bfdev_btree_node bfdev_btree_node_t;
 typedef struct bfdev_btree_root bfdev_btree_root_t;
 typedef struct bfdev_btree_ops bfdev_btree_ops_t;
+typedef struct bfdev_btree_cursor bfdev_btree_cursor_t;
+
+/**
+ * bfdev_btree_stream_t - produce the next pair of a bulk load.
+ * @key: receives the next key.
+ * @pdata: private data of the stream.
+ *
+ * Returns the value, or NULL once the stream is exhausted.
+ */
+typedef void *(*bfdev_btree_stream_t)(uintptr_t *key, void *pdata);
+
+#ifndef BFDEV_BTREE_LEVELS
+# define BFDEV_BTREE_LEVELS 32
+#endif
 
 struct bfdev_btree_layout {
     unsigned int keylen;
@@ -58,6 +72,23 @@ struct bfdev_btree_ops {
 #define BFDEV_BTREE_ROOT(name, layout, ops, pdata) \
     bfdev_btree_root_t name = BFDEV_BTREE_INIT(layout, ops, pdata)
 
+/**
+ * struct bfdev_btree_cursor - position kept on a leaf of a btree.
+ * @root: the btree walked.
+ * @nodes: path of nodes, from the leaf up to the root.
+ * @index: slot taken in each node of the path.
+ * @depth: levels of the path, zero once walked off the end.
+ *
+ * Any change made to the btree outside the cursor invalidates it,
+ * it has to be repositioned before stepping again.
+ */
+struct bfdev_btree_cursor {
+    bfdev_btree_root_t *root;
+    bfdev_btree_node_t *nodes[BFDEV_BTREE_LEVELS];
+    unsigned int index[BFDEV_BTREE_LEVELS];
+    unsigned int depth;
+};
+
 extern bfdev_btree_layout_t
 bfdev_btree_layout32;
 
@@ -98,6 +129,55 @@ bfdev_btree_insert(bfdev_btree_root_t *root, uintptr_t *key, void *value);
 extern void *
 bfdev_btree_remove(bfdev_btree_root_t *root, uintptr_t *key);
 
+/**
+ * bfdev_btree_bulk_load() - build an empty btree from sorted pairs.
+ * @root: the empty btree to build.
+ * @fill: percentage of the slots used in every node, 1 to 100.
+ * @stream: yields the pairs in ascending key order.
+ * @pdata: private data of @stream.
+ *
+ * Nodes are packed bottom-up without descending from the root, a
+ * @fill below 100 leaves room for later inserts without splitting.
+ * The last node of each level is folded into or evened out with its
+ * left sibling, so no node but the root ends up below half full.
+ * On error nothing is left allocated and the btree stays empty.
+ */
+extern int
+bfdev_btree_bulk_load(bfdev_btree_root_t *root, unsigned int fill,
+                      bfdev_btree_stream_t stream, void *pdata);
+
+/**
+ * bfdev_btree_insert_batch() - insert a stream of pairs.
+ * @root: the btree to insert into.
+ * @stream: yields the pairs, ideally in ascending key order.
+ * @pdata: private data of @stream.
+ *
+ * A cursor stays on the leaf of the last insert, a pair that still
+ * belongs there is placed without descending from the root. Pairs
+ * that need a split or clash take the regular insert path.
+ * Returns the error of the first failing insert, earlier pairs stay.
+ */
+extern int
+bfdev_btree_insert_batch(bfdev_btree_root_t *root,
+                         bfdev_btree_stream_t stream, void *pdata);
+
+/**
+ * bfdev_btree_remove_range() - remove every key within a range.
+ * @root: the btree to remove from.
+ * @min: the smallest key removed.
+ * @max: the largest key removed.
+ * @release: called on each removed value, may be NULL.
+ * @pdata: private data of @release.
+ *
+ * The covered part of each leaf is dropped at once and the leaf is
+ * rebalanced a single time. Values chained by @ops->remove are all
+ * released with their key. Returns the number of keys removed.
+ */
+extern unsigned long
+bfdev_btree_remove_range(bfdev_btree_root_t *root, uintptr_t *min,
+                         uintptr_t *max, bfdev_release_t release,
+                         void *pdata);
+
 extern void
 bfdev_btree_release(bfdev_btree_root_t *root, bfdev_release_t release,
                     void *pdata);
@@ -114,6 +194,96 @@ bfdev_btree_next(bfdev_btree_root_t *root, uintptr_t *key);
 extern void *
 bfdev_btree_prev(bfdev_btree_root_t *root, uintptr_t *key);
 
+/**
+ * bfdev_btree_cursor_first() - move a cursor to the first pair.
+ * @cursor: the cursor to move.
+ */
+extern void *
+bfdev_btree_cursor_first(bfdev_btree_cursor_t *cursor);
+
+/**
+ * bfdev_btree_cursor_last() - move a cursor to the last pair.
+ * @cursor: the cursor to move.
+ */
+extern void *
+bfdev_btree_cursor_last(bfdev_btree_cursor_t *cursor);
+
+/**
+ * bfdev_btree_cursor_seek() - move a cursor to the first pair not above a key.
+ * @cursor: the cursor to move.
+ * @key: the key to seek.
+ *
+ * Iteration runs from the largest key down, so this is where a
+ * forward walk over the keys not above @key starts.
+ */
+extern void *
+bfdev_btree_cursor_seek(bfdev_btree_cursor_t *cursor, uintptr_t *key);
+
+/**
+ * bfdev_btree_cursor_next() - step a cursor forward.
+ * @cursor: the cursor to step.
+ *
+ * Only climbs the path when the current leaf is exhausted.
+ */
+extern void *
+bfdev_btree_cursor_next(bfdev_btree_cursor_t *cursor);
+
+/**
+ * bfdev_btree_cursor_prev() - step a cursor backward.
+ * @cursor: the cursor to step.
+ */
+extern void *
+bfdev_btree_cursor_prev(bfdev_btree_cursor_t *cursor);
+
+static inline void
+bfdev_btree_cursor_init(bfdev_btree_cursor_t *cursor, bfdev_btree_root_t *root)
+{
+    cursor->root = root;
+    cursor->depth = 0;
+}
+
+/**
+ * bfdev_btree_cursor_key() - key under a positioned cursor.
+ * @cursor: the cursor to read.
+ */
+static inline uintptr_t *
+bfdev_btree_cursor_key(bfdev_btree_cursor_t *cursor)
+{
+    bfdev_btree_layout_t *layout;
+    unsigned int offset;
+
+    layout = cursor->root->layout;
+    offset = layout->keylen * cursor->index[0];
+
+    return &cursor->nodes[0]->block[offset];
+}
+
+/**
+ * bfdev_btree_cursor_for_each - iterate over a btree with a cursor.
+ * @cursor: the cursor to use.
+ * @value: the value of current loop cursor.
+ */
+#define bfdev_btree_cursor_for_each(cursor, value)  \
+    for (value = bfdev_btree_cursor_first(cursor);  \
+         value; value = bfdev_btree_cursor_next(cursor))
+
+/**
+ * bfdev_btree_cursor_for_each_reverse - iterate backwards over a btree with a cursor.
+ * @cursor: the cursor to use.
+ * @value: the value of current loop cursor.
+ */
+#define bfdev_btree_cursor_for_each_reverse(cursor, value)  \
+    for (value = bfdev_btree_cursor_last(cursor);           \
+         value; value = bfdev_btree_cursor_prev(cursor))
+
+/**
+ * bfdev_btree_cursor_for_each_from - iterate with a cursor from its current point.
+ * @cursor: the cursor to use.
+ * @value: the value of current loop cursor.
+ */
+#define bfdev_btree_cursor_for_each_from(cursor, value) \
+    for (; value; value = bfdev_btree_cursor_next(cursor))
+
 /**
  * bfdev_btree_for_each - iterate over a btree.
  * @root: the root for your btree.
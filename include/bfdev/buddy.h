@@ -0,0 +1,100 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_BUDDY_H_
+#define _BFDEV_BUDDY_H_
+
+#include <bfdev/config.h>
+#include <bfdev/types.h>
+#include <bfdev/stddef.h>
+#include <bfdev/list.h>
+#include <bfdev/allocator.h>
+
+BFDEV_BEGIN_DECLS
+
+#ifndef BFDEV_BUDDY_ORDERS
+# define BFDEV_BUDDY_ORDERS 16
+#endif
+
+typedef struct bfdev_buddy bfdev_buddy_t;
+
+/**
+ * struct bfdev_buddy - binary buddy page allocator.
+ * @base: first page, aligned to the page size.
+ * @shift: log2 of the page size.
+ * @pages: number of pages managed.
+ * @avail: number of free pages.
+ * @free: free blocks of each order, linked through their first bytes.
+ * @bitmap: free blocks of each order, indexed by block number.
+ * @orders: order of the allocated block starting at each page.
+ * @allocator: allocator interface on top of this buddy.
+ */
+struct bfdev_buddy {
+    void *base;
+    unsigned int shift;
+    unsigned long pages;
+    unsigned long avail;
+
+    bfdev_list_head_t free[BFDEV_BUDDY_ORDERS];
+    unsigned long *bitmap[BFDEV_BUDDY_ORDERS];
+    uint8_t *orders;
+
+    bfdev_alloc_ops_t ops;
+    bfdev_alloc_t allocator;
+};
+
+/**
+ * bfdev_buddy_order() - smallest order holding a size.
+ * @buddy: the buddy to query.
+ * @size: size in bytes.
+ */
+extern unsigned int
+bfdev_buddy_order(bfdev_buddy_t *buddy, size_t size);
+
+/**
+ * bfdev_buddy_alloc() - allocate a block of 2^order pages.
+ * @buddy: the buddy to allocate from.
+ * @order: order of the block.
+ *
+ * The block is aligned to its own size, relative to @buddy->base.
+ */
+extern __bfdev_malloc void *
+bfdev_buddy_alloc(bfdev_buddy_t *buddy, unsigned int order);
+
+/**
+ * bfdev_buddy_free() - free a block and merge it with its buddies.
+ * @buddy: the buddy the block was allocated from.
+ * @block: block to free.
+ */
+extern void
+bfdev_buddy_free(bfdev_buddy_t *buddy, void *block);
+
+/**
+ * bfdev_buddy_init() - manage a memory region.
+ * @buddy: the buddy to initialize.
+ * @memory: region address.
+ * @size: region size.
+ * @page: page size, power of two.
+ *
+ * The bookkeeping is carved from the front of the region.
+ */
+extern int
+bfdev_buddy_init(bfdev_buddy_t *buddy, void *memory, size_t size, size_t page);
+
+/**
+ * bfdev_buddy_allocator() - allocator interface of a buddy.
+ * @buddy: the buddy to use.
+ *
+ * Every request is rounded up to a power of two number of pages.
+ */
+static inline const bfdev_alloc_t *
+bfdev_buddy_allocator(bfdev_buddy_t *buddy)
+{
+    return &buddy->allocator;
+}
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_BUDDY_H_ */
@@ -0,0 +1,162 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_CACHE_SHARD_H_
+#define _BFDEV_CACHE_SHARD_H_
+
+#include <bfdev/config.h>
+#include <bfdev/cache.h>
+#include <bfdev/spinlock.h>
+#include <bfdev/barrier.h>
+
+BFDEV_BEGIN_DECLS
+
+typedef struct bfdev_cache_shard bfdev_cache_shard_t;
+typedef struct bfdev_cache_slot bfdev_cache_slot_t;
+
+/**
+ * struct bfdev_cache_slot - one independent partition of a sharded cache.
+ * @lock: serializes every operation on @head.
+ * @head: cache instance owning the tags hashed to this slot.
+ */
+struct bfdev_cache_slot {
+    bfdev_spinlock_t lock;
+    bfdev_cache_head_t *head;
+} __bfdev_cacheline_aligned;
+
+/**
+ * struct bfdev_cache_shard - thread-safe cache partitioned by tag hash.
+ * @slots: cache partitions, tag hash modulo @nslots.
+ */
+struct bfdev_cache_shard {
+    const bfdev_alloc_t *alloc;
+    const bfdev_cache_ops_t *ops;
+    void *pdata;
+
+    bfdev_cache_slot_t *slots;
+    unsigned long nslots;
+    void *block;
+};
+
+/**
+ * bfdev_cache_shard_obtain() - obtain element by tag from a sharded cache.
+ * @shard: the sharded cache.
+ * @tag: element key.
+ * @flags: ways to obtaining element.
+ *
+ * A pending element must be committed by bfdev_cache_shard_commit()
+ * once its data is filled in, before it is put back.
+ */
+extern bfdev_cache_node_t *
+bfdev_cache_shard_obtain(bfdev_cache_shard_t *shard, const void *tag,
+                         unsigned long flags);
+
+/**
+ * bfdev_cache_shard_commit() - commit a pending element.
+ * @shard: the sharded cache.
+ * @node: pending element obtained from @shard.
+ */
+extern int
+bfdev_cache_shard_commit(bfdev_cache_shard_t *shard, bfdev_cache_node_t *node);
+
+/**
+ * bfdev_cache_shard_put() - put using element into the sharded cache.
+ * @shard: the sharded cache.
+ * @node: element to be put.
+ */
+extern unsigned long
+bfdev_cache_shard_put(bfdev_cache_shard_t *shard, bfdev_cache_node_t *node);
+
+/**
+ * bfdev_cache_shard_del() - delete managed element from the sharded cache.
+ * @shard: the sharded cache.
+ * @node: element to be deleted.
+ */
+extern int
+bfdev_cache_shard_del(bfdev_cache_shard_t *shard, bfdev_cache_node_t *node);
+
+/**
+ * bfdev_cache_shard_weight() - set the cost of an element.
+ * @shard: the sharded cache.
+ * @node: element obtained from @shard.
+ * @cost: cost charged against the budget of its partition.
+ */
+extern int
+bfdev_cache_shard_weight(bfdev_cache_shard_t *shard, bfdev_cache_node_t *node,
+                         unsigned long cost);
+
+/**
+ * bfdev_cache_shard_budget() - limit the total cost of the sharded cache.
+ * @shard: the sharded cache.
+ * @budget: maximum total cost, split evenly between partitions.
+ */
+extern void
+bfdev_cache_shard_budget(bfdev_cache_shard_t *shard, unsigned long budget);
+
+/**
+ * bfdev_cache_shard_ttl() - arm the expiry timer of an element.
+ * @shard: the sharded cache.
+ * @node: element obtained from @shard.
+ * @ttl: time to live, relative to the last expire call of its partition.
+ */
+extern int
+bfdev_cache_shard_ttl(bfdev_cache_shard_t *shard, bfdev_cache_node_t *node,
+                      bfdev_time_t ttl);
+
+/**
+ * bfdev_cache_shard_expire() - reclaim expired elements of all partitions.
+ * @shard: the sharded cache.
+ * @now: current time, in wheel ticks.
+ */
+extern unsigned long
+bfdev_cache_shard_expire(bfdev_cache_shard_t *shard, bfdev_time_t now);
+
+/**
+ * bfdev_cache_shard_stats() - aggregate statistics of all partitions.
+ * @shard: the sharded cache.
+ * @stats: statistics output.
+ *
+ * Counters and the current weight are summed over the partitions,
+ * @stats->peak is the highest weight any single partition reached.
+ */
+extern void
+bfdev_cache_shard_stats(bfdev_cache_shard_t *shard, bfdev_cache_stats_t *stats);
+
+extern void
+bfdev_cache_shard_reset(bfdev_cache_shard_t *shard);
+
+/**
+ * bfdev_cache_shard_create() - create a sharded cache.
+ * @name: name of the cache algorithm used by every partition.
+ * @alloc: allocator operations.
+ * @ops: cache operations.
+ * @shards: number of partitions, rounded up to power of two.
+ * @size: total number of elements, split evenly between partitions.
+ * @maxpend: maximum pending elements of each partition.
+ * @pdata: private data pointer of @ops.
+ */
+extern bfdev_cache_shard_t *
+bfdev_cache_shard_create(const char *name, const bfdev_alloc_t *alloc,
+                         const bfdev_cache_ops_t *ops, unsigned long shards,
+                         unsigned long size, unsigned long maxpend, void *pdata);
+
+extern void
+bfdev_cache_shard_destroy(bfdev_cache_shard_t *shard);
+
+static inline bfdev_cache_node_t *
+bfdev_cache_shard_get(bfdev_cache_shard_t *shard, const void *tag)
+{
+    return bfdev_cache_shard_obtain(shard, tag, BFDEV_CACHE_CHANGE);
+}
+
+static inline bfdev_cache_node_t *
+bfdev_cache_shard_try_get(bfdev_cache_shard_t *shard, const void *tag)
+{
+    return bfdev_cache_shard_obtain(shard, tag, 0);
+}
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_CACHE_SHARD_H_ */
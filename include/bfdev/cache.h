@@ -12,17 +12,34 @@
 #include <bfdev/list.h>
 #include <bfdev/hlist.h>
 #include <bfdev/bitflags.h>
+#include <bfdev/bitmap.h>
+#include <bfdev/time.h>
 
 BFDEV_BEGIN_DECLS
 
 typedef enum bfdev_cache_obtain bfdev_cache_obtain_t;
 typedef enum bfdev_cache_flags bfdev_cache_flags_t;
 typedef enum bfdev_cache_status bfdev_cache_status_t;
+typedef enum bfdev_cache_algo_flags bfdev_cache_algo_flags_t;
 
 typedef struct bfdev_cache_head bfdev_cache_head_t;
 typedef struct bfdev_cache_node bfdev_cache_node_t;
 typedef struct bfdev_cache_algo bfdev_cache_algo_t;
 typedef struct bfdev_cache_ops bfdev_cache_ops_t;
+typedef struct bfdev_cache_stats bfdev_cache_stats_t;
+
+#ifndef BFDEV_CACHE_WHEEL_BITS
+# define BFDEV_CACHE_WHEEL_BITS 6
+#endif
+
+#ifndef BFDEV_CACHE_WHEEL_LEVELS
+# define BFDEV_CACHE_WHEEL_LEVELS 4
+#endif
+
+#define BFDEV_CACHE_WHEEL_SLOTS (1UL << BFDEV_CACHE_WHEEL_BITS)
+#define BFDEV_CACHE_WHEEL_MASK (BFDEV_CACHE_WHEEL_SLOTS - 1)
+#define BFDEV_CACHE_WHEEL_TOTAL \
+    (BFDEV_CACHE_WHEEL_LEVELS * BFDEV_CACHE_WHEEL_SLOTS)
 
 enum bfdev_cache_obtain {
     __BFDEV_CACHE_CHANGE = 0,
@@ -48,6 +65,17 @@ enum bfdev_cache_status {
     BFDEV_CACHE_MANAGED,
 };
 
+/*
+ * Ring algorithms keep every resident node in place, even while it
+ * is in use. A hit neither moves the node nor calls get/put, only
+ * update, and obtain must skip nodes that are not managed.
+ */
+enum bfdev_cache_algo_flags {
+    __BFDEV_CACHE_ALGO_RING = 0,
+
+    BFDEV_CACHE_ALGO_RING = BFDEV_BIT(__BFDEV_CACHE_ALGO_RING),
+};
+
 struct bfdev_cache_node {
     bfdev_hlist_node_t hash;
     bfdev_list_head_t list;
@@ -57,6 +85,13 @@ struct bfdev_cache_node {
     unsigned long refcnt;
     const void *tag;
     void *data;
+
+    /* expiry timer */
+    bfdev_list_head_t timer;
+    bfdev_time_t expire;
+
+    /* weighted capacity */
+    unsigned long cost;
 };
 
 struct bfdev_cache_head {
@@ -72,6 +107,19 @@ struct bfdev_cache_head {
     bfdev_list_head_t freed;
     bfdev_list_head_t changing;
 
+    /* hierarchical timing wheel */
+    bfdev_list_head_t *wheel;
+    BFDEV_DEFINE_BITMAP(occupied, BFDEV_CACHE_WHEEL_TOTAL);
+    bfdev_list_head_t due;
+    bfdev_list_head_t overdue;
+    bfdev_time_t clock;
+    unsigned long timers;
+
+    /* weighted capacity */
+    unsigned long budget;
+    unsigned long weight;
+    unsigned long peak;
+
     /* const settings */
     unsigned long size;
     unsigned long maxpend;
@@ -80,19 +128,23 @@ struct bfdev_cache_head {
     unsigned long flags;
     unsigned long used;
     unsigned long pending;
+    unsigned long pinned;
 
     /* state counter */
     unsigned long changed;
     unsigned long starve;
     unsigned long hits;
     unsigned long misses;
+    unsigned long expired;
 };
 
 struct bfdev_cache_algo {
     bfdev_list_head_t list;
     const char *name;
+    unsigned long flags;
 
     bool (*starving)(bfdev_cache_head_t *head);
+    void (*miss)(bfdev_cache_head_t *head, const void *tag);
     bfdev_cache_node_t *(*obtain)(bfdev_cache_head_t *head);
     void (*get)(bfdev_cache_head_t *head, bfdev_cache_node_t *node);
     void (*put)(bfdev_cache_head_t *head, bfdev_cache_node_t *node);
@@ -109,6 +161,17 @@ struct bfdev_cache_ops {
     long (*find)(const void *node, const void *tag, void *pdata);
 };
 
+struct bfdev_cache_stats {
+    unsigned long used;
+    unsigned long changed;
+    unsigned long starve;
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long expired;
+    unsigned long weight;
+    unsigned long peak;
+};
+
 BFDEV_BITFLAGS(
     bfdev_cache_change,
     __BFDEV_CACHE_CHANGE
@@ -191,6 +254,72 @@ bfdev_cache_set(bfdev_cache_head_t *head, bfdev_cache_node_t *node,
 extern void
 bfdev_cache_committed(bfdev_cache_head_t *head);
 
+/**
+ * bfdev_cache_commit() - tell cache that one pending change has been recorded.
+ * @head: the lru_cache header.
+ * @node: pending element to be committed.
+ *
+ * node status transition:
+ * BFDEV_CACHE_PENDING => BFDEV_CACHE_USING
+ */
+extern int
+bfdev_cache_commit(bfdev_cache_head_t *head, bfdev_cache_node_t *node);
+
+/**
+ * bfdev_cache_weight() - set the cost of an element.
+ * @head: the lru_cache header.
+ * @node: element to be weighed.
+ * @cost: cost charged against the budget, such as its size in bytes.
+ *
+ * Managed elements are evicted until the total cost fits the budget.
+ */
+extern int
+bfdev_cache_weight(bfdev_cache_head_t *head, bfdev_cache_node_t *node,
+                   unsigned long cost);
+
+/**
+ * bfdev_cache_budget() - limit the total cost of the cache.
+ * @head: the lru_cache header.
+ * @budget: maximum total cost, zero to only bound the element count.
+ */
+extern void
+bfdev_cache_budget(bfdev_cache_head_t *head, unsigned long budget);
+
+/**
+ * bfdev_cache_ttl() - arm the expiry timer of an element.
+ * @head: the lru_cache header.
+ * @node: element to be armed.
+ * @ttl: time to live, relative to the last bfdev_cache_expire() call.
+ *
+ * Expired managed elements are reclaimed and looked up as misses.
+ * Elements still in use are kept until their last put.
+ */
+extern int
+bfdev_cache_ttl(bfdev_cache_head_t *head, bfdev_cache_node_t *node,
+                bfdev_time_t ttl);
+
+/**
+ * bfdev_cache_persist() - disarm the expiry timer of an element.
+ * @head: the lru_cache header.
+ * @node: element to be disarmed.
+ */
+extern void
+bfdev_cache_persist(bfdev_cache_head_t *head, bfdev_cache_node_t *node);
+
+/**
+ * bfdev_cache_expire() - advance the timing wheel and reclaim expired elements.
+ * @head: the lru_cache header.
+ * @now: current time, in wheel ticks.
+ *
+ * The clock jumps from one occupied slot to the next, so the cost
+ * follows the timers fired rather than the ticks elapsed. Elements
+ * still in use are left aside and reclaimed on their last put.
+ *
+ * Return the number of reclaimed elements.
+ */
+extern unsigned long
+bfdev_cache_expire(bfdev_cache_head_t *head, bfdev_time_t now);
+
 extern void
 bfdev_cache_reset(bfdev_cache_head_t *head);
 
@@ -202,6 +331,19 @@ bfdev_cache_create(const char *name, const bfdev_alloc_t *alloc,
 extern void
 bfdev_cache_destroy(bfdev_cache_head_t *head);
 
+static inline void
+bfdev_cache_stats(bfdev_cache_head_t *head, bfdev_cache_stats_t *stats)
+{
+    stats->used = head->used;
+    stats->changed = head->changed;
+    stats->starve = head->starve;
+    stats->hits = head->hits;
+    stats->misses = head->misses;
+    stats->expired = head->expired;
+    stats->weight = head->weight;
+    stats->peak = head->peak;
+}
+
 static inline bfdev_cache_node_t *
 bfdev_cache_get(bfdev_cache_head_t *head, const void *tag)
 {
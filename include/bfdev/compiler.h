@@ -31,6 +31,15 @@ BFDEV_BEGIN_DECLS
 # define bfdev_barrier_data(ptr) __bfdev_barrier(:"r"(ptr))
 #endif
 
+/*
+ * Prefetch a cache line for read or write access,
+ * these are only hints and never fault.
+ */
+#ifndef bfdev_prefetch
+# define bfdev_prefetch(ptr) __builtin_prefetch(ptr, 0)
+# define bfdev_prefetchw(ptr) __builtin_prefetch(ptr, 1)
+#endif
+
 /*
  * Whether 'type' is a signed type or an unsigned type.
  * Supports scalar types, bool and also pointer types.
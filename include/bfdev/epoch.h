@@ -0,0 +1,119 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_EPOCH_H_
+#define _BFDEV_EPOCH_H_
+
+#include <bfdev/config.h>
+#include <bfdev/types.h>
+#include <bfdev/list.h>
+#include <bfdev/atomic.h>
+#include <bfdev/barrier.h>
+#include <bfdev/spinlock.h>
+
+BFDEV_BEGIN_DECLS
+
+typedef struct bfdev_epoch bfdev_epoch_t;
+typedef struct bfdev_epoch_reader bfdev_epoch_reader_t;
+
+/**
+ * struct bfdev_epoch - epoch based grace period domain.
+ * @epoch: global epoch, advanced by two on each synchronize.
+ * @lock: protects the reader list.
+ * @readers: registered reader list.
+ */
+struct bfdev_epoch {
+    bfdev_atomic_t epoch;
+    bfdev_spinlock_t lock;
+    bfdev_list_head_t readers;
+};
+
+/**
+ * struct bfdev_epoch_reader - per thread reader state.
+ * @state: zero when quiescent, otherwise entered epoch with bit0 set.
+ */
+struct bfdev_epoch_reader {
+    bfdev_atomic_t state;
+    bfdev_list_head_t list;
+};
+
+#define BFDEV_EPOCH_STATIC(HEAD) { \
+    .epoch = 0, .lock = BFDEV_SPINLOCK_STATIC, \
+    .readers = BFDEV_LIST_HEAD_STATIC(&(HEAD).readers), \
+}
+
+#define BFDEV_EPOCH_INIT(head) \
+    (bfdev_epoch_t) BFDEV_EPOCH_STATIC(head)
+
+#define BFDEV_DEFINE_EPOCH(name) \
+    bfdev_epoch_t name = BFDEV_EPOCH_INIT(name)
+
+static inline void
+bfdev_epoch_init(bfdev_epoch_t *epoch)
+{
+    *epoch = BFDEV_EPOCH_INIT(*epoch);
+}
+
+/**
+ * bfdev_epoch_enter() - enter a read-side critical section.
+ * @epoch: epoch domain.
+ * @reader: reader registered to @epoch.
+ *
+ * Objects reachable from the protected structure stay valid until the
+ * matching bfdev_epoch_exit(). Sections do not nest.
+ */
+static inline void
+bfdev_epoch_enter(bfdev_epoch_t *epoch, bfdev_epoch_reader_t *reader)
+{
+    bfdev_atomic_t value;
+
+    value = bfdev_atomic_read(&epoch->epoch);
+    bfdev_atomic_write(&reader->state, value | 1);
+
+    /* Publish state before touching any shared pointer */
+    bfdev_mb();
+}
+
+/**
+ * bfdev_epoch_exit() - leave a read-side critical section.
+ * @epoch: epoch domain.
+ * @reader: reader registered to @epoch.
+ */
+static inline void
+bfdev_epoch_exit(bfdev_epoch_t *epoch, bfdev_epoch_reader_t *reader)
+{
+    bfdev_store_release(&reader->state, 0);
+}
+
+/**
+ * bfdev_epoch_register() - register a reader to epoch domain.
+ * @epoch: epoch domain.
+ * @reader: reader to register.
+ */
+extern void
+bfdev_epoch_register(bfdev_epoch_t *epoch, bfdev_epoch_reader_t *reader);
+
+/**
+ * bfdev_epoch_unregister() - unregister a reader from epoch domain.
+ * @epoch: epoch domain.
+ * @reader: reader to unregister, must be quiescent.
+ */
+extern void
+bfdev_epoch_unregister(bfdev_epoch_t *epoch, bfdev_epoch_reader_t *reader);
+
+/**
+ * bfdev_epoch_synchronize() - wait for a grace period.
+ * @epoch: epoch domain.
+ *
+ * Return once every read-side critical section that was in progress
+ * at the time of the call has finished. Objects unlinked before the
+ * call may be freed afterwards.
+ */
+extern void
+bfdev_epoch_synchronize(bfdev_epoch_t *epoch);
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_EPOCH_H_ */
@@ -0,0 +1,115 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_FIFO_MPMC_H_
+#define _BFDEV_FIFO_MPMC_H_
+
+#include <bfdev/config.h>
+#include <bfdev/types.h>
+#include <bfdev/stddef.h>
+#include <bfdev/errno.h>
+#include <bfdev/barrier.h>
+#include <bfdev/allocator.h>
+
+BFDEV_BEGIN_DECLS
+
+typedef struct bfdev_fifo_mpmc bfdev_fifo_mpmc_t;
+
+/**
+ * struct bfdev_fifo_mpmc - bounded multi producer multi consumer fifo.
+ * @stride: bytes per slot, sequence number then element.
+ * @enqueue: next position to claim for producers.
+ * @dequeue: next position to claim for consumers.
+ *
+ * Every slot carries a sequence number telling which lap may use it
+ * next, so producers and consumers only race on their own index.
+ */
+struct bfdev_fifo_mpmc {
+    const bfdev_alloc_t *alloc;
+    unsigned long mask;
+    unsigned long esize;
+    unsigned long stride;
+    void *slots;
+
+    bfdev_atomic_t enqueue __bfdev_cacheline_aligned;
+    bfdev_atomic_t dequeue __bfdev_cacheline_aligned;
+};
+
+/**
+ * bfdev_fifo_mpmc_size() - get the size of the fifo in elements.
+ * @mpmc: the fifo to get size.
+ */
+static inline unsigned long
+bfdev_fifo_mpmc_size(bfdev_fifo_mpmc_t *mpmc)
+{
+    return mpmc->mask + 1;
+}
+
+/**
+ * bfdev_fifo_mpmc_in() - enqueue a batch of elements.
+ * @mpmc: the fifo to copy data in.
+ * @buff: the elements to copy.
+ * @len: number of elements.
+ *
+ * Claims up to @len consecutive free slots at once.
+ * Returns the number of elements enqueued, zero when full.
+ */
+extern unsigned long
+bfdev_fifo_mpmc_in(bfdev_fifo_mpmc_t *mpmc, const void *buff, unsigned long len);
+
+/**
+ * bfdev_fifo_mpmc_out() - dequeue a batch of elements.
+ * @mpmc: the fifo to copy data out.
+ * @buff: the buffer to copy elements in.
+ * @len: maximum number of elements.
+ *
+ * Returns the number of elements dequeued, zero when empty.
+ */
+extern unsigned long
+bfdev_fifo_mpmc_out(bfdev_fifo_mpmc_t *mpmc, void *buff, unsigned long len);
+
+/**
+ * bfdev_fifo_mpmc_put() - enqueue one element.
+ * @mpmc: the fifo to copy data in.
+ * @value: the element to copy.
+ */
+static inline bool
+bfdev_fifo_mpmc_put(bfdev_fifo_mpmc_t *mpmc, const void *value)
+{
+    return bfdev_fifo_mpmc_in(mpmc, value, 1);
+}
+
+/**
+ * bfdev_fifo_mpmc_get() - dequeue one element.
+ * @mpmc: the fifo to copy data out.
+ * @value: the buffer to copy the element in.
+ */
+static inline bool
+bfdev_fifo_mpmc_get(bfdev_fifo_mpmc_t *mpmc, void *value)
+{
+    return bfdev_fifo_mpmc_out(mpmc, value, 1);
+}
+
+/**
+ * bfdev_fifo_mpmc_alloc() - initialize a fifo with allocated slots.
+ * @mpmc: the fifo to initialize.
+ * @alloc: allocator of the slots.
+ * @esize: element size.
+ * @size: number of elements, rounded up to a power of two.
+ */
+extern int
+bfdev_fifo_mpmc_alloc(bfdev_fifo_mpmc_t *mpmc, const bfdev_alloc_t *alloc,
+                      size_t esize, size_t size);
+
+/**
+ * bfdev_fifo_mpmc_free() - free the slots of a fifo.
+ * @mpmc: the fifo to free.
+ */
+extern void
+bfdev_fifo_mpmc_free(bfdev_fifo_mpmc_t *mpmc);
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_FIFO_MPMC_H_ */
@@ -0,0 +1,122 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_FIFO_SPSC_H_
+#define _BFDEV_FIFO_SPSC_H_
+
+#include <bfdev/config.h>
+#include <bfdev/types.h>
+#include <bfdev/stddef.h>
+#include <bfdev/errno.h>
+#include <bfdev/barrier.h>
+#include <bfdev/allocator.h>
+
+BFDEV_BEGIN_DECLS
+
+typedef struct bfdev_fifo_spsc bfdev_fifo_spsc_t;
+
+/**
+ * struct bfdev_fifo_spsc - single producer single consumer fifo.
+ * @owned: storage came from bfdev_fifo_spsc_alloc().
+ * @in: producer index, written by the producer only.
+ * @cached_out: producer copy of @out, refreshed when the fifo looks full.
+ * @out: consumer index, written by the consumer only.
+ * @cached_in: consumer copy of @in, refreshed when the fifo looks empty.
+ *
+ * Each side owns its own cacheline, so the two cores only exchange
+ * lines when a cached index runs out.
+ */
+struct bfdev_fifo_spsc {
+    const bfdev_alloc_t *alloc;
+    unsigned long mask;
+    unsigned long esize;
+    void *data;
+    bool owned;
+
+    unsigned long in __bfdev_cacheline_aligned;
+    unsigned long cached_out;
+
+    unsigned long out __bfdev_cacheline_aligned;
+    unsigned long cached_in;
+};
+
+/**
+ * bfdev_fifo_spsc_size() - get the size of the fifo in elements.
+ * @spsc: the fifo to get size.
+ */
+static inline unsigned long
+bfdev_fifo_spsc_size(bfdev_fifo_spsc_t *spsc)
+{
+    return spsc->mask + 1;
+}
+
+/**
+ * bfdev_fifo_spsc_len() - get the number of elements queued.
+ * @spsc: the fifo to get.
+ *
+ * Only a snapshot when called concurrently with the other side.
+ */
+static inline unsigned long
+bfdev_fifo_spsc_len(bfdev_fifo_spsc_t *spsc)
+{
+    return bfdev_load_acquire(&spsc->in) - bfdev_load_acquire(&spsc->out);
+}
+
+/**
+ * bfdev_fifo_spsc_in() - enqueue a batch of elements.
+ * @spsc: the fifo to copy data in.
+ * @buff: the elements to copy.
+ * @len: number of elements.
+ *
+ * Producer side only. Returns the number of elements enqueued.
+ */
+extern unsigned long
+bfdev_fifo_spsc_in(bfdev_fifo_spsc_t *spsc, const void *buff, unsigned long len);
+
+/**
+ * bfdev_fifo_spsc_out() - dequeue a batch of elements.
+ * @spsc: the fifo to copy data out.
+ * @buff: the buffer to copy elements in.
+ * @len: maximum number of elements.
+ *
+ * Consumer side only. Returns the number of elements dequeued.
+ */
+extern unsigned long
+bfdev_fifo_spsc_out(bfdev_fifo_spsc_t *spsc, void *buff, unsigned long len);
+
+/**
+ * bfdev_fifo_spsc_init() - initialize a fifo over a caller buffer.
+ * @spsc: the fifo to initialize.
+ * @buffer: element storage.
+ * @esize: element size.
+ * @size: number of elements, power of two.
+ */
+extern int
+bfdev_fifo_spsc_init(bfdev_fifo_spsc_t *spsc, void *buffer,
+                     size_t esize, size_t size);
+
+/**
+ * bfdev_fifo_spsc_alloc() - initialize a fifo with allocated storage.
+ * @spsc: the fifo to initialize.
+ * @alloc: allocator of the storage.
+ * @esize: element size.
+ * @size: number of elements, rounded up to a power of two.
+ */
+extern int
+bfdev_fifo_spsc_alloc(bfdev_fifo_spsc_t *spsc, const bfdev_alloc_t *alloc,
+                      size_t esize, size_t size);
+
+/**
+ * bfdev_fifo_spsc_free() - free the storage of an allocated fifo.
+ * @spsc: the fifo to free.
+ *
+ * Caller buffers passed to bfdev_fifo_spsc_init() are left alone.
+ */
+extern void
+bfdev_fifo_spsc_free(bfdev_fifo_spsc_t *spsc);
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_FIFO_SPSC_H_ */
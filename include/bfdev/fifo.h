@@ -10,6 +10,7 @@
 #include <bfdev/macro.h>
 #include <bfdev/errno.h>
 #include <bfdev/allocator.h>
+#include <bfdev/span.h>
 
 BFDEV_BEGIN_DECLS
 
@@ -22,6 +23,7 @@ struct bfdev_fifo {
     unsigned long mask;
     unsigned long esize;
     void *data;
+    bool mirror;
 };
 
 /**
@@ -284,6 +286,22 @@ struct bfdev_fifo {
     -BFDEV_EINVAL;                              \
 })
 
+/**
+ * bfdev_fifo_alloc_mirror() - allocate a mirrored buffer to fifo.
+ * @ptr: the fifo to allocate buffer.
+ * @size: size of buffer, rounded up to whole pages.
+ *
+ * The buffer is mapped twice back to back, so spans and records
+ * never wrap. Released by bfdev_fifo_free().
+ */
+#define bfdev_fifo_alloc_mirror(ptr, size) ({   \
+    typeof((ptr) + 1) __tmp = (ptr);            \
+    bfdev_fifo_check_dynamic(__tmp) ?           \
+    bfdev_fifo_mirror_alloc(&__tmp->fifo,       \
+    sizeof(*__tmp->data), size) :               \
+    -BFDEV_EINVAL;                              \
+})
+
 /**
  * bfdev_fifo_free() - dynamically free buffer to fifo.
  * @ptr: the fifo to free buffer.
@@ -429,6 +447,64 @@ struct bfdev_fifo {
     bfdev_fifo_in_flat(__fifo, __tbuff, __tlen);                    \
 })
 
+/**
+ * bfdev_fifo_reserve() - reserve free space to write in place.
+ * @pfifo: the fifo to reserve space in.
+ * @span: two spans receiving the reserved space.
+ * @len: maximum number of objects.
+ *
+ * Returns the number of objects reserved, make them visible with
+ * bfdev_fifo_commit(). Only for fifos without records.
+ */
+#define bfdev_fifo_reserve(pfifo, span, len) ({                     \
+    typeof((pfifo) + 1) __tmp = (pfifo);                            \
+    bfdev_fifo_reserve_flat(&__tmp->fifo, span, len);               \
+})
+
+/**
+ * bfdev_fifo_commit() - publish objects written into reserved space.
+ * @pfifo: the fifo to commit.
+ * @len: number of objects written.
+ */
+#define bfdev_fifo_commit(pfifo, len) ({                            \
+    typeof((pfifo) + 1) __tmp = (pfifo);                            \
+    bfdev_fifo_commit_flat(&__tmp->fifo, len);                      \
+})
+
+/**
+ * bfdev_fifo_peek_span() - expose valid data to read in place.
+ * @pfifo: the fifo to peek.
+ * @span: two spans receiving the valid data.
+ * @len: maximum number of objects.
+ *
+ * Returns the number of objects exposed, release them with
+ * bfdev_fifo_consume(). Record fifos expose the next record.
+ */
+#define bfdev_fifo_peek_span(pfifo, span, len) ({                   \
+    typeof((pfifo) + 1) __tmp = (pfifo);                            \
+    bfdev_fifo_t *__fifo = &__tmp->fifo;                            \
+    unsigned long __tlen = (len);                                   \
+    unsigned long __recsize = sizeof(*__tmp->rectype);              \
+    (__recsize) ?                                                   \
+    bfdev_fifo_peek_span_record(__fifo, span, __tlen, __recsize) :  \
+    bfdev_fifo_peek_span_flat(__fifo, span, __tlen);                \
+})
+
+/**
+ * bfdev_fifo_consume() - release objects read in place.
+ * @pfifo: the fifo to consume.
+ * @len: number of objects read, record fifos drop the whole record.
+ */
+#define bfdev_fifo_consume(pfifo, len) ({                           \
+    typeof((pfifo) + 1) __tmp = (pfifo);                            \
+    bfdev_fifo_t *__fifo = &__tmp->fifo;                            \
+    unsigned long __tlen = (len);                                   \
+    unsigned long __recsize = sizeof(*__tmp->rectype);              \
+    (__recsize) ?                                                   \
+    bfdev_fifo_consume_record(__fifo, __recsize) :                  \
+    bfdev_fifo_consume_flat(__fifo, __tlen);                        \
+})
+
 extern unsigned long
 bfdev_fifo_peek_flat(bfdev_fifo_t *fifo, void *buff, unsigned long len);
 
@@ -438,6 +514,18 @@ bfdev_fifo_out_flat(bfdev_fifo_t *fifo, void *buff, unsigned long len);
 extern unsigned long
 bfdev_fifo_in_flat(bfdev_fifo_t *fifo, const void *buff, unsigned long len);
 
+extern unsigned long
+bfdev_fifo_reserve_flat(bfdev_fifo_t *fifo, bfdev_span_t *span, unsigned long len);
+
+extern unsigned long
+bfdev_fifo_commit_flat(bfdev_fifo_t *fifo, unsigned long len);
+
+extern unsigned long
+bfdev_fifo_peek_span_flat(bfdev_fifo_t *fifo, bfdev_span_t *span, unsigned long len);
+
+extern unsigned long
+bfdev_fifo_consume_flat(bfdev_fifo_t *fifo, unsigned long len);
+
 extern unsigned long
 bfdev_fifo_peek_record(bfdev_fifo_t *fifo, void *buff, unsigned long len,
                        unsigned long record);
@@ -450,10 +538,20 @@ extern unsigned long
 bfdev_fifo_in_record(bfdev_fifo_t *fifo, const void *buff, unsigned long len,
                      unsigned long record);
 
+extern unsigned long
+bfdev_fifo_peek_span_record(bfdev_fifo_t *fifo, bfdev_span_t *span, unsigned long len,
+                            unsigned long record);
+
+extern unsigned long
+bfdev_fifo_consume_record(bfdev_fifo_t *fifo, unsigned long record);
+
 extern int
 bfdev_fifo_dynamic_alloc(bfdev_fifo_t *fifo, const bfdev_alloc_t *alloc,
                          size_t esize, size_t size);
 
+extern int
+bfdev_fifo_mirror_alloc(bfdev_fifo_t *fifo, size_t esize, size_t size);
+
 extern void
 bfdev_fifo_dynamic_free(bfdev_fifo_t *fifo);
 
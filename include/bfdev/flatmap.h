@@ -0,0 +1,187 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_FLATMAP_H_
+#define _BFDEV_FLATMAP_H_
+
+#include <bfdev/config.h>
+#include <bfdev/types.h>
+#include <bfdev/errno.h>
+#include <bfdev/hashmap.h>
+#include <bfdev/allocator.h>
+
+BFDEV_BEGIN_DECLS
+
+#ifndef BFDEV_FLATMAP_MIN_BITS
+# define BFDEV_FLATMAP_MIN_BITS 4
+#endif
+
+/* Number of control bytes probed at once */
+#define BFDEV_FLATMAP_GROUP 16
+
+/*
+ * Control byte layout:
+ *   0b0xxxxxxx: full, low 7 bits are the H2 tag of the hash.
+ *   0b10000000: empty, terminates probe sequences.
+ *   0b11111110: deleted, probe sequences continue past it.
+ */
+#define BFDEV_FLATMAP_EMPTY 0x80
+#define BFDEV_FLATMAP_DELETED 0xfe
+
+typedef struct bfdev_flatmap bfdev_flatmap_t;
+typedef struct bfdev_flatmap_ops bfdev_flatmap_ops_t;
+
+/**
+ * struct bfdev_flatmap - open addressing hash map.
+ * @ctrls: control bytes, followed by a clone of the first group.
+ * @slots: pointers to the user objects.
+ * @bits: log2 of the number of slots.
+ * @capacity: number of slots.
+ * @used: number of stored objects.
+ * @growth: number of empty slots that can still be filled before rehash.
+ */
+struct bfdev_flatmap {
+    uint8_t *ctrls;
+    void **slots;
+    unsigned int bits;
+    unsigned long capacity;
+    unsigned long used;
+    unsigned long growth;
+
+    const bfdev_alloc_t *alloc;
+    const bfdev_flatmap_ops_t *ops;
+    void *pdata;
+};
+
+struct bfdev_flatmap_ops {
+    unsigned long (*hash_key)(const void *key, void *pdata);
+    unsigned long (*hash_node)(const void *node, void *pdata);
+    long (*equal)(const void *node1, const void *node2, void *pdata);
+    long (*find)(const void *node, const void *key, void *pdata);
+};
+
+#define BFDEV_FLATMAP_STATIC(ALLOC, OPS, PDATA) { \
+    .alloc = (ALLOC), .ops = (OPS), .pdata = (PDATA), \
+}
+
+#define BFDEV_FLATMAP_INIT(alloc, ops, pdata) \
+    (bfdev_flatmap_t) BFDEV_FLATMAP_STATIC(alloc, ops, pdata)
+
+#define BFDEV_DEFINE_FLATMAP(name, alloc, ops, pdata) \
+    bfdev_flatmap_t name = BFDEV_FLATMAP_INIT(alloc, ops, pdata)
+
+/**
+ * bfdev_flatmap_init() - initialize a flatmap structure.
+ * @flatmap: flatmap structure to be initialized.
+ * @alloc: allocator operations.
+ * @ops: flatmap operations.
+ * @pdata: operations callback data.
+ */
+static inline void
+bfdev_flatmap_init(bfdev_flatmap_t *flatmap, const bfdev_alloc_t *alloc,
+                   const bfdev_flatmap_ops_t *ops, void *pdata)
+{
+    *flatmap = BFDEV_FLATMAP_INIT(alloc, ops, pdata);
+}
+
+/**
+ * bfdev_flatmap_slot() - get the object stored in a slot.
+ * @flatmap: flatmap structure to be read.
+ * @index: slot index.
+ *
+ * Return NULL if the slot is empty or deleted.
+ */
+static inline void *
+bfdev_flatmap_slot(const bfdev_flatmap_t *flatmap, unsigned long index)
+{
+    if (flatmap->ctrls[index] & BFDEV_FLATMAP_EMPTY)
+        return NULL;
+
+    return flatmap->slots[index];
+}
+
+/**
+ * bfdev_flatmap_insert() - insert an object to flatmap.
+ * @flatmap: flatmap structure to be insert.
+ * @node: new object to insert.
+ * @old: pointer used to return the replaced object.
+ * @strategy: insertion strategy.
+ */
+extern int
+bfdev_flatmap_insert(bfdev_flatmap_t *flatmap, void *node, void **old,
+                     bfdev_hashmap_strategy_t strategy);
+
+/**
+ * bfdev_flatmap_del() - delete an object from flatmap.
+ * @flatmap: flatmap structure to be delete.
+ * @key: key of the object to be deleted.
+ * @node: pointer used to return the deleted object.
+ */
+extern int
+bfdev_flatmap_del(bfdev_flatmap_t *flatmap, const void *key, void **node);
+
+/**
+ * bfdev_flatmap_find() - find an object in flatmap.
+ * @flatmap: flatmap structure to be find.
+ * @key: key of the object to be find.
+ */
+extern void *
+bfdev_flatmap_find(bfdev_flatmap_t *flatmap, const void *key);
+
+/**
+ * bfdev_flatmap_reserve() - make room for objects without rehash.
+ * @flatmap: flatmap structure to be reserve.
+ * @count: number of objects expected.
+ */
+extern int
+bfdev_flatmap_reserve(bfdev_flatmap_t *flatmap, unsigned long count);
+
+/**
+ * bfdev_flatmap_release() - release slots in flatmap.
+ * @flatmap: flatmap structure to be release.
+ */
+extern void
+bfdev_flatmap_release(bfdev_flatmap_t *flatmap);
+
+static __bfdev_always_inline int
+bfdev_flatmap_add(bfdev_flatmap_t *flatmap, void *node)
+{
+    return bfdev_flatmap_insert(flatmap, node, NULL, BFDEV_HASHMAP_ADD);
+}
+
+static __bfdev_always_inline int
+bfdev_flatmap_set(bfdev_flatmap_t *flatmap, void *node, void **old)
+{
+    return bfdev_flatmap_insert(flatmap, node, old, BFDEV_HASHMAP_SET);
+}
+
+static __bfdev_always_inline int
+bfdev_flatmap_update(bfdev_flatmap_t *flatmap, void *node, void **old)
+{
+    return bfdev_flatmap_insert(flatmap, node, old, BFDEV_HASHMAP_UPDATE);
+}
+
+static __bfdev_always_inline int
+bfdev_flatmap_append(bfdev_flatmap_t *flatmap, void *node)
+{
+    return bfdev_flatmap_insert(flatmap, node, NULL, BFDEV_HASHMAP_APPEND);
+}
+
+/**
+ * bfdev_flatmap_for_each - iterate over a flatmap.
+ * @pos: the object pointer to use as a loop cursor.
+ * @flatmap: the flatmap to iterate.
+ * @index: index temporary storage.
+ *
+ * Deleting @pos inside the loop is allowed, objects never move
+ * until the next insertion.
+ */
+#define bfdev_flatmap_for_each(pos, flatmap, index) \
+    for ((index) = 0; (index) < (flatmap)->capacity; ++(index)) \
+        if (!((pos) = bfdev_flatmap_slot(flatmap, index))) {} else
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_FLATMAP_H_ */
@@ -10,6 +10,7 @@
 #include <bfdev/errno.h>
 #include <bfdev/hashtbl.h>
 #include <bfdev/allocator.h>
+#include <bfdev/bitflags.h>
 
 BFDEV_BEGIN_DECLS
 
@@ -17,9 +18,19 @@ BFDEV_BEGIN_DECLS
 # define BFDEV_HASHMAP_MIN_BITS 4
 #endif
 
+#ifndef BFDEV_HASHMAP_BATCH
+# define BFDEV_HASHMAP_BATCH 16
+#endif
+
+#ifndef BFDEV_HASHMAP_MIGRATE_STEP
+# define BFDEV_HASHMAP_MIGRATE_STEP 4
+#endif
+
 typedef struct bfdev_hashmap bfdev_hashmap_t;
+typedef struct bfdev_hashmap_node bfdev_hashmap_node_t;
 typedef struct bfdev_hashmap_ops bfdev_hashmap_ops_t;
 typedef enum bfdev_hashmap_strategy bfdev_hashmap_strategy_t;
+typedef enum bfdev_hashmap_flags bfdev_hashmap_flags_t;
 
 /**
  * enum bfdev_hashmap_strategy - Hashmap insertion strategy.
@@ -35,17 +46,64 @@ enum bfdev_hashmap_strategy {
     BFDEV_HASHMAP_APPEND,
 };
 
+/**
+ * enum bfdev_hashmap_flags - Hashmap behavior flags.
+ * @HASHMAP_INCREMENTAL: spread rehash over subsequent operations.
+ * @HASHMAP_CACHED: nodes are embedded in bfdev_hashmap_node_t.
+ */
+enum bfdev_hashmap_flags {
+    __BFDEV_HASHMAP_INCREMENTAL = 0,
+    __BFDEV_HASHMAP_CACHED,
+
+    BFDEV_HASHMAP_INCREMENTAL = BFDEV_BIT(__BFDEV_HASHMAP_INCREMENTAL),
+    BFDEV_HASHMAP_CACHED = BFDEV_BIT(__BFDEV_HASHMAP_CACHED),
+};
+
+/**
+ * struct bfdev_hashmap - hash map with chained buckets.
+ * @buckets: current bucket array.
+ * @obuckets: previous bucket array still being migrated.
+ * @ocapacity: number of buckets in @obuckets.
+ * @migrate: index of the next bucket in @obuckets to migrate.
+ * @mstep: buckets migrated per operation.
+ *
+ * No resize starts while @obuckets is still being migrated, @mstep
+ * is chosen so that it drains before the next threshold.
+ */
 struct bfdev_hashmap {
     bfdev_hlist_head_t *buckets;
     unsigned int bits;
     unsigned long capacity;
     unsigned long used;
+    unsigned long flags;
+
+    bfdev_hlist_head_t *obuckets;
+    unsigned long ocapacity;
+    unsigned long migrate;
+    unsigned long mstep;
 
     const bfdev_alloc_t *alloc;
     const bfdev_hashmap_ops_t *ops;
     void *pdata;
 };
 
+/**
+ * struct bfdev_hashmap_node - hashlist node with cached hash.
+ * @node: hashlist node handed to the hashmap.
+ * @hash: full hash of the node, maintained by the hashmap.
+ *
+ * Used by hashmaps in cached mode: rehash re-links nodes without
+ * calling hash_node, and chain walks only call the comparators when
+ * the hash words match.
+ */
+struct bfdev_hashmap_node {
+    bfdev_hlist_node_t node;
+    unsigned long hash;
+};
+
+#define bfdev_hashmap_node_entry(ptr) \
+    bfdev_container_of(ptr, bfdev_hashmap_node_t, node)
+
 struct bfdev_hashmap_ops {
     unsigned long (*hash_key)(const void *key, void *pdata);
     unsigned long (*hash_node)(const bfdev_hlist_node_t *node, void *pdata);
@@ -56,6 +114,18 @@ struct bfdev_hashmap_ops {
     bool (*shrink)(const bfdev_hashmap_t *hashmap, void *pdata);
 };
 
+BFDEV_BITFLAGS_STRUCT(
+    bfdev_hashmap_incremental,
+    bfdev_hashmap_t, flags,
+    __BFDEV_HASHMAP_INCREMENTAL
+);
+
+BFDEV_BITFLAGS_STRUCT(
+    bfdev_hashmap_cached,
+    bfdev_hashmap_t, flags,
+    __BFDEV_HASHMAP_CACHED
+);
+
 #define BFDEV_HASHMAP_STATIC(ALLOC, OPS, PDATA) { \
     .alloc = (ALLOC), .ops = (OPS), .pdata = (PDATA), \
 }
@@ -109,6 +179,29 @@ bfdev_hashmap_del(bfdev_hashmap_t *hashmap, const void *key,
 extern bfdev_hlist_node_t *
 bfdev_hashmap_find(bfdev_hashmap_t *hashmap, const void *key);
 
+/**
+ * bfdev_hashmap_find_batch() - find a batch of hashlist nodes in hashmap.
+ * @hashmap: hashmap structure to be find.
+ * @keys: keys of the nodes to be find.
+ * @nodes: array used to return the nodes, NULL if not found.
+ * @count: number of keys.
+ *
+ * All buckets of a batch are prefetched before any chain is walked,
+ * so the cache misses of independent lookups overlap.
+ *
+ * @return: number of nodes found.
+ */
+extern unsigned int
+bfdev_hashmap_find_batch(bfdev_hashmap_t *hashmap, const void *const *keys,
+                         bfdev_hlist_node_t **nodes, unsigned int count);
+
+/**
+ * bfdev_hashmap_migrate() - finish an incremental rehash in progress.
+ * @hashmap: hashmap structure to be migrate.
+ */
+extern void
+bfdev_hashmap_migrate(bfdev_hashmap_t *hashmap);
+
 /**
  * bfdev_hashmap_release() - release hash bucket in hashmap.
  * @hashmap: hashmap structure to be release.
@@ -142,6 +235,22 @@ bfdev_hashmap_append(bfdev_hashmap_t *hashmap, bfdev_hlist_node_t *node)
     return bfdev_hashmap_insert(hashmap, node, NULL, BFDEV_HASHMAP_APPEND);
 }
 
+static inline unsigned long
+bfdev_hashmap_nbuckets(const bfdev_hashmap_t *hashmap)
+{
+    return hashmap->capacity + hashmap->ocapacity;
+}
+
+static inline bfdev_hlist_head_t *
+bfdev_hashmap_bucket(const bfdev_hashmap_t *hashmap, unsigned long index)
+{
+    if (index < hashmap->capacity)
+        return &hashmap->buckets[index];
+
+    /* Buckets of the table being migrated */
+    return &hashmap->obuckets[index - hashmap->capacity];
+}
+
 /**
  * bfdev_hashmap_for_each - iterate over a hashtable.
  * @pos: the &bfdev_hlist_node_t to use as a loop cursor.
@@ -149,8 +258,8 @@ bfdev_hashmap_append(bfdev_hashmap_t *hashmap, bfdev_hlist_node_t *node)
  * @index: index temporary storage.
  */
 #define bfdev_hashmap_for_each(pos, hashmap, index) \
-    bfdev_hashtbl_for_each(pos, (hashmap)->buckets, \
-        (hashmap)->capacity, index)
+    for ((index) = 0; (index) < bfdev_hashmap_nbuckets(hashmap); ++(index)) \
+        bfdev_hlist_for_each(pos, bfdev_hashmap_bucket(hashmap, index))
 
 /**
  * bfdev_hashmap_for_each_safe - iterate over a hashtable safe
@@ -161,8 +270,8 @@ bfdev_hashmap_append(bfdev_hashmap_t *hashmap, bfdev_hlist_node_t *node)
  * @index: index temporary storage.
  */
 #define bfdev_hashmap_for_each_safe(pos, tmp, hashmap, index) \
-    bfdev_hashtbl_for_each_safe(pos, tmp, (hashmap)->buckets, \
-        (hashmap)->capacity, index)
+    for ((index) = 0; (index) < bfdev_hashmap_nbuckets(hashmap); ++(index)) \
+        bfdev_hlist_for_each_safe(pos, tmp, bfdev_hashmap_bucket(hashmap, index))
 
 /**
  * bfdev_hashmap_for_each_entry - iterate over hashtable of given type.
@@ -172,8 +281,8 @@ bfdev_hashmap_append(bfdev_hashmap_t *hashmap, bfdev_hlist_node_t *node)
  * @index: index temporary storage.
  */
 #define bfdev_hashmap_for_each_entry(pos, hashmap, member, index) \
-    bfdev_hashtbl_for_each_entry(pos, (hashmap)->buckets, \
-        (hashmap)->capacity, member, index)
+    for ((index) = 0; (index) < bfdev_hashmap_nbuckets(hashmap); ++(index)) \
+        bfdev_hlist_for_each_entry(pos, bfdev_hashmap_bucket(hashmap, index), member)
 
 /**
  * bfdev_hashmap_for_each_entry_safe - iterate over hashtable of given type
@@ -185,8 +294,9 @@ bfdev_hashmap_append(bfdev_hashmap_t *hashmap, bfdev_hlist_node_t *node)
  * @index: index temporary storage.
  */
 #define bfdev_hashmap_for_each_entry_safe(pos, tmp, hashmap, member, index) \
-    bfdev_hashtbl_for_each_entry_safe(pos, tmp, (hashmap)->buckets, \
-        (hashmap)->capacity, member, index)
+    for ((index) = 0; (index) < bfdev_hashmap_nbuckets(hashmap); ++(index)) \
+        bfdev_hlist_for_each_entry_safe(pos, tmp, \
+            bfdev_hashmap_bucket(hashmap, index), member)
 
 BFDEV_END_DECLS
 
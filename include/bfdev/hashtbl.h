@@ -86,6 +86,42 @@ bfdev_hashtbl_add(bfdev_hlist_head_t *head, unsigned long size,
     bfdev_hlist_head_add(&head[index], node);
 }
 
+/**
+ * bfdev_hashtbl_prefetch - prefetch the bucket of a key.
+ * @head: the head for your hashtable.
+ * @size: the size of your hashtable.
+ * @key: the value of the object to be looked up.
+ *
+ * Return the bucket index, so that the caller can issue prefetches for
+ * a batch of keys before walking any of their chains.
+ */
+static inline unsigned long
+bfdev_hashtbl_prefetch(bfdev_hlist_head_t *head, unsigned long size,
+                       unsigned long key)
+{
+    unsigned long index;
+
+    index = bfdev_hashtbl_index(size, key);
+    bfdev_prefetch(&head[index]);
+
+    return index;
+}
+
+/**
+ * bfdev_hashtbl_prefetch_idx - prefetch the first node of a bucket.
+ * @head: the head for your hashtable.
+ * @index: bucket index returned by bfdev_hashtbl_prefetch().
+ */
+static inline void
+bfdev_hashtbl_prefetch_idx(bfdev_hlist_head_t *head, unsigned long index)
+{
+    bfdev_hlist_node_t *first;
+
+    first = head[index].node;
+    if (first)
+        bfdev_prefetch(first);
+}
+
 /**
  * bfdev_hashtbl_del - remove an object from a hashtable.
  * @node: &struct hlist_node of the object to remove.
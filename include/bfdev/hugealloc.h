@@ -0,0 +1,87 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_HUGEALLOC_H_
+#define _BFDEV_HUGEALLOC_H_
+
+#include <bfdev/config.h>
+#include <bfdev/types.h>
+#include <bfdev/stddef.h>
+#include <bfdev/bits.h>
+#include <bfdev/allocator.h>
+
+BFDEV_BEGIN_DECLS
+
+#ifndef BFDEV_HUGEALLOC_PAGE
+# define BFDEV_HUGEALLOC_PAGE (2UL << 20)
+#endif
+
+#ifndef BFDEV_HUGEALLOC_THRESHOLD
+# define BFDEV_HUGEALLOC_THRESHOLD (1UL << 20)
+#endif
+
+#ifndef BFDEV_HUGEALLOC_HEADER
+# define BFDEV_HUGEALLOC_HEADER (sizeof(size_t) * 2)
+#endif
+
+typedef struct bfdev_hugealloc bfdev_hugealloc_t;
+
+enum bfdev_hugealloc_flags {
+    __BFDEV_HUGEALLOC_HUGETLB = 0,
+    __BFDEV_HUGEALLOC_THP,
+
+    BFDEV_HUGEALLOC_HUGETLB = BFDEV_BIT(__BFDEV_HUGEALLOC_HUGETLB),
+    BFDEV_HUGEALLOC_THP = BFDEV_BIT(__BFDEV_HUGEALLOC_THP),
+};
+
+/**
+ * struct bfdev_hugealloc - huge page backed allocator.
+ * @alloc: wrapped allocator serving small requests.
+ * @threshold: requests from this size on are mapped.
+ * @flags: huge page strategies to try.
+ * @hugetlb: blocks backed by reserved huge pages.
+ * @mapped: blocks mapped from regular pages.
+ * @allocator: allocator interface on top of this backend.
+ */
+struct bfdev_hugealloc {
+    const bfdev_alloc_t *alloc;
+    size_t threshold;
+    unsigned long flags;
+
+    bfdev_atomic_t hugetlb;
+    bfdev_atomic_t mapped;
+
+    bfdev_alloc_ops_t ops;
+    bfdev_alloc_t allocator;
+};
+
+/**
+ * bfdev_hugealloc_init() - initialize a huge page backend.
+ * @huge: the backend to initialize.
+ * @alloc: wrapped allocator serving small requests.
+ * @threshold: requests from this size on are mapped, zero for default.
+ * @flags: huge page strategies to try.
+ *
+ * Large requests first try reserved huge pages, then regular pages
+ * aligned to the huge page size with a transparent huge page hint.
+ * Returns -BFDEV_EOPNOTSUPP when the platform cannot map memory.
+ */
+extern int
+bfdev_hugealloc_init(bfdev_hugealloc_t *huge, const bfdev_alloc_t *alloc,
+                     size_t threshold, unsigned long flags);
+
+/**
+ * bfdev_hugealloc_allocator() - allocator interface of a huge page backend.
+ * @huge: the backend to use.
+ */
+static inline const bfdev_alloc_t *
+bfdev_hugealloc_allocator(bfdev_hugealloc_t *huge)
+{
+    return &huge->allocator;
+}
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_HUGEALLOC_H_ */
@@ -8,6 +8,7 @@
 
 #include <bfdev/config.h>
 #include <bfdev/list.h>
+#include <bfdev/bits.h>
 
 BFDEV_BEGIN_DECLS
 
@@ -15,8 +16,16 @@ BFDEV_BEGIN_DECLS
 # define BFDEV_MEMALLOC_ALIGN 32
 #endif
 
+#ifndef BFDEV_MEMALLOC_TLSF_SLI
+# define BFDEV_MEMALLOC_TLSF_SLI 4
+#endif
+
+#define BFDEV_MEMALLOC_TLSF_SLN (1UL << BFDEV_MEMALLOC_TLSF_SLI)
+#define BFDEV_MEMALLOC_TLSF_FLN (BFDEV_BITS_PER_LONG - BFDEV_MEMALLOC_TLSF_SLI + 1)
+
 typedef struct bfdev_memalloc_head bfdev_memalloc_head_t;
 typedef struct bfdev_memalloc_chunk bfdev_memalloc_chunk_t;
+typedef struct bfdev_memalloc_tlsf bfdev_memalloc_tlsf_t;
 
 typedef bfdev_memalloc_chunk_t *
 (*bfdev_memalloc_find_t)(bfdev_memalloc_head_t *head, size_t size);
@@ -26,6 +35,9 @@ struct bfdev_memalloc_head {
     bfdev_list_head_t free_list;
     bfdev_memalloc_find_t find;
     size_t avail;
+
+    /* embedded in a bfdev_memalloc_tlsf_t */
+    bool tlsf;
 };
 
 struct bfdev_memalloc_chunk {
@@ -35,6 +47,20 @@ struct bfdev_memalloc_chunk {
     char data[0];
 };
 
+/**
+ * struct bfdev_memalloc_tlsf - two-level segregated fit memalloc.
+ * @head: generic memalloc, whose free_list stays empty.
+ * @fl_bitmap: first level classes holding free chunks.
+ * @sl_bitmap: second level classes holding free chunks.
+ * @bins: free chunks of each class.
+ */
+struct bfdev_memalloc_tlsf {
+    bfdev_memalloc_head_t head;
+    unsigned long fl_bitmap;
+    unsigned long sl_bitmap[BFDEV_MEMALLOC_TLSF_FLN];
+    bfdev_list_head_t bins[BFDEV_MEMALLOC_TLSF_FLN][BFDEV_MEMALLOC_TLSF_SLN];
+};
+
 /**
  * bfdev_memalloc_first_fit() - first qualified node.
  * @head: memalloc to get node.
@@ -59,6 +85,17 @@ bfdev_memalloc_best_fit(bfdev_memalloc_head_t *head, size_t size);
 extern bfdev_memalloc_chunk_t *
 bfdev_memalloc_worst_fit(bfdev_memalloc_head_t *head, size_t size);
 
+/**
+ * bfdev_memalloc_tlsf() - good fit node in constant time.
+ * @head: memalloc to get node.
+ * @size: size to get.
+ *
+ * Only valid on a memalloc set up by bfdev_memalloc_tlsf_init(),
+ * any other memalloc finds nothing.
+ */
+extern bfdev_memalloc_chunk_t *
+bfdev_memalloc_tlsf(bfdev_memalloc_head_t *head, size_t size);
+
 /**
  * bfdev_memalloc_alloc() - memory allocator allocation.
  * @head: memalloc to operate.
@@ -90,11 +127,23 @@ bfdev_memalloc_realloc(bfdev_memalloc_head_t *head, void *block, size_t resize);
  * @find: memalloc allocator algorithm.
  * @memory: memalloc memory address.
  * @size: memalloc memory size.
+ *
+ * Use bfdev_memalloc_tlsf_init() for bfdev_memalloc_tlsf(), a plain
+ * head has no room for its bins.
  */
 extern void
 bfdev_memalloc_init(bfdev_memalloc_head_t *head, bfdev_memalloc_find_t find,
                     void *memory, size_t size);
 
+/**
+ * bfdev_memalloc_tlsf_init() - two-level segregated fit memalloc setup.
+ * @tlsf: memalloc to operate.
+ * @memory: memalloc memory address.
+ * @size: memalloc memory size.
+ */
+extern void
+bfdev_memalloc_tlsf_init(bfdev_memalloc_tlsf_t *tlsf, void *memory, size_t size);
+
 BFDEV_END_DECLS
 
 #endif /* _BFDEV_MEMALLOC_H_ */
@@ -0,0 +1,46 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_MIRROR_H_
+#define _BFDEV_MIRROR_H_
+
+#include <bfdev/config.h>
+#include <bfdev/types.h>
+#include <bfdev/stddef.h>
+#include <bfdev/errno.h>
+
+BFDEV_BEGIN_DECLS
+
+/**
+ * bfdev_mirror_granule() - get the size granule of mirrored buffers.
+ *
+ * Returns the page size, or zero when mirroring is not supported.
+ */
+extern size_t
+bfdev_mirror_granule(void);
+
+/**
+ * bfdev_mirror_map() - map a mirrored buffer.
+ * @datap: receives the start of the buffer.
+ * @size: buffer size, a multiple of bfdev_mirror_granule().
+ *
+ * The same memory is mapped twice back to back, so any range of up
+ * to @size bytes starting inside the buffer is contiguous, even when
+ * it wraps around the end.
+ */
+extern int
+bfdev_mirror_map(void **datap, size_t size);
+
+/**
+ * bfdev_mirror_unmap() - unmap a mirrored buffer.
+ * @data: the start of the buffer.
+ * @size: buffer size passed to bfdev_mirror_map().
+ */
+extern void
+bfdev_mirror_unmap(void *data, size_t size);
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_MIRROR_H_ */
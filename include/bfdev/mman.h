@@ -0,0 +1,16 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_MMAN_H_
+#define _BFDEV_MMAN_H_
+
+#include <bfdev/config.h>
+#include <bfdev/port/mman.h>
+
+BFDEV_BEGIN_DECLS
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_MMAN_H_ */
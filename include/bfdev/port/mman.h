@@ -0,0 +1,194 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_PORT_MMAN_H_
+#define _BFDEV_PORT_MMAN_H_
+
+#include <bfdev/config.h>
+
+#if defined(BFDEV_HAVE_MMAN)
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# if defined(__linux__)
+#  include <sys/syscall.h>
+#  include <linux/memfd.h>
+# endif
+#else
+# include <stddef.h>
+#endif
+
+BFDEV_BEGIN_DECLS
+
+#ifndef BFDEV_HAVE_MMAN
+/* Let callers build anyway, every mapping fails */
+# ifndef MAP_FAILED
+#  define MAP_FAILED ((void *)-1)
+# endif
+# ifndef PROT_NONE
+#  define PROT_NONE 0
+# endif
+# ifndef PROT_READ
+#  define PROT_READ 1
+# endif
+# ifndef PROT_WRITE
+#  define PROT_WRITE 2
+# endif
+# ifndef MAP_SHARED
+#  define MAP_SHARED 1
+# endif
+# ifndef MAP_PRIVATE
+#  define MAP_PRIVATE 2
+# endif
+# ifndef MAP_FIXED
+#  define MAP_FIXED 0x10
+# endif
+# ifndef MAP_ANONYMOUS
+#  define MAP_ANONYMOUS 0x20
+# endif
+# ifndef O_RDWR
+#  define O_RDWR 2
+# endif
+# ifndef O_CREAT
+#  define O_CREAT 0x40
+# endif
+# ifndef O_EXCL
+#  define O_EXCL 0x80
+# endif
+#endif
+
+#ifndef bfport_mmap
+# define bfport_mmap bfport_mmap
+static __bfdev_always_inline void *
+bfport_mmap(void *addr, size_t length, int prot,
+            int flags, int fd, long offset)
+{
+#if defined(BFDEV_HAVE_MMAN)
+    return mmap(addr, length, prot, flags, fd, offset);
+#else
+    return MAP_FAILED;
+#endif
+}
+#endif
+
+#ifndef bfport_munmap
+# define bfport_munmap bfport_munmap
+static __bfdev_always_inline int
+bfport_munmap(void *addr, size_t length)
+{
+#if defined(BFDEV_HAVE_MMAN)
+    return munmap(addr, length);
+#else
+    return -1;
+#endif
+}
+#endif
+
+#ifndef bfport_madvise
+# define bfport_madvise bfport_madvise
+static __bfdev_always_inline int
+bfport_madvise(void *addr, size_t length, int advice)
+{
+#if defined(BFDEV_HAVE_MMAN)
+    return madvise(addr, length, advice);
+#else
+    return -1;
+#endif
+}
+#endif
+
+#ifndef bfport_pagesize
+# define bfport_pagesize bfport_pagesize
+static __bfdev_always_inline size_t
+bfport_pagesize(void)
+{
+#if defined(BFDEV_HAVE_MMAN)
+    return sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
+#endif
+
+#ifndef bfport_memfd_create
+# if defined(BFDEV_HAVE_MMAN) && defined(SYS_memfd_create)
+#  define bfport_memfd_create bfport_memfd_create
+static __bfdev_always_inline int
+bfport_memfd_create(const char *name, unsigned int flags)
+{
+    /* The libc wrapper hides behind _GNU_SOURCE */
+    return syscall(SYS_memfd_create, name, flags);
+}
+# endif
+#endif
+
+#ifndef bfport_shm_open
+# define bfport_shm_open bfport_shm_open
+static __bfdev_always_inline int
+bfport_shm_open(const char *name, int oflag, unsigned int mode)
+{
+#if defined(BFDEV_HAVE_MMAN)
+    return shm_open(name, oflag, mode);
+#else
+    return -1;
+#endif
+}
+#endif
+
+#ifndef bfport_shm_unlink
+# define bfport_shm_unlink bfport_shm_unlink
+static __bfdev_always_inline int
+bfport_shm_unlink(const char *name)
+{
+#if defined(BFDEV_HAVE_MMAN)
+    return shm_unlink(name);
+#else
+    return -1;
+#endif
+}
+#endif
+
+#ifndef bfport_ftruncate
+# define bfport_ftruncate bfport_ftruncate
+static __bfdev_always_inline int
+bfport_ftruncate(int fd, long length)
+{
+#if defined(BFDEV_HAVE_MMAN)
+    return ftruncate(fd, length);
+#else
+    return -1;
+#endif
+}
+#endif
+
+#ifndef bfport_close
+# define bfport_close bfport_close
+static __bfdev_always_inline int
+bfport_close(int fd)
+{
+#if defined(BFDEV_HAVE_MMAN)
+    return close(fd);
+#else
+    return -1;
+#endif
+}
+#endif
+
+#ifndef bfport_getpid
+# define bfport_getpid bfport_getpid
+static __bfdev_always_inline long
+bfport_getpid(void)
+{
+#if defined(BFDEV_HAVE_MMAN)
+    return getpid();
+#else
+    return 0;
+#endif
+}
+#endif
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_PORT_MMAN_H_ */
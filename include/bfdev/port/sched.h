@@ -0,0 +1,72 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_PORT_SCHED_H_
+#define _BFDEV_PORT_SCHED_H_
+
+#include <bfdev/config.h>
+
+#if defined(__FreeBSD__) && defined(_KERNEL)
+# include <sys/proc.h>
+#elif defined(__unix__) || defined(__APPLE__)
+# include <sched.h>
+#endif
+
+#if defined(BFDEV_HAVE_FUTEX)
+# include <unistd.h>
+# include <sys/syscall.h>
+# include <linux/futex.h>
+#endif
+
+BFDEV_BEGIN_DECLS
+
+/* Left undefined where threads have no local storage */
+#ifndef bfport_thread
+# if !(defined(__FreeBSD__) && defined(_KERNEL)) && __STDC_HOSTED__ && \
+     (defined(__unix__) || defined(__APPLE__))
+#  define bfport_thread __thread
+# endif
+#endif
+
+#ifndef bfport_sched_yield
+# define bfport_sched_yield bfport_sched_yield
+static __bfdev_always_inline void
+bfport_sched_yield(void)
+{
+#if defined(__FreeBSD__) && defined(_KERNEL)
+    kern_yield(PRI_USER);
+#elif defined(__unix__) || defined(__APPLE__)
+    sched_yield();
+#endif
+}
+#endif
+
+#ifndef bfport_futex_wait
+# define bfport_futex_wait bfport_futex_wait
+static __bfdev_always_inline void
+bfport_futex_wait(int *uaddr, int value)
+{
+#if defined(BFDEV_HAVE_FUTEX)
+    syscall(SYS_futex, uaddr, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+#else
+    bfport_sched_yield();
+#endif
+}
+#endif
+
+#ifndef bfport_futex_wake
+# define bfport_futex_wake bfport_futex_wake
+static __bfdev_always_inline void
+bfport_futex_wake(int *uaddr, int count)
+{
+#if defined(BFDEV_HAVE_FUTEX)
+    syscall(SYS_futex, uaddr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+#endif
+}
+#endif
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_PORT_SCHED_H_ */
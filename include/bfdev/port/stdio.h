@@ -57,6 +57,23 @@ bfport_vsnprintf(char *restrict s, size_t maxlen,
 }
 #endif
 
+#ifndef bfport_snprintf
+# define bfport_snprintf bfport_snprintf
+static inline __bfdev_printf(3, 4) int
+bfport_snprintf(char *restrict s, size_t maxlen,
+                const char *restrict format, ...)
+{
+    va_list args;
+    int length;
+
+    va_start(args, format);
+    length = bfport_vsnprintf(s, maxlen, format, args);
+    va_end(args);
+
+    return length;
+}
+#endif
+
 BFDEV_END_DECLS
 
 #endif /* _BFDEV_PORT_STDIO_H_ */
@@ -10,6 +10,7 @@
 #include <bfdev/macro.h>
 #include <bfdev/errno.h>
 #include <bfdev/allocator.h>
+#include <bfdev/span.h>
 
 BFDEV_BEGIN_DECLS
 
@@ -22,6 +23,7 @@ struct bfdev_ringbuf {
     unsigned long mask;
     unsigned long esize;
     void *data;
+    bool mirror;
 };
 
 /**
@@ -284,6 +286,22 @@ struct bfdev_ringbuf {
     -BFDEV_EINVAL;                                      \
 })
 
+/**
+ * bfdev_ringbuf_alloc_mirror() - allocate a mirrored buffer to ringbuf.
+ * @ptr: the ringbuf to allocate buffer.
+ * @size: size of buffer, rounded up to whole pages.
+ *
+ * The buffer is mapped twice back to back, so spans and records
+ * never wrap. Released by bfdev_ringbuf_free().
+ */
+#define bfdev_ringbuf_alloc_mirror(ptr, size) ({        \
+    typeof((ptr) + 1) __tmp = (ptr);                    \
+    bfdev_ringbuf_check_dynamic(__tmp) ?                \
+    bfdev_ringbuf_mirror_alloc(&__tmp->ringbuf,         \
+    sizeof(*__tmp->data), size) :                       \
+    -BFDEV_EINVAL;                                      \
+})
+
 /**
  * bfdev_ringbuf_free() - dynamically free buffer to ringbuf.
  * @ptr: the ringbuf to free buffer.
@@ -429,6 +447,70 @@ struct bfdev_ringbuf {
     bfdev_ringbuf_in_flat(__ringbuf, __tbuff, __tlen);                  \
 })
 
+/**
+ * bfdev_ringbuf_reserve() - reserve free space to write in place.
+ * @pringbuf: the ringbuf to reserve space in.
+ * @span: two spans receiving the reserved space.
+ * @len: maximum number of objects.
+ *
+ * Returns the number of objects reserved, make them visible with
+ * bfdev_ringbuf_commit(). Only for ringbufs without records.
+ */
+#define bfdev_ringbuf_reserve(pringbuf, span, len) ({                   \
+    typeof((pringbuf) + 1) __tmp = (pringbuf);                          \
+    bfdev_ringbuf_reserve_flat(&__tmp->ringbuf, span, len);             \
+})
+
+/**
+ * bfdev_ringbuf_commit() - publish objects written into reserved space.
+ * @pringbuf: the ringbuf to commit.
+ * @len: number of objects written.
+ *
+ * Like bfdev_ringbuf_in(), committing past the free space drops the
+ * oldest data. bfdev_ringbuf_reserve() may hand out space that still
+ * holds unread data, so writing into it clobbers the oldest entries
+ * even before they are committed over.
+ */
+#define bfdev_ringbuf_commit(pringbuf, len) ({                          \
+    typeof((pringbuf) + 1) __tmp = (pringbuf);                          \
+    bfdev_ringbuf_commit_flat(&__tmp->ringbuf, len);                    \
+})
+
+/**
+ * bfdev_ringbuf_peek_span() - expose valid data to read in place.
+ * @pringbuf: the ringbuf to peek.
+ * @span: two spans receiving the valid data.
+ * @len: maximum number of objects.
+ *
+ * Returns the number of objects exposed, release them with
+ * bfdev_ringbuf_consume(). Record ringbufs expose the next record.
+ */
+#define bfdev_ringbuf_peek_span(pringbuf, span, len) ({                 \
+    typeof((pringbuf) + 1) __tmp = (pringbuf);                          \
+    bfdev_ringbuf_t *__ringbuf = &__tmp->ringbuf;                       \
+    unsigned long __tlen = (len);                                       \
+    unsigned long __recsize = sizeof(*__tmp->rectype);                  \
+    (__recsize) ?                                                       \
+    bfdev_ringbuf_peek_span_record(__ringbuf, span,                     \
+        __tlen, __recsize) :                                            \
+    bfdev_ringbuf_peek_span_flat(__ringbuf, span, __tlen);              \
+})
+
+/**
+ * bfdev_ringbuf_consume() - release objects read in place.
+ * @pringbuf: the ringbuf to consume.
+ * @len: number of objects read, record ringbufs drop the whole record.
+ */
+#define bfdev_ringbuf_consume(pringbuf, len) ({                         \
+    typeof((pringbuf) + 1) __tmp = (pringbuf);                          \
+    bfdev_ringbuf_t *__ringbuf = &__tmp->ringbuf;                       \
+    unsigned long __tlen = (len);                                       \
+    unsigned long __recsize = sizeof(*__tmp->rectype);                  \
+    (__recsize) ?                                                       \
+    bfdev_ringbuf_consume_record(__ringbuf, __recsize) :                \
+    bfdev_ringbuf_consume_flat(__ringbuf, __tlen);                      \
+})
+
 extern unsigned long
 bfdev_ringbuf_peek_flat(bfdev_ringbuf_t *ringbuf, void *buff, unsigned long len);
 
@@ -438,6 +520,20 @@ bfdev_ringbuf_out_flat(bfdev_ringbuf_t *ringbuf, void *buff, unsigned long len);
 extern unsigned long
 bfdev_ringbuf_in_flat(bfdev_ringbuf_t *ringbuf, const void *buff, unsigned long len);
 
+extern unsigned long
+bfdev_ringbuf_reserve_flat(bfdev_ringbuf_t *ringbuf, bfdev_span_t *span,
+                           unsigned long len);
+
+extern unsigned long
+bfdev_ringbuf_commit_flat(bfdev_ringbuf_t *ringbuf, unsigned long len);
+
+extern unsigned long
+bfdev_ringbuf_peek_span_flat(bfdev_ringbuf_t *ringbuf, bfdev_span_t *span,
+                             unsigned long len);
+
+extern unsigned long
+bfdev_ringbuf_consume_flat(bfdev_ringbuf_t *ringbuf, unsigned long len);
+
 extern unsigned long
 bfdev_ringbuf_peek_record(bfdev_ringbuf_t *ringbuf, void *buff, unsigned long len,
                           unsigned long record);
@@ -450,10 +546,20 @@ extern unsigned long
 bfdev_ringbuf_in_record(bfdev_ringbuf_t *ringbuf, const void *buff, unsigned long len,
                         unsigned long record);
 
+extern unsigned long
+bfdev_ringbuf_peek_span_record(bfdev_ringbuf_t *ringbuf, bfdev_span_t *span,
+                               unsigned long len, unsigned long record);
+
+extern unsigned long
+bfdev_ringbuf_consume_record(bfdev_ringbuf_t *ringbuf, unsigned long record);
+
 extern int
 bfdev_ringbuf_dynamic_alloc(bfdev_ringbuf_t *ringbuf, const bfdev_alloc_t *alloc,
                             size_t esize, size_t size);
 
+extern int
+bfdev_ringbuf_mirror_alloc(bfdev_ringbuf_t *ringbuf, size_t esize, size_t size);
+
 extern void
 bfdev_ringbuf_dynamic_free(bfdev_ringbuf_t *ringbuf);
 
@@ -0,0 +1,16 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_SCHED_H_
+#define _BFDEV_SCHED_H_
+
+#include <bfdev/config.h>
+#include <bfdev/port/sched.h>
+
+BFDEV_BEGIN_DECLS
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_SCHED_H_ */
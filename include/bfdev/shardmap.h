@@ -0,0 +1,186 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_SHARDMAP_H_
+#define _BFDEV_SHARDMAP_H_
+
+#include <bfdev/config.h>
+#include <bfdev/errno.h>
+#include <bfdev/hashmap.h>
+#include <bfdev/spinlock.h>
+#include <bfdev/epoch.h>
+
+BFDEV_BEGIN_DECLS
+
+#ifndef BFDEV_SHARDMAP_STRIPE_BITS
+# define BFDEV_SHARDMAP_STRIPE_BITS 6
+#endif
+
+typedef struct bfdev_shardmap bfdev_shardmap_t;
+typedef struct bfdev_shardmap_stripe bfdev_shardmap_stripe_t;
+
+/**
+ * struct bfdev_shardmap_stripe - lock stripe of a sharded hash map.
+ * @lock: serializes writers of all buckets mapped to this stripe.
+ * @used: number of nodes stored in this stripe.
+ */
+struct bfdev_shardmap_stripe {
+    bfdev_spinlock_t lock;
+    unsigned long used;
+} __bfdev_cacheline_aligned;
+
+/**
+ * struct bfdev_shardmap - concurrent hash map with striped locks.
+ * @buckets: fixed bucket array, never resized.
+ * @stripes: lock stripes, bucket index modulo @nstripes.
+ * @epoch: grace period domain of lock-free readers.
+ */
+struct bfdev_shardmap {
+    bfdev_hlist_head_t *buckets;
+    unsigned int bits;
+    unsigned long capacity;
+
+    bfdev_shardmap_stripe_t *stripes;
+    unsigned long nstripes;
+    void *block;
+
+    bfdev_epoch_t epoch;
+
+    const bfdev_alloc_t *alloc;
+    const bfdev_hashmap_ops_t *ops;
+    void *pdata;
+};
+
+/**
+ * bfdev_shardmap_init() - initialize a sharded hash map.
+ * @shardmap: shardmap structure to be initialized.
+ * @alloc: allocator operations.
+ * @ops: hashmap operations, extend and shrink are ignored.
+ * @bits: log2 of the bucket count.
+ * @sbits: log2 of the stripe count, clamped to @bits.
+ * @pdata: operations callback data.
+ */
+extern int
+bfdev_shardmap_init(bfdev_shardmap_t *shardmap, const bfdev_alloc_t *alloc,
+                    const bfdev_hashmap_ops_t *ops, unsigned int bits,
+                    unsigned int sbits, void *pdata);
+
+/**
+ * bfdev_shardmap_release() - release a sharded hash map.
+ * @shardmap: shardmap structure to be release.
+ */
+extern void
+bfdev_shardmap_release(bfdev_shardmap_t *shardmap);
+
+/**
+ * bfdev_shardmap_insert() - insert a hashlist node to shardmap.
+ * @shardmap: shardmap structure to be insert.
+ * @node: new hashlist node to insert.
+ * @old: pointer used to return the replaced node.
+ * @strategy: insertion strategy.
+ *
+ * A replaced node is still visible to concurrent readers, it may
+ * only be reused after bfdev_shardmap_synchronize().
+ */
+extern int
+bfdev_shardmap_insert(bfdev_shardmap_t *shardmap, bfdev_hlist_node_t *node,
+                      bfdev_hlist_node_t **old, bfdev_hashmap_strategy_t strategy);
+
+/**
+ * bfdev_shardmap_del() - delete a hashlist node from shardmap.
+ * @shardmap: shardmap structure to be delete.
+ * @key: key of the node to be deleted.
+ * @node: pointer used to return the deleted node.
+ *
+ * The deleted node may only be reused after bfdev_shardmap_synchronize().
+ */
+extern int
+bfdev_shardmap_del(bfdev_shardmap_t *shardmap, const void *key,
+                   bfdev_hlist_node_t **node);
+
+/**
+ * bfdev_shardmap_find() - find a hashlist node in shardmap.
+ * @shardmap: shardmap structure to be find.
+ * @key: key of the node to be find.
+ *
+ * Lock-free, must be called between bfdev_shardmap_read_lock() and
+ * bfdev_shardmap_read_unlock(). The returned node stays valid until
+ * the read-side section ends.
+ */
+extern bfdev_hlist_node_t *
+bfdev_shardmap_find(bfdev_shardmap_t *shardmap, const void *key);
+
+/**
+ * bfdev_shardmap_used() - number of nodes stored in shardmap.
+ * @shardmap: shardmap structure to be count.
+ *
+ * The result is a snapshot and may be stale under concurrent writers.
+ */
+extern unsigned long
+bfdev_shardmap_used(bfdev_shardmap_t *shardmap);
+
+static __bfdev_always_inline int
+bfdev_shardmap_add(bfdev_shardmap_t *shardmap, bfdev_hlist_node_t *node)
+{
+    return bfdev_shardmap_insert(shardmap, node, NULL, BFDEV_HASHMAP_ADD);
+}
+
+static __bfdev_always_inline int
+bfdev_shardmap_set(bfdev_shardmap_t *shardmap, bfdev_hlist_node_t *node,
+                   bfdev_hlist_node_t **old)
+{
+    return bfdev_shardmap_insert(shardmap, node, old, BFDEV_HASHMAP_SET);
+}
+
+static __bfdev_always_inline int
+bfdev_shardmap_update(bfdev_shardmap_t *shardmap, bfdev_hlist_node_t *node,
+                      bfdev_hlist_node_t **old)
+{
+    return bfdev_shardmap_insert(shardmap, node, old, BFDEV_HASHMAP_UPDATE);
+}
+
+static __bfdev_always_inline int
+bfdev_shardmap_append(bfdev_shardmap_t *shardmap, bfdev_hlist_node_t *node)
+{
+    return bfdev_shardmap_insert(shardmap, node, NULL, BFDEV_HASHMAP_APPEND);
+}
+
+static inline void
+bfdev_shardmap_reader_register(bfdev_shardmap_t *shardmap,
+                               bfdev_epoch_reader_t *reader)
+{
+    bfdev_epoch_register(&shardmap->epoch, reader);
+}
+
+static inline void
+bfdev_shardmap_reader_unregister(bfdev_shardmap_t *shardmap,
+                                 bfdev_epoch_reader_t *reader)
+{
+    bfdev_epoch_unregister(&shardmap->epoch, reader);
+}
+
+static inline void
+bfdev_shardmap_read_lock(bfdev_shardmap_t *shardmap,
+                         bfdev_epoch_reader_t *reader)
+{
+    bfdev_epoch_enter(&shardmap->epoch, reader);
+}
+
+static inline void
+bfdev_shardmap_read_unlock(bfdev_shardmap_t *shardmap,
+                           bfdev_epoch_reader_t *reader)
+{
+    bfdev_epoch_exit(&shardmap->epoch, reader);
+}
+
+static inline void
+bfdev_shardmap_synchronize(bfdev_shardmap_t *shardmap)
+{
+    bfdev_epoch_synchronize(&shardmap->epoch);
+}
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_SHARDMAP_H_ */
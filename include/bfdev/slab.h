@@ -0,0 +1,164 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_SLAB_H_
+#define _BFDEV_SLAB_H_
+
+#include <bfdev/config.h>
+#include <bfdev/types.h>
+#include <bfdev/stddef.h>
+#include <bfdev/minmax.h>
+#include <bfdev/allocator.h>
+#include <bfdev/spinlock.h>
+#include <bfdev/barrier.h>
+
+BFDEV_BEGIN_DECLS
+
+#ifndef BFDEV_SLAB_MAGAZINE
+# define BFDEV_SLAB_MAGAZINE 32
+#endif
+
+#ifndef BFDEV_SLAB_CPUS
+# define BFDEV_SLAB_CPUS 16
+#endif
+
+#ifndef BFDEV_SLAB_PAGE
+# define BFDEV_SLAB_PAGE 16384
+#endif
+
+#ifndef BFDEV_SLAB_ALIGN
+# define BFDEV_SLAB_ALIGN (sizeof(size_t) * 2)
+#endif
+
+typedef struct bfdev_slab bfdev_slab_t;
+typedef struct bfdev_slab_cpu bfdev_slab_cpu_t;
+typedef struct bfdev_slab_magazine bfdev_slab_magazine_t;
+
+/**
+ * struct bfdev_slab_magazine - stack of cached objects.
+ * @next: link in the depot.
+ * @count: number of objects held.
+ */
+struct bfdev_slab_magazine {
+    bfdev_slab_magazine_t *next;
+    unsigned int count;
+    void *objects[BFDEV_SLAB_MAGAZINE];
+};
+
+/**
+ * struct bfdev_slab_cpu - per-thread object cache.
+ * @lock: only contended when threads outnumber the caches.
+ * @loaded: magazine serving allocations and frees.
+ * @previous: magazine swapped in before going to the depot.
+ */
+struct bfdev_slab_cpu {
+    bfdev_spinlock_t lock;
+    bfdev_slab_magazine_t *loaded;
+    bfdev_slab_magazine_t *previous;
+} __bfdev_cacheline_aligned;
+
+/**
+ * struct bfdev_slab - fixed size object allocator.
+ * @alloc: backing allocator of pages and magazines.
+ * @cpus: per-thread caches, picked once per thread.
+ * @lock: protects the depot and the slab layer.
+ * @full: depot of full magazines.
+ * @empty: depot of empty magazines.
+ * @freelist: objects returned to the slab layer.
+ * @pages: pages carved into objects.
+ * @allocator: allocator interface on top of this slab.
+ */
+struct bfdev_slab {
+    const bfdev_alloc_t *alloc;
+    size_t objsize;
+    size_t align;
+
+    bfdev_slab_cpu_t cpus[BFDEV_SLAB_CPUS];
+
+    bfdev_spinlock_t lock;
+    bfdev_slab_magazine_t *full;
+    bfdev_slab_magazine_t *empty;
+    void *freelist;
+    void *pages;
+    void *bump;
+    void *limit;
+
+    bfdev_alloc_ops_t ops;
+    bfdev_alloc_t allocator;
+};
+
+/**
+ * bfdev_slab_alloc() - allocate an object.
+ * @slab: the slab to allocate from.
+ */
+extern __bfdev_malloc void *
+bfdev_slab_alloc(bfdev_slab_t *slab);
+
+/**
+ * bfdev_slab_free() - free an object.
+ * @slab: the slab the object was allocated from.
+ * @block: object to free.
+ */
+extern void
+bfdev_slab_free(bfdev_slab_t *slab, void *block);
+
+/**
+ * bfdev_slab_drain() - flush every cached object back to the slab layer.
+ * @slab: the slab to drain.
+ *
+ * May run alongside allocations and frees of other threads, whose
+ * caches are simply refilled afterwards.
+ */
+extern void
+bfdev_slab_drain(bfdev_slab_t *slab);
+
+/**
+ * bfdev_slab_init() - initialize a slab.
+ * @slab: the slab to initialize.
+ * @alloc: backing allocator of pages and magazines.
+ * @objsize: object size.
+ * @align: object alignment, power of two, zero for malloc alignment.
+ */
+extern int
+bfdev_slab_init(bfdev_slab_t *slab, const bfdev_alloc_t *alloc,
+                size_t objsize, size_t align);
+
+/**
+ * bfdev_slab_release() - release every page of a slab.
+ * @slab: the slab to release.
+ */
+extern void
+bfdev_slab_release(bfdev_slab_t *slab);
+
+/**
+ * bfdev_slab_header() - header size of allocator interface blocks.
+ * @slab: the slab to use.
+ *
+ * Keeps blocks at the object alignment, and at least at the malloc
+ * alignment for blocks from the backing allocator.
+ */
+static inline size_t
+bfdev_slab_header(bfdev_slab_t *slab)
+{
+    return bfdev_max(slab->align, (size_t)BFDEV_SLAB_ALIGN);
+}
+
+/**
+ * bfdev_slab_allocator() - allocator interface of a slab.
+ * @slab: the slab to use.
+ *
+ * Requests that fit an object are served by the slab, larger ones
+ * go to the backing allocator. Each block carries a header of
+ * bfdev_slab_header() bytes telling the two apart.
+ */
+static inline const bfdev_alloc_t *
+bfdev_slab_allocator(bfdev_slab_t *slab)
+{
+    return &slab->allocator;
+}
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_SLAB_H_ */
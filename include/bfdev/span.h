@@ -0,0 +1,70 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_SPAN_H_
+#define _BFDEV_SPAN_H_
+
+#include <bfdev/config.h>
+#include <bfdev/types.h>
+#include <bfdev/stddef.h>
+
+#ifdef BFDEV_HAVE_UIO
+# include <sys/uio.h>
+#endif
+
+BFDEV_BEGIN_DECLS
+
+typedef struct bfdev_span bfdev_span_t;
+
+/**
+ * struct bfdev_span - contiguous byte range inside a ring.
+ * @base: start of the range.
+ * @len: length of the range in bytes.
+ *
+ * Rings hand out two spans, the second one is only non-empty when
+ * the range wraps around the end of the buffer.
+ */
+struct bfdev_span {
+    void *base;
+    size_t len;
+};
+
+/**
+ * bfdev_span_len() - get the total length of two spans.
+ * @span: the spans to measure.
+ */
+static inline size_t
+bfdev_span_len(const bfdev_span_t span[2])
+{
+    return span[0].len + span[1].len;
+}
+
+#ifdef BFDEV_HAVE_UIO
+
+/**
+ * bfdev_span_iovec() - convert spans to an iovec array.
+ * @iov: the iovec array, at least two entries.
+ * @span: the spans to convert.
+ *
+ * Returns the number of non-empty entries, ready for readv/writev.
+ */
+static inline int
+bfdev_span_iovec(struct iovec *iov, const bfdev_span_t span[2])
+{
+    int count;
+
+    for (count = 0; count < 2 && span[count].len; ++count) {
+        iov[count].iov_base = span[count].base;
+        iov[count].iov_len = span[count].len;
+    }
+
+    return count;
+}
+
+#endif /* BFDEV_HAVE_UIO */
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_SPAN_H_ */
@@ -0,0 +1,107 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#ifndef _BFDEV_SPINLOCK_H_
+#define _BFDEV_SPINLOCK_H_
+
+#include <bfdev/config.h>
+#include <bfdev/types.h>
+#include <bfdev/atomic.h>
+#include <bfdev/cmpxchg.h>
+#include <bfdev/barrier.h>
+#include <bfdev/sched.h>
+
+BFDEV_BEGIN_DECLS
+
+#ifndef BFDEV_SPIN_THRESHOLD
+# define BFDEV_SPIN_THRESHOLD 128
+#endif
+
+typedef struct bfdev_spinlock bfdev_spinlock_t;
+
+struct bfdev_spinlock {
+    bfdev_atomic_t lock;
+};
+
+#define BFDEV_SPINLOCK_STATIC \
+    {.lock = 0}
+
+#define BFDEV_SPINLOCK_INIT \
+    (bfdev_spinlock_t) BFDEV_SPINLOCK_STATIC
+
+#define BFDEV_DEFINE_SPINLOCK(name) \
+    bfdev_spinlock_t name = BFDEV_SPINLOCK_INIT
+
+/**
+ * bfdev_spin_backoff() - back off inside a busy wait loop.
+ * @count: spin counter, start from zero.
+ *
+ * Relax the cpu for a while, then give up the time slice so that a
+ * preempted owner on the same cpu gets a chance to run.
+ */
+static inline void
+bfdev_spin_backoff(unsigned int *count)
+{
+    if (++*count < BFDEV_SPIN_THRESHOLD) {
+        bfdev_cpu_relax();
+        return;
+    }
+
+    *count = 0;
+    bfport_sched_yield();
+}
+
+static inline void
+bfdev_spin_init(bfdev_spinlock_t *lock)
+{
+    *lock = BFDEV_SPINLOCK_INIT;
+}
+
+/**
+ * bfdev_spin_trylock() - try to acquire a spinlock once.
+ * @lock: spinlock to acquire.
+ *
+ * @return: true if the lock was acquired.
+ */
+static inline bool
+bfdev_spin_trylock(bfdev_spinlock_t *lock)
+{
+    if (bfdev_atomic_read(&lock->lock))
+        return false;
+
+    return !bfdev_xchg(&lock->lock, 1);
+}
+
+/**
+ * bfdev_spin_lock() - acquire a spinlock.
+ * @lock: spinlock to acquire.
+ *
+ * Spin on a plain load between exchange attempts, so that waiters
+ * do not keep bouncing the cache line away from the owner.
+ */
+static inline void
+bfdev_spin_lock(bfdev_spinlock_t *lock)
+{
+    unsigned int count = 0;
+
+    while (!bfdev_spin_trylock(lock)) {
+        while (bfdev_atomic_read(&lock->lock))
+            bfdev_spin_backoff(&count);
+    }
+}
+
+/**
+ * bfdev_spin_unlock() - release a spinlock.
+ * @lock: spinlock to release.
+ */
+static inline void
+bfdev_spin_unlock(bfdev_spinlock_t *lock)
+{
+    bfdev_store_release(&lock->lock, 0);
+}
+
+BFDEV_END_DECLS
+
+#endif /* _BFDEV_SPINLOCK_H_ */
@@ -0,0 +1,182 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "bfdev-allocprof"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <base.h>
+#include <bfdev/allocprof.h>
+#include <bfdev/atomic.h>
+#include <bfdev/cmpxchg.h>
+#include <bfdev/bitops.h>
+#include <bfdev/log.h>
+#include <export.h>
+
+static __bfdev_always_inline unsigned int
+allocprof_class(size_t size)
+{
+    unsigned int index;
+
+    if (size <= 8)
+        return 0;
+
+    index = bfdev_flsuf(size - 1) - 2;
+    if (index >= BFDEV_ALLOCPROF_HISTOGRAM)
+        index = BFDEV_ALLOCPROF_HISTOGRAM - 1;
+
+    return index;
+}
+
+static void
+allocprof_charge(bfdev_allocprof_t *prof, size_t size, bfdev_atomic_t delta)
+{
+    bfdev_atomic_t live, peak;
+
+    bfdev_atomic_add(&prof->histogram[allocprof_class(size)], 1);
+    live = bfdev_atomic_add_fetch(&prof->live, delta);
+
+    /* Racing updates only ever raise the peak */
+    peak = bfdev_atomic_read(&prof->peak);
+    while (live > peak) {
+        if (bfdev_try_cmpxchg(&prof->peak, &peak, live))
+            break;
+    }
+}
+
+static void *
+allocprof_account(bfdev_allocprof_t *prof, size_t *block, size_t size)
+{
+    if (bfdev_unlikely(!block)) {
+        bfdev_atomic_add(&prof->failed, 1);
+        return NULL;
+    }
+
+    *block = size;
+    bfdev_atomic_add(&prof->allocs, 1);
+    allocprof_charge(prof, size, size);
+
+    return (void *)block + BFDEV_ALLOCPROF_HEADER;
+}
+
+static void *
+allocprof_alloc(size_t size, void *pdata)
+{
+    bfdev_allocprof_t *prof;
+    size_t *block;
+
+    prof = pdata;
+    block = bfdev_malloc(prof->alloc, size + BFDEV_ALLOCPROF_HEADER);
+
+    return allocprof_account(prof, block, size);
+}
+
+static void *
+allocprof_zalloc(size_t size, void *pdata)
+{
+    bfdev_allocprof_t *prof;
+    size_t *block;
+
+    prof = pdata;
+    block = bfdev_zalloc(prof->alloc, size + BFDEV_ALLOCPROF_HEADER);
+
+    return allocprof_account(prof, block, size);
+}
+
+static void *
+allocprof_realloc(void *block, size_t resize, void *pdata)
+{
+    bfdev_allocprof_t *prof;
+    size_t *base, origin;
+
+    prof = pdata;
+    base = block - BFDEV_ALLOCPROF_HEADER;
+    origin = *base;
+
+    base = bfdev_realloc(prof->alloc, base, resize + BFDEV_ALLOCPROF_HEADER);
+    if (bfdev_unlikely(!base)) {
+        bfdev_atomic_add(&prof->failed, 1);
+        return NULL;
+    }
+
+    *base = resize;
+    bfdev_atomic_add(&prof->reallocs, 1);
+    allocprof_charge(prof, resize, (bfdev_atomic_t)resize - (bfdev_atomic_t)origin);
+
+    return (void *)base + BFDEV_ALLOCPROF_HEADER;
+}
+
+static void
+allocprof_free(void *block, void *pdata)
+{
+    bfdev_allocprof_t *prof;
+    size_t *base;
+
+    prof = pdata;
+    base = block - BFDEV_ALLOCPROF_HEADER;
+
+    bfdev_atomic_add(&prof->frees, 1);
+    bfdev_atomic_sub(&prof->live, *base);
+    bfdev_free(prof->alloc, base);
+}
+
+export void
+bfdev_allocprof_reset(bfdev_allocprof_t *prof)
+{
+    unsigned int index;
+
+    bfdev_atomic_write(&prof->allocs, 0);
+    bfdev_atomic_write(&prof->frees, 0);
+    bfdev_atomic_write(&prof->reallocs, 0);
+    bfdev_atomic_write(&prof->failed, 0);
+    bfdev_atomic_write(&prof->peak, bfdev_atomic_read(&prof->live));
+
+    for (index = 0; index < BFDEV_ALLOCPROF_HISTOGRAM; ++index)
+        bfdev_atomic_write(&prof->histogram[index], 0);
+}
+
+export void
+bfdev_allocprof_report(bfdev_allocprof_t *prof)
+{
+    bfdev_atomic_t count;
+    unsigned int index;
+
+    bfdev_log_info("%s: allocs %ld frees %ld reallocs %ld failed %ld\n",
+                   prof->name, (long)bfdev_atomic_read(&prof->allocs),
+                   (long)bfdev_atomic_read(&prof->frees),
+                   (long)bfdev_atomic_read(&prof->reallocs),
+                   (long)bfdev_atomic_read(&prof->failed));
+
+    bfdev_log_info("%s: live %ld bytes, peak %ld bytes\n", prof->name,
+                   (long)bfdev_atomic_read(&prof->live),
+                   (long)bfdev_atomic_read(&prof->peak));
+
+    for (index = 0; index < BFDEV_ALLOCPROF_HISTOGRAM; ++index) {
+        count = bfdev_atomic_read(&prof->histogram[index]);
+        if (!count)
+            continue;
+
+        if (index == BFDEV_ALLOCPROF_HISTOGRAM - 1)
+            bfdev_log_info("%s:   > %lu: %ld\n", prof->name,
+                           8UL << (index - 1), (long)count);
+        else
+            bfdev_log_info("%s:  <= %lu: %ld\n", prof->name,
+                           8UL << index, (long)count);
+    }
+}
+
+export void
+bfdev_allocprof_init(bfdev_allocprof_t *prof, const char *name,
+                     const bfdev_alloc_t *alloc)
+{
+    prof->name = name;
+    prof->alloc = alloc;
+
+    bfdev_atomic_write(&prof->live, 0);
+    bfdev_allocprof_reset(prof);
+
+    bfdev_alloc_ops_init(&prof->ops, allocprof_alloc, allocprof_zalloc,
+                         allocprof_realloc, allocprof_free);
+    bfdev_alloc_init(&prof->allocator, &prof->ops, prof);
+}
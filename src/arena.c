@@ -0,0 +1,209 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/arena.h>
+#include <bfdev/minmax.h>
+#include <export.h>
+
+static bfdev_arena_chunk_t *
+arena_chunk_alloc(bfdev_arena_t *arena, size_t size)
+{
+    bfdev_arena_chunk_t *chunk;
+
+    chunk = bfdev_malloc(arena->alloc, sizeof(*chunk) + size);
+    if (bfdev_unlikely(!chunk))
+        return NULL;
+
+    bfdev_allocpool_init(&chunk->pool, chunk + 1, size);
+
+    return chunk;
+}
+
+static bfdev_arena_chunk_t *
+arena_chunk_find(bfdev_arena_t *arena, const void *block)
+{
+    bfdev_arena_chunk_t *chunk;
+    bfdev_allocpool_t *pool;
+
+    for (chunk = arena->chunks; chunk; chunk = chunk->next) {
+        pool = &chunk->pool;
+        if (block >= pool->block && block < pool->block + pool->size)
+            return chunk;
+    }
+
+    return NULL;
+}
+
+export __bfdev_malloc void *
+bfdev_arena_alloc(bfdev_arena_t *arena, size_t size, size_t align)
+{
+    bfdev_arena_chunk_t *chunk, *prev;
+    size_t csize;
+    void *block;
+
+    if (bfdev_unlikely(!size))
+        return NULL;
+
+    prev = arena->current;
+    if (prev) {
+        block = bfdev_allocpool_alloc(&prev->pool, size, align);
+        if (bfdev_likely(block))
+            goto finish;
+
+        /* Chunks left behind by a rollback are reused first */
+        for (chunk = prev->next; chunk; chunk = chunk->next) {
+            bfdev_allocpool_reset(&chunk->pool);
+            block = bfdev_allocpool_alloc(&chunk->pool, size, align);
+            if (block) {
+                arena->current = chunk;
+                goto finish;
+            }
+            prev = chunk;
+        }
+    }
+
+    /* Oversized requests get a chunk of their own */
+    csize = bfdev_max(size + align + sizeof(void *), arena->chunk_size);
+    chunk = arena_chunk_alloc(arena, csize);
+    if (bfdev_unlikely(!chunk))
+        return NULL;
+
+    if (prev) {
+        chunk->next = prev->next;
+        prev->next = chunk;
+    } else {
+        chunk->next = NULL;
+        arena->chunks = chunk;
+    }
+
+    arena->current = chunk;
+    block = bfdev_allocpool_alloc(&chunk->pool, size, align);
+
+finish:
+    arena->latest = block;
+    return block;
+}
+
+export void
+bfdev_arena_rollback(bfdev_arena_t *arena, const bfdev_arena_mark_t *mark)
+{
+    if (!mark->chunk) {
+        bfdev_arena_reset(arena);
+        return;
+    }
+
+    arena->current = mark->chunk;
+    arena->current->pool.last = mark->last;
+    arena->latest = NULL;
+}
+
+export void
+bfdev_arena_reset(bfdev_arena_t *arena)
+{
+    arena->current = arena->chunks;
+    if (arena->current)
+        bfdev_allocpool_reset(&arena->current->pool);
+    arena->latest = NULL;
+}
+
+static void *
+arena_adapter_alloc(size_t size, void *pdata)
+{
+    return bfdev_arena_alloc(pdata, size, 0);
+}
+
+static void *
+arena_adapter_zalloc(size_t size, void *pdata)
+{
+    void *block;
+
+    block = bfdev_arena_alloc(pdata, size, 0);
+    if (bfdev_likely(block))
+        bfport_memset(block, 0, size);
+
+    return block;
+}
+
+static void *
+arena_adapter_realloc(void *block, size_t resize, void *pdata)
+{
+    bfdev_arena_chunk_t *chunk;
+    bfdev_allocpool_t *pool;
+    bfdev_arena_t *arena;
+    void *retval;
+    size_t copy;
+
+    arena = pdata;
+    if (!block)
+        return bfdev_arena_alloc(arena, resize, 0);
+
+    /* The latest block simply moves the bump pointer */
+    if (block == arena->latest) {
+        pool = &arena->current->pool;
+        if ((uintptr_t)(block - pool->block) + resize <= pool->size) {
+            pool->last = (block - pool->block) + resize;
+            return block;
+        }
+    }
+
+    chunk = arena_chunk_find(arena, block);
+    if (bfdev_unlikely(!chunk))
+        return NULL;
+
+    /*
+     * The old size is unknown, but whatever lies between the block
+     * and the end of its chunk was handed out, so it is safe to read.
+     * Measure before allocating: the new block may come from the same
+     * chunk, and the copy must stop short of it.
+     */
+    pool = &chunk->pool;
+    copy = bfdev_min(resize, (size_t)(pool->block + pool->last - block));
+
+    retval = bfdev_arena_alloc(arena, resize, 0);
+    if (bfdev_unlikely(!retval))
+        return NULL;
+
+    bfport_memcpy(retval, block, copy);
+
+    return retval;
+}
+
+static void
+arena_adapter_free(void *block, void *pdata)
+{
+    /* Nothing to do */
+}
+
+export void
+bfdev_arena_init(bfdev_arena_t *arena, const bfdev_alloc_t *alloc,
+                 size_t chunk_size)
+{
+    arena->alloc = alloc;
+    arena->chunks = NULL;
+    arena->current = NULL;
+    arena->latest = NULL;
+    arena->chunk_size = chunk_size ?: BFDEV_ARENA_CHUNK;
+
+    bfdev_alloc_ops_init(&arena->ops, arena_adapter_alloc,
+                         arena_adapter_zalloc, arena_adapter_realloc,
+                         arena_adapter_free);
+    bfdev_alloc_init(&arena->allocator, &arena->ops, arena);
+}
+
+export void
+bfdev_arena_release(bfdev_arena_t *arena)
+{
+    bfdev_arena_chunk_t *chunk, *next;
+
+    for (chunk = arena->chunks; chunk; chunk = next) {
+        next = chunk->next;
+        bfdev_free(arena->alloc, chunk);
+    }
+
+    arena->chunks = NULL;
+    arena->current = NULL;
+    arena->latest = NULL;
+}
@@ -0,0 +1,208 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/broadcast.h>
+#include <bfdev/atomic.h>
+#include <bfdev/align.h>
+#include <bfdev/limits.h>
+#include <bfdev/log2.h>
+#include <bfdev/byteorder.h>
+#include <bfdev/sched.h>
+#include <export.h>
+
+/*
+ * The kernel compares the 32 bits at the futex address, so point it
+ * at the low half of the counter, which is the half that changes.
+ */
+static __bfdev_always_inline int *
+broadcast_futex_word(bfdev_atomic_t *futex)
+{
+#ifdef __BFDEV_BIG_ENDIAN__
+    return (int *)futex + sizeof(*futex) / sizeof(int) - 1;
+#else
+    return (int *)futex;
+#endif
+}
+
+/*
+ * A futex waiter registers itself before checking @cond for the last
+ * time, and the waker bumps the futex word before looking for waiters.
+ * Both are full barriers, so either the waiter sees the new state or
+ * the waker sees the waiter, and a stale futex word never sleeps.
+ */
+#define BROADCAST_WAIT(cond, futex, waiters) do {                   \
+    bfdev_atomic_t value;                                           \
+                                                                    \
+    while (!(cond)) {                                               \
+        switch (broadcast->wait) {                                  \
+            case BFDEV_BROADCAST_SPIN:                              \
+                bfdev_cpu_relax();                                  \
+                break;                                              \
+                                                                    \
+            case BFDEV_BROADCAST_FUTEX:                             \
+                value = bfdev_load_acquire(futex);                  \
+                bfdev_atomic_add(waiters, 1);                       \
+                if (!(cond))                                        \
+                    broadcast_idle(futex, value);                   \
+                bfdev_atomic_sub(waiters, 1);                       \
+                break;                                              \
+                                                                    \
+            default:                                                \
+                bfport_sched_yield();                               \
+                break;                                              \
+        }                                                           \
+    }                                                               \
+} while (0)
+
+static __bfdev_always_inline void
+broadcast_idle(bfdev_atomic_t *futex, bfdev_atomic_t value)
+{
+    bfport_futex_wait(broadcast_futex_word(futex), (int)value);
+}
+
+static __bfdev_always_inline void
+broadcast_wake(bfdev_broadcast_t *broadcast, bfdev_atomic_t *futex,
+               bfdev_atomic_t *waiters)
+{
+    if (broadcast->wait != BFDEV_BROADCAST_FUTEX)
+        return;
+
+    bfdev_atomic_add_fetch(futex, 1);
+    if (bfdev_atomic_read(waiters))
+        bfport_futex_wake(broadcast_futex_word(futex), BFDEV_INT_MAX);
+}
+
+static unsigned long
+broadcast_gate(bfdev_broadcast_t *broadcast)
+{
+    unsigned long sequence, lag, slowest;
+    unsigned int count;
+
+    /* Sequences wrap, so compare how far each cursor lags behind */
+    slowest = 0;
+    for (count = 0; count < broadcast->consumers; ++count) {
+        sequence = bfdev_load_acquire(&broadcast->cursors[count].sequence);
+        lag = broadcast->claimed - sequence;
+        if (lag > slowest)
+            slowest = lag;
+    }
+
+    broadcast->gate = broadcast->claimed - slowest;
+
+    return broadcast->gate;
+}
+
+export unsigned long
+bfdev_broadcast_claim(bfdev_broadcast_t *broadcast, unsigned long len,
+                      unsigned long *sequence)
+{
+    unsigned long size, end;
+
+    size = broadcast->mask + 1;
+    if (len > size)
+        len = size;
+
+    end = broadcast->claimed + len;
+    if (end - broadcast->gate > size) {
+        BROADCAST_WAIT(
+            end - broadcast_gate(broadcast) <= size,
+            &broadcast->pfutex, &broadcast->pwaiters
+        );
+    }
+
+    *sequence = broadcast->claimed;
+    broadcast->claimed = end;
+
+    return len;
+}
+
+export void
+bfdev_broadcast_publish(bfdev_broadcast_t *broadcast)
+{
+    bfdev_store_release(&broadcast->published, broadcast->claimed);
+    broadcast_wake(broadcast, &broadcast->cfutex, &broadcast->cwaiters);
+}
+
+export unsigned long
+bfdev_broadcast_poll(bfdev_broadcast_t *broadcast, unsigned int consumer,
+                     unsigned long *sequence)
+{
+    unsigned long published;
+
+    *sequence = bfdev_atomic_read(&broadcast->cursors[consumer].sequence);
+    published = bfdev_load_acquire(&broadcast->published);
+
+    return published - *sequence;
+}
+
+export unsigned long
+bfdev_broadcast_next(bfdev_broadcast_t *broadcast, unsigned int consumer,
+                     unsigned long *sequence)
+{
+    unsigned long pending;
+
+    BROADCAST_WAIT(
+        (pending = bfdev_broadcast_poll(broadcast, consumer, sequence)),
+        &broadcast->cfutex, &broadcast->cwaiters
+    );
+
+    return pending;
+}
+
+export void
+bfdev_broadcast_consume(bfdev_broadcast_t *broadcast, unsigned int consumer,
+                        unsigned long len)
+{
+    bfdev_broadcast_cursor_t *cursor;
+
+    cursor = &broadcast->cursors[consumer];
+    bfdev_store_release(&cursor->sequence,
+                        bfdev_atomic_read(&cursor->sequence) + len);
+    broadcast_wake(broadcast, &broadcast->pfutex, &broadcast->pwaiters);
+}
+
+export int
+bfdev_broadcast_init(bfdev_broadcast_t *broadcast, const bfdev_alloc_t *alloc,
+                     size_t esize, size_t size, unsigned int consumers,
+                     unsigned int wait)
+{
+    size = bfdev_pow2_roundup(size);
+    if (size < 2 || !esize || !consumers ||
+        wait > BFDEV_BROADCAST_FUTEX)
+        return -BFDEV_EINVAL;
+
+    bfport_memset(broadcast, 0, sizeof(*broadcast));
+    broadcast->data = bfdev_malloc_array(alloc, size, esize);
+    if (!broadcast->data)
+        return -BFDEV_ENOMEM;
+
+    /* Keep every cursor on a cacheline of its own */
+    broadcast->block = bfdev_zalloc(alloc, BFDEV_CACHELINE_SIZE +
+                                    sizeof(*broadcast->cursors) * consumers);
+    if (!broadcast->block) {
+        bfdev_free(alloc, broadcast->data);
+        return -BFDEV_ENOMEM;
+    }
+
+    broadcast->cursors = bfdev_align_ptr_high(broadcast->block,
+                                              BFDEV_CACHELINE_SIZE);
+    broadcast->alloc = alloc;
+    broadcast->mask = size - 1;
+    broadcast->esize = esize;
+    broadcast->consumers = consumers;
+    broadcast->wait = wait;
+
+    return -BFDEV_ENOERR;
+}
+
+export void
+bfdev_broadcast_release(bfdev_broadcast_t *broadcast)
+{
+    bfdev_free(broadcast->alloc, broadcast->block);
+    bfdev_free(broadcast->alloc, broadcast->data);
+    broadcast->cursors = NULL;
+    broadcast->data = NULL;
+}
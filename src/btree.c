@@ -553,6 +553,412 @@ bfdev_btree_remove(bfdev_btree_root_t *root, uintptr_t *key)
     return remove_level(root, 1, key);
 }
 
+struct btree_bulk {
+    bfdev_btree_node_t *nodes[BFDEV_BTREE_LEVELS];
+    unsigned int fills[BFDEV_BTREE_LEVELS];
+    unsigned int levels;
+    unsigned int limit;
+};
+
+static void
+bnode_reverse(bfdev_btree_root_t *root, bfdev_btree_node_t *node,
+              unsigned int fill)
+{
+    bfdev_btree_layout_t *layout;
+    uintptr_t *lkey, *rkey;
+    unsigned int index, count;
+    void *value;
+
+    layout = root->layout;
+    for (index = 0; index < fill / 2; ++index) {
+        lkey = bnode_get_key(root, node, index);
+        rkey = bnode_get_key(root, node, fill - index - 1);
+        for (count = 0; count < layout->keylen; ++count)
+            bfdev_swap(lkey[count], rkey[count]);
+
+        value = bnode_get_value(root, node, index);
+        bnode_set_value(root, node, index,
+                        bnode_get_value(root, node, fill - index - 1));
+        bnode_set_value(root, node, fill - index - 1, value);
+    }
+}
+
+static void
+bulk_destroy(bfdev_btree_root_t *root, bfdev_btree_node_t *node,
+             unsigned int level)
+{
+    unsigned int index, fill;
+
+    if (level) {
+        fill = bnode_fill_index(root, node, 0);
+        for (index = 0; index < fill; ++index)
+            bulk_destroy(root, bnode_get_value(root, node, index), level - 1);
+    }
+
+    bnode_free(root, node);
+}
+
+static int
+bulk_push(bfdev_btree_root_t *root, struct btree_bulk *bulk,
+          unsigned int level, uintptr_t *key, void *value);
+
+static int
+bulk_close(bfdev_btree_root_t *root, struct btree_bulk *bulk,
+           unsigned int level)
+{
+    bfdev_btree_node_t *node;
+    int retval;
+
+    /* Entries arrive in ascending order, nodes keep them descending */
+    node = bulk->nodes[level];
+    bnode_reverse(root, node, bulk->fills[level]);
+    bulk->nodes[level] = NULL;
+
+    /* Parents index their children by the smallest key */
+    retval = bulk_push(root, bulk, level + 1,
+                       bnode_get_key(root, node, bulk->fills[level] - 1), node);
+    if (bfdev_unlikely(retval)) {
+        bnode_reverse(root, node, bulk->fills[level]);
+        bulk->nodes[level] = node;
+    }
+
+    return retval;
+}
+
+static int
+bulk_push(bfdev_btree_root_t *root, struct btree_bulk *bulk,
+          unsigned int level, uintptr_t *key, void *value)
+{
+    bfdev_btree_node_t *node;
+    int retval;
+
+    if (bfdev_unlikely(level >= BFDEV_BTREE_LEVELS))
+        return -BFDEV_EOVERFLOW;
+
+    if (bulk->nodes[level] && bulk->fills[level] == bulk->limit) {
+        retval = bulk_close(root, bulk, level);
+        if (bfdev_unlikely(retval))
+            return retval;
+    }
+
+    node = bulk->nodes[level];
+    if (!node) {
+        node = bnode_alloc(root);
+        if (bfdev_unlikely(!node))
+            return -BFDEV_ENOMEM;
+
+        bulk->nodes[level] = node;
+        bulk->fills[level] = 0;
+        if (level >= bulk->levels)
+            bulk->levels = level + 1;
+    }
+
+    bnode_set_key(root, node, bulk->fills[level], key);
+    bnode_set_value(root, node, bulk->fills[level]++, value);
+
+    return -BFDEV_ENOERR;
+}
+
+/*
+ * The last node of a level gets whatever is left over. Fold it into
+ * its left sibling, the last child pushed into the parent, or even
+ * the two out, so that the first removals there do not merge.
+ */
+static void
+bulk_balance(bfdev_btree_root_t *root, struct btree_bulk *bulk,
+             unsigned int level)
+{
+    bfdev_btree_layout_t *layout;
+    bfdev_btree_node_t *node, *prev;
+    unsigned int fill, pfill, move, index;
+
+    layout = root->layout;
+    fill = bulk->fills[level];
+    if (fill >= layout->keynum / 2)
+        return;
+
+    node = bulk->nodes[level];
+    prev = bnode_get_value(root, bulk->nodes[level + 1],
+                           bulk->fills[level + 1] - 1);
+    pfill = bnode_fill_index(root, prev, 0);
+
+    if (pfill + fill <= layout->keynum) {
+        /* The sibling is descending, larger entries go in front */
+        for (index = pfill; index--;)
+            bnode_migrate(root, prev, index + fill, prev, index);
+        for (index = 0; index < fill; ++index)
+            bnode_migrate(root, prev, fill - index - 1, node, index);
+
+        bnode_free(root, node);
+        bulk->nodes[level] = NULL;
+        return;
+    }
+
+    /* The node is still ascending, make room at the front */
+    move = (pfill - fill) / 2;
+    for (index = fill; index--;)
+        bnode_migrate(root, node, index + move, node, index);
+    for (index = 0; index < move; ++index)
+        bnode_migrate(root, node, move - index - 1, prev, index);
+
+    for (index = move; index < pfill; ++index)
+        bnode_migrate(root, prev, index - move, prev, index);
+    for (index = pfill - move; index < pfill; ++index)
+        bnode_clear_index(root, prev, index);
+
+    bulk->fills[level] = fill + move;
+}
+
+export int
+bfdev_btree_bulk_load(bfdev_btree_root_t *root, unsigned int fill,
+                      bfdev_btree_stream_t stream, void *pdata)
+{
+    const bfdev_btree_ops_t *ops;
+    bfdev_btree_layout_t *layout;
+    struct btree_bulk bulk;
+    uintptr_t *key, *prev;
+    unsigned int level;
+    void *value;
+    int retval;
+
+    if (bfdev_unlikely(!fill || fill > 100))
+        return -BFDEV_EINVAL;
+
+    if (bfdev_unlikely(root->height))
+        return -BFDEV_EBUSY;
+
+    layout = root->layout;
+    ops = root->ops;
+
+    key = bfdev_alloca(sizeof(uintptr_t) * layout->keylen);
+    prev = bfdev_alloca(sizeof(uintptr_t) * layout->keylen);
+
+    bfport_memset(&bulk, 0, sizeof(bulk));
+    bulk.limit = layout->keynum * fill / 100;
+    if (bulk.limit < 2)
+        bulk.limit = 2;
+
+    while ((value = stream(key, pdata))) {
+        /* Duplicated or unsorted keys can not be packed bottom-up */
+        if (bulk.levels && ops->find(root, prev, key) >= 0) {
+            retval = -BFDEV_EINVAL;
+            goto failed;
+        }
+
+        retval = bulk_push(root, &bulk, 0, key, value);
+        if (bfdev_unlikely(retval))
+            goto failed;
+
+        bfdev_btree_key_copy(root, prev, key);
+    }
+
+    for (level = 0; level < bulk.levels; ++level) {
+        if (!bulk.nodes[level])
+            continue;
+
+        /* The only node left on the top level becomes the root */
+        if (level + 1 == bulk.levels) {
+            if (level && bulk.fills[level] == 1) {
+                /* Folding may leave a single child to take its place */
+                root->node = bnode_get_value(root, bulk.nodes[level], 0);
+                root->height = level;
+                bnode_free(root, bulk.nodes[level]);
+                break;
+            }
+
+            bnode_reverse(root, bulk.nodes[level], bulk.fills[level]);
+            root->node = bulk.nodes[level];
+            root->height = bulk.levels;
+            break;
+        }
+
+        bulk_balance(root, &bulk, level);
+        if (!bulk.nodes[level])
+            continue;
+
+        retval = bulk_close(root, &bulk, level);
+        if (bfdev_unlikely(retval))
+            goto failed;
+    }
+
+    return -BFDEV_ENOERR;
+
+failed:
+    for (level = 0; level < bulk.levels; ++level) {
+        if (bulk.nodes[level])
+            bulk_destroy(root, bulk.nodes[level], level);
+    }
+
+    return retval;
+}
+
+static bool
+cursor_covers(bfdev_btree_cursor_t *cursor, uintptr_t *key)
+{
+    bfdev_btree_root_t *root;
+    unsigned int level, index;
+
+    root = cursor->root;
+    if (cursor->depth < 2)
+        return true;
+
+    /* Below the smallest key the parent routes to this leaf */
+    if (bnode_cmp_key(root, cursor->nodes[1], cursor->index[1], key) > 0)
+        return false;
+
+    /* The nearest left sibling on the path bounds it from above */
+    for (level = 1; level < cursor->depth; ++level) {
+        index = cursor->index[level];
+        if (index)
+            return bnode_cmp_key(root, cursor->nodes[level], index - 1, key) > 0;
+    }
+
+    return true;
+}
+
+static int
+batch_append(bfdev_btree_root_t *root, uintptr_t *key, void *value)
+{
+    bfdev_btree_node_t *node;
+    int retval;
+
+    node = bnode_alloc(root);
+    if (bfdev_unlikely(!node))
+        return -BFDEV_ENOMEM;
+
+    bnode_set_key(root, node, 0, key);
+    bnode_set_value(root, node, 0, value);
+
+    retval = insert_level(root, 2, key, node);
+    if (bfdev_unlikely(retval))
+        bnode_free(root, node);
+
+    return retval;
+}
+
+export int
+bfdev_btree_insert_batch(bfdev_btree_root_t *root,
+                         bfdev_btree_stream_t stream, void *pdata)
+{
+    bfdev_btree_layout_t *layout;
+    bfdev_btree_cursor_t cursor;
+    bfdev_btree_node_t *node;
+    unsigned int index, fill, count;
+    uintptr_t *key;
+    void *value;
+    int retval;
+
+    layout = root->layout;
+    key = bfdev_alloca(sizeof(uintptr_t) * layout->keylen);
+    bfdev_btree_cursor_init(&cursor, root);
+
+    while ((value = stream(key, pdata))) {
+        if (cursor.depth && cursor_covers(&cursor, key)) {
+            node = cursor.nodes[0];
+            index = bnode_find_index(root, node, key);
+            fill = bnode_fill_index(root, node, 0);
+
+            if (index == fill ||
+                (index < fill && bnode_cmp_key(root, node, index, key))) {
+                if (fill < layout->keynum) {
+                    for (count = fill; count > index; --count)
+                        bnode_migrate(root, node, count, node, count - 1);
+
+                    bnode_set_key(root, node, index, key);
+                    bnode_set_value(root, node, index, value);
+                    continue;
+                }
+
+                /* Appending past a full leaf opens a new one, not a split */
+                if (!index) {
+                    retval = batch_append(root, key, value);
+                    if (bfdev_unlikely(retval))
+                        return retval;
+
+                    bfdev_btree_cursor_seek(&cursor, key);
+                    continue;
+                }
+            }
+        }
+
+        /* Splits and clashes take the regular path, the cursor follows */
+        retval = bfdev_btree_insert(root, key, value);
+        if (bfdev_unlikely(retval))
+            return retval;
+
+        bfdev_btree_cursor_seek(&cursor, key);
+    }
+
+    return -BFDEV_ENOERR;
+}
+
+export unsigned long
+bfdev_btree_remove_range(bfdev_btree_root_t *root, uintptr_t *min,
+                         uintptr_t *max, bfdev_release_t release,
+                         void *pdata)
+{
+    const bfdev_btree_ops_t *ops;
+    bfdev_btree_layout_t *layout;
+    bfdev_btree_cursor_t cursor;
+    bfdev_btree_node_t *node;
+    unsigned int index, end, fill, count, number;
+    unsigned long removed;
+    uintptr_t *key;
+    void **values, *clash;
+
+    layout = root->layout;
+    ops = root->ops;
+
+    key = bfdev_alloca(sizeof(uintptr_t) * layout->keylen);
+    values = bfdev_alloca(sizeof(*values) * layout->keynum);
+    bfdev_btree_cursor_init(&cursor, root);
+    removed = 0;
+
+    /* Every round drops the covered part of one leaf */
+    while (bfdev_btree_cursor_seek(&cursor, max)) {
+        node = cursor.nodes[0];
+        index = cursor.index[0];
+        fill = bnode_fill_index(root, node, index);
+
+        for (end = index; end < fill; ++end) {
+            if (bnode_cmp_key(root, node, end, min) < 0)
+                break;
+            values[end - index] = bnode_get_value(root, node, end);
+        }
+
+        number = end - index;
+        if (!number)
+            break;
+
+        /* Any removed key still routes to this leaf */
+        bnode_takeout_key(root, node, index, key);
+        removed += number;
+
+        for (count = index; end < fill; ++count, ++end)
+            bnode_migrate(root, node, count, node, end);
+
+        fill = count;
+        for (; count < end; ++count)
+            bnode_clear_index(root, node, count);
+
+        if (fill < layout->keynum / 2 && root->height > 1)
+            remove_rebalance(root, 1, key, node, fill);
+
+        /* Values may own their keys, release them after routing */
+        for (count = 0; count < number; ++count) {
+            while (ops->remove && (clash = ops->remove(root, values[count]))) {
+                if (release)
+                    release(clash, pdata);
+            }
+
+            if (release)
+                release(values[count], pdata);
+        }
+    }
+
+    return removed;
+}
+
 export void
 bfdev_btree_release(bfdev_btree_root_t *root, bfdev_release_t release,
                     void *pdata)
@@ -690,3 +1096,157 @@ bfdev_btree_prev(bfdev_btree_root_t *root, uintptr_t *key)
     bnode_takeout_key(root, node, index, key);
     return bnode_get_value(root, node, index);
 }
+
+static void *
+cursor_descend(bfdev_btree_cursor_t *cursor, unsigned int level, bool last)
+{
+    bfdev_btree_root_t *root;
+    bfdev_btree_node_t *node;
+
+    root = cursor->root;
+    node = cursor->nodes[level];
+
+    while (level--) {
+        node = bnode_get_value(root, node, cursor->index[level + 1]);
+        cursor->nodes[level] = node;
+        cursor->index[level] = last ? bnode_fill_index(root, node, 0) - 1 : 0;
+    }
+
+    return bnode_get_value(root, node, cursor->index[0]);
+}
+
+static void *
+cursor_advance(bfdev_btree_cursor_t *cursor, unsigned int level)
+{
+    bfdev_btree_layout_t *layout;
+    bfdev_btree_root_t *root;
+    bfdev_btree_node_t *node;
+    unsigned int index;
+
+    root = cursor->root;
+    layout = root->layout;
+
+    /* Climb only as long as the slot ran past its node */
+    for (; level < cursor->depth; ++level) {
+        node = cursor->nodes[level];
+        index = cursor->index[level];
+
+        if (index < layout->keynum && bnode_get_value(root, node, index))
+            return cursor_descend(cursor, level, false);
+
+        if (level + 1 < cursor->depth)
+            cursor->index[level + 1]++;
+    }
+
+    cursor->depth = 0;
+    return NULL;
+}
+
+static void *
+cursor_retreat(bfdev_btree_cursor_t *cursor, unsigned int level)
+{
+    for (; level < cursor->depth; ++level) {
+        if (cursor->index[level]) {
+            cursor->index[level]--;
+            return cursor_descend(cursor, level, true);
+        }
+    }
+
+    cursor->depth = 0;
+    return NULL;
+}
+
+static bool
+cursor_start(bfdev_btree_cursor_t *cursor)
+{
+    bfdev_btree_root_t *root;
+    unsigned int height;
+
+    root = cursor->root;
+    height = root->height;
+
+    if (bfdev_unlikely(!height || height > BFDEV_BTREE_LEVELS)) {
+        cursor->depth = 0;
+        return false;
+    }
+
+    cursor->depth = height;
+    cursor->nodes[height - 1] = root->node;
+
+    return true;
+}
+
+export void *
+bfdev_btree_cursor_first(bfdev_btree_cursor_t *cursor)
+{
+    if (!cursor_start(cursor))
+        return NULL;
+
+    cursor->index[cursor->depth - 1] = 0;
+    return cursor_advance(cursor, cursor->depth - 1);
+}
+
+export void *
+bfdev_btree_cursor_last(bfdev_btree_cursor_t *cursor)
+{
+    bfdev_btree_root_t *root;
+
+    if (!cursor_start(cursor))
+        return NULL;
+
+    root = cursor->root;
+    cursor->index[cursor->depth - 1] = bnode_fill_index(root, root->node, 0);
+
+    return cursor_retreat(cursor, cursor->depth - 1);
+}
+
+export void *
+bfdev_btree_cursor_seek(bfdev_btree_cursor_t *cursor, uintptr_t *key)
+{
+    bfdev_btree_layout_t *layout;
+    bfdev_btree_root_t *root;
+    bfdev_btree_node_t *node;
+    unsigned int level, index;
+
+    if (!cursor_start(cursor))
+        return NULL;
+
+    root = cursor->root;
+    layout = root->layout;
+
+    for (level = cursor->depth - 1;; --level) {
+        node = cursor->nodes[level];
+        index = bnode_find_index(root, node, key);
+        cursor->index[level] = index;
+
+        /* Nothing below the key here, carry on with the next subtree */
+        if (index == layout->keynum || !bnode_get_value(root, node, index))
+            return cursor_advance(cursor, level);
+
+        if (!level)
+            break;
+
+        cursor->nodes[level - 1] = bnode_get_value(root, node, index);
+    }
+
+    return bnode_get_value(root, node, index);
+}
+
+export void *
+bfdev_btree_cursor_next(bfdev_btree_cursor_t *cursor)
+{
+    if (bfdev_unlikely(!cursor->depth))
+        return NULL;
+
+    cursor->index[0]++;
+    return cursor_advance(cursor, 0);
+}
+
+export void *
+bfdev_btree_cursor_prev(bfdev_btree_cursor_t *cursor)
+{
+    if (bfdev_unlikely(!cursor->depth))
+        return NULL;
+
+    return cursor_retreat(cursor, 0);
+}
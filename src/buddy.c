@@ -0,0 +1,243 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/buddy.h>
+#include <bfdev/bitmap.h>
+#include <bfdev/bitops.h>
+#include <bfdev/log2.h>
+#include <bfdev/minmax.h>
+#include <export.h>
+
+static __bfdev_always_inline void *
+buddy_block(bfdev_buddy_t *buddy, unsigned long pfn)
+{
+    return buddy->base + (pfn << buddy->shift);
+}
+
+static __bfdev_always_inline unsigned long
+buddy_pfn(bfdev_buddy_t *buddy, void *block)
+{
+    return (block - buddy->base) >> buddy->shift;
+}
+
+static void
+buddy_free_add(bfdev_buddy_t *buddy, unsigned long pfn, unsigned int order)
+{
+    bfdev_list_head_t *node;
+
+    node = buddy_block(buddy, pfn);
+    bfdev_list_add(&buddy->free[order], node);
+    bfdev_bit_set(buddy->bitmap[order], pfn >> order);
+}
+
+static void
+buddy_free_del(bfdev_buddy_t *buddy, unsigned long pfn, unsigned int order)
+{
+    bfdev_list_head_t *node;
+
+    node = buddy_block(buddy, pfn);
+    bfdev_list_del(node);
+    bfdev_bit_clr(buddy->bitmap[order], pfn >> order);
+}
+
+export unsigned int
+bfdev_buddy_order(bfdev_buddy_t *buddy, size_t size)
+{
+    unsigned long pages;
+
+    pages = (size + BFDEV_BIT(buddy->shift) - 1) >> buddy->shift;
+    if (pages <= 1)
+        return 0;
+
+    return bfdev_ilog2(pages - 1) + 1;
+}
+
+export __bfdev_malloc void *
+bfdev_buddy_alloc(bfdev_buddy_t *buddy, unsigned int order)
+{
+    bfdev_list_head_t *node;
+    unsigned long pfn;
+    unsigned int walk;
+
+    for (walk = order; walk < BFDEV_BUDDY_ORDERS; ++walk) {
+        if (!bfdev_list_check_empty(&buddy->free[walk]))
+            break;
+    }
+
+    if (bfdev_unlikely(walk >= BFDEV_BUDDY_ORDERS))
+        return NULL;
+
+    node = buddy->free[walk].next;
+    pfn = buddy_pfn(buddy, node);
+    buddy_free_del(buddy, pfn, walk);
+
+    /* Hand the upper halves back until the block fits */
+    while (walk > order) {
+        walk--;
+        buddy_free_add(buddy, pfn + BFDEV_BIT(walk), walk);
+    }
+
+    buddy->orders[pfn] = order;
+    buddy->avail -= BFDEV_BIT(order);
+
+    return buddy_block(buddy, pfn);
+}
+
+export void
+bfdev_buddy_free(bfdev_buddy_t *buddy, void *block)
+{
+    unsigned long pfn, other;
+    unsigned int order;
+
+    pfn = buddy_pfn(buddy, block);
+    order = buddy->orders[pfn];
+    buddy->avail += BFDEV_BIT(order);
+
+    while (order < BFDEV_BUDDY_ORDERS - 1) {
+        other = pfn ^ BFDEV_BIT(order);
+        if (other + BFDEV_BIT(order) > buddy->pages ||
+            !bfdev_bit_test(buddy->bitmap[order], other >> order))
+            break;
+
+        buddy_free_del(buddy, other, order);
+        pfn &= ~BFDEV_BIT(order);
+        order++;
+    }
+
+    buddy_free_add(buddy, pfn, order);
+}
+
+static void *
+buddy_adapter_alloc(size_t size, void *pdata)
+{
+    bfdev_buddy_t *buddy;
+
+    buddy = pdata;
+
+    return bfdev_buddy_alloc(buddy, bfdev_buddy_order(buddy, size));
+}
+
+static void *
+buddy_adapter_zalloc(size_t size, void *pdata)
+{
+    void *block;
+
+    block = buddy_adapter_alloc(size, pdata);
+    if (bfdev_likely(block))
+        bfport_memset(block, 0, size);
+
+    return block;
+}
+
+static void
+buddy_adapter_free(void *block, void *pdata)
+{
+    bfdev_buddy_free(pdata, block);
+}
+
+static void *
+buddy_adapter_realloc(void *block, size_t resize, void *pdata)
+{
+    bfdev_buddy_t *buddy;
+    unsigned int order;
+    void *retval;
+
+    buddy = pdata;
+    if (!block)
+        return buddy_adapter_alloc(resize, pdata);
+
+    order = buddy->orders[buddy_pfn(buddy, block)];
+    if (bfdev_buddy_order(buddy, resize) <= order)
+        return block;
+
+    retval = buddy_adapter_alloc(resize, pdata);
+    if (bfdev_unlikely(!retval))
+        return NULL;
+
+    bfport_memcpy(retval, block, BFDEV_BIT(order) << buddy->shift);
+    bfdev_buddy_free(buddy, block);
+
+    return retval;
+}
+
+static size_t
+buddy_meta_size(unsigned long pages)
+{
+    unsigned int order;
+    size_t size;
+
+    size = bfdev_align_high(pages, sizeof(unsigned long));
+    for (order = 0; order < BFDEV_BUDDY_ORDERS; ++order)
+        size += BFDEV_BITS_TO_LONG((pages >> order) + 1) * sizeof(unsigned long);
+
+    return size;
+}
+
+static size_t
+buddy_layout(void *memory, size_t page, unsigned long pages)
+{
+    uintptr_t start;
+
+    start = (uintptr_t)memory + buddy_meta_size(pages);
+    start = bfdev_align_high(start, page);
+
+    return start - (uintptr_t)memory + pages * page;
+}
+
+export int
+bfdev_buddy_init(bfdev_buddy_t *buddy, void *memory, size_t size, size_t page)
+{
+    unsigned long pages, pfn;
+    unsigned int order;
+    void *walk;
+    size_t need;
+
+    if (bfdev_unlikely(page < sizeof(bfdev_list_head_t) ||
+                       (page & (page - 1))))
+        return -BFDEV_EINVAL;
+
+    /* Trade pages for bookkeeping until everything fits */
+    pages = size / page;
+    while (pages && (need = buddy_layout(memory, page, pages)) > size)
+        pages -= bfdev_min(pages, (unsigned long)((need - size) / page + 1));
+
+    if (bfdev_unlikely(!pages))
+        return -BFDEV_ENOMEM;
+
+    buddy->shift = bfdev_ilog2(page);
+    buddy->pages = pages;
+    buddy->avail = pages;
+
+    walk = memory;
+    buddy->orders = walk;
+    walk += bfdev_align_high(pages, sizeof(unsigned long));
+
+    for (order = 0; order < BFDEV_BUDDY_ORDERS; ++order) {
+        bfdev_list_head_init(&buddy->free[order]);
+        buddy->bitmap[order] = walk;
+        bfdev_bitmap_zero(walk, (pages >> order) + 1);
+        walk += BFDEV_BITS_TO_LONG((pages >> order) + 1) *
+                sizeof(unsigned long);
+    }
+
+    buddy->base = bfdev_align_ptr_high(walk, page);
+
+    /* Seed with the largest naturally aligned blocks */
+    for (pfn = 0; pfn < pages; pfn += BFDEV_BIT(order)) {
+        order = BFDEV_BUDDY_ORDERS - 1;
+        while ((pfn & (BFDEV_BIT(order) - 1)) ||
+               pfn + BFDEV_BIT(order) > pages)
+            order--;
+        buddy_free_add(buddy, pfn, order);
+    }
+
+    bfdev_alloc_ops_init(&buddy->ops, buddy_adapter_alloc,
+                         buddy_adapter_zalloc, buddy_adapter_realloc,
+                         buddy_adapter_free);
+    bfdev_alloc_init(&buddy->allocator, &buddy->ops, buddy);
+
+    return -BFDEV_ENOERR;
+}
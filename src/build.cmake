@@ -7,6 +7,8 @@ set(BFDEV_SOURCE
     ${BFDEV_SOURCE}
     ${CMAKE_CURRENT_LIST_DIR}/allocator.c
     ${CMAKE_CURRENT_LIST_DIR}/allocpool.c
+    ${CMAKE_CURRENT_LIST_DIR}/allocprof.c
+    ${CMAKE_CURRENT_LIST_DIR}/arena.c
     ${CMAKE_CURRENT_LIST_DIR}/argv.c
     ${CMAKE_CURRENT_LIST_DIR}/array.c
     ${CMAKE_CURRENT_LIST_DIR}/bcd.c
@@ -14,17 +16,24 @@ set(BFDEV_SOURCE
     ${CMAKE_CURRENT_LIST_DIR}/bitrev.c
     ${CMAKE_CURRENT_LIST_DIR}/bitwalk.c
     ${CMAKE_CURRENT_LIST_DIR}/bloom.c
+    ${CMAKE_CURRENT_LIST_DIR}/broadcast.c
     ${CMAKE_CURRENT_LIST_DIR}/bsearch.c
     ${CMAKE_CURRENT_LIST_DIR}/btree.c
     ${CMAKE_CURRENT_LIST_DIR}/btree-utils.c
+    ${CMAKE_CURRENT_LIST_DIR}/buddy.c
     ${CMAKE_CURRENT_LIST_DIR}/dword.c
     ${CMAKE_CURRENT_LIST_DIR}/callback.c
+    ${CMAKE_CURRENT_LIST_DIR}/epoch.c
     ${CMAKE_CURRENT_LIST_DIR}/errname.c
     ${CMAKE_CURRENT_LIST_DIR}/fifo.c
+    ${CMAKE_CURRENT_LIST_DIR}/fifo-mpmc.c
+    ${CMAKE_CURRENT_LIST_DIR}/fifo-spsc.c
+    ${CMAKE_CURRENT_LIST_DIR}/flatmap.c
     ${CMAKE_CURRENT_LIST_DIR}/fsm.c
     ${CMAKE_CURRENT_LIST_DIR}/glob.c
     ${CMAKE_CURRENT_LIST_DIR}/hashmap.c
     ${CMAKE_CURRENT_LIST_DIR}/heap.c
+    ${CMAKE_CURRENT_LIST_DIR}/hugealloc.c
     ${CMAKE_CURRENT_LIST_DIR}/ilist.c
     ${CMAKE_CURRENT_LIST_DIR}/jhash.c
     ${CMAKE_CURRENT_LIST_DIR}/levenshtein.c
@@ -32,6 +41,7 @@ set(BFDEV_SOURCE
     ${CMAKE_CURRENT_LIST_DIR}/llist.c
     ${CMAKE_CURRENT_LIST_DIR}/matrix.c
     ${CMAKE_CURRENT_LIST_DIR}/memalloc.c
+    ${CMAKE_CURRENT_LIST_DIR}/mirror.c
     ${CMAKE_CURRENT_LIST_DIR}/mpi.c
     ${CMAKE_CURRENT_LIST_DIR}/notifier.c
     ${CMAKE_CURRENT_LIST_DIR}/popcount.c
@@ -44,7 +54,9 @@ set(BFDEV_SOURCE
     ${CMAKE_CURRENT_LIST_DIR}/ringbuf.c
     ${CMAKE_CURRENT_LIST_DIR}/scnprintf.c
     ${CMAKE_CURRENT_LIST_DIR}/segtree.c
+    ${CMAKE_CURRENT_LIST_DIR}/shardmap.c
     ${CMAKE_CURRENT_LIST_DIR}/skiplist.c
+    ${CMAKE_CURRENT_LIST_DIR}/slab.c
     ${CMAKE_CURRENT_LIST_DIR}/sort.c
     ${CMAKE_CURRENT_LIST_DIR}/stringhash.c
     ${CMAKE_CURRENT_LIST_DIR}/tokenbucket.c
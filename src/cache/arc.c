@@ -0,0 +1,402 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/cache.h>
+#include <bfdev/hashtbl.h>
+#include <bfdev/minmax.h>
+
+enum arc_list {
+    ARC_NONE = 0,
+    ARC_T1,
+    ARC_T2,
+    ARC_B1,
+    ARC_B2,
+};
+
+/*
+ * Ghost entries only remember the hash of an evicted tag, the tag
+ * itself is owned by the user and may already be gone. A ghost hit
+ * is therefore a hint, which is all the adaptation needs.
+ */
+struct arc_ghost {
+    bfdev_hlist_node_t hash;
+    bfdev_list_head_t list;
+    unsigned long value;
+    enum arc_list which;
+};
+
+struct arc_head {
+    bfdev_cache_head_t cache;
+    bfdev_list_head_t t1, t2;
+    bfdev_list_head_t b1, b2;
+    bfdev_list_head_t gfree;
+
+    bfdev_hlist_head_t *ghash;
+    struct arc_ghost *ghosts;
+
+    /* target size of t1 */
+    unsigned long p;
+    unsigned long t1_size, t2_size;
+    unsigned long b1_size, b2_size;
+
+    /* ghost list hit by the current miss */
+    enum arc_list hit;
+};
+
+struct arc_node {
+    bfdev_cache_node_t cache;
+    bfdev_list_head_t node;
+    enum arc_list which;
+};
+
+#define cache_to_arc_head(ptr) \
+    bfdev_container_of(ptr, struct arc_head, cache)
+
+#define cache_to_arc_node(ptr) \
+    bfdev_container_of(ptr, struct arc_node, cache)
+
+static __bfdev_always_inline unsigned long
+arc_hash(bfdev_cache_head_t *head, const void *tag)
+{
+    const bfdev_cache_ops_t *ops;
+
+    ops = head->ops;
+
+    return ops->hash(tag, head->pdata);
+}
+
+static void
+arc_ghost_del(struct arc_head *arc_head, struct arc_ghost *ghost)
+{
+    if (ghost->which == ARC_B1)
+        arc_head->b1_size--;
+    else
+        arc_head->b2_size--;
+
+    bfdev_hlist_del(&ghost->hash);
+    bfdev_list_move(&arc_head->gfree, &ghost->list);
+    ghost->which = ARC_NONE;
+}
+
+static void
+arc_ghost_add(struct arc_head *arc_head, enum arc_list which,
+              unsigned long value)
+{
+    bfdev_cache_head_t *head;
+    struct arc_ghost *ghost;
+
+    head = &arc_head->cache;
+
+    /* Keep |T1| + |B1| <= c */
+    if (which == ARC_B1 && arc_head->b1_size &&
+        arc_head->t1_size + arc_head->b1_size >= head->size) {
+        ghost = bfdev_list_last_entry(&arc_head->b1, struct arc_ghost, list);
+        arc_ghost_del(arc_head, ghost);
+    }
+
+    /* Keep the directory within 2c */
+    if (bfdev_list_check_empty(&arc_head->gfree)) {
+        if (arc_head->b2_size)
+            ghost = bfdev_list_last_entry(&arc_head->b2, struct arc_ghost, list);
+        else
+            ghost = bfdev_list_last_entry(&arc_head->b1, struct arc_ghost, list);
+        arc_ghost_del(arc_head, ghost);
+    }
+
+    ghost = bfdev_list_first_entry(&arc_head->gfree, struct arc_ghost, list);
+    ghost->value = value;
+    ghost->which = which;
+
+    if (which == ARC_B1) {
+        bfdev_list_move(&arc_head->b1, &ghost->list);
+        arc_head->b1_size++;
+    } else {
+        bfdev_list_move(&arc_head->b2, &ghost->list);
+        arc_head->b2_size++;
+    }
+
+    bfdev_hashtbl_add(arc_head->ghash, head->size, &ghost->hash, value);
+}
+
+static struct arc_ghost *
+arc_ghost_find(struct arc_head *arc_head, unsigned long value)
+{
+    struct arc_ghost *ghost;
+    unsigned long index;
+
+    index = bfdev_hashtbl_index(arc_head->cache.size, value);
+    bfdev_hashtbl_for_each_idx_entry(ghost, arc_head->ghash,
+                                     arc_head->cache.size, hash, index) {
+        if (ghost->value == value)
+            return ghost;
+    }
+
+    return NULL;
+}
+
+static bool
+arc_starving(bfdev_cache_head_t *head)
+{
+    struct arc_head *arc_head;
+
+    arc_head = cache_to_arc_head(head);
+
+    return bfdev_list_check_empty(&arc_head->t1) &&
+           bfdev_list_check_empty(&arc_head->t2);
+}
+
+static void
+arc_miss(bfdev_cache_head_t *head, const void *tag)
+{
+    struct arc_head *arc_head;
+    struct arc_ghost *ghost;
+    unsigned long delta;
+
+    arc_head = cache_to_arc_head(head);
+    arc_head->hit = ARC_NONE;
+
+    ghost = arc_ghost_find(arc_head, arc_hash(head, tag));
+    if (!ghost)
+        return;
+
+    /* Adapt the target toward the list whose ghost was hit */
+    if (ghost->which == ARC_B1) {
+        delta = bfdev_max(arc_head->b2_size / arc_head->b1_size, 1UL);
+        arc_head->p = bfdev_min(arc_head->p + delta, head->size);
+    } else {
+        delta = bfdev_max(arc_head->b1_size / arc_head->b2_size, 1UL);
+        arc_head->p = arc_head->p > delta ? arc_head->p - delta : 0;
+    }
+
+    arc_head->hit = ghost->which;
+    arc_ghost_del(arc_head, ghost);
+}
+
+static bfdev_cache_node_t *
+arc_obtain(bfdev_cache_head_t *head)
+{
+    struct arc_head *arc_head;
+    struct arc_node *arc_node;
+    bfdev_list_head_t *victim;
+    bool from_t1;
+
+    arc_head = cache_to_arc_head(head);
+
+    if (bfdev_list_check_empty(&arc_head->t2))
+        from_t1 = true;
+    else if (bfdev_list_check_empty(&arc_head->t1))
+        from_t1 = false;
+    else
+        from_t1 = arc_head->t1_size > arc_head->p ||
+            (arc_head->hit == ARC_B2 && arc_head->t1_size == arc_head->p);
+
+    victim = from_t1 ? &arc_head->t1 : &arc_head->t2;
+    arc_node = bfdev_list_last_entry(victim, struct arc_node, node);
+    bfdev_list_del(&arc_node->node);
+
+    if (from_t1)
+        arc_head->t1_size--;
+    else
+        arc_head->t2_size--;
+
+    arc_ghost_add(arc_head, from_t1 ? ARC_B1 : ARC_B2,
+                  arc_hash(head, arc_node->cache.tag));
+    arc_node->which = ARC_NONE;
+
+    return &arc_node->cache;
+}
+
+static void
+arc_get(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct arc_node *arc_node;
+
+    arc_node = cache_to_arc_node(node);
+
+    bfdev_list_del(&arc_node->node);
+}
+
+static void
+arc_put(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct arc_head *arc_head;
+    struct arc_node *arc_node;
+
+    arc_head = cache_to_arc_head(head);
+    arc_node = cache_to_arc_node(node);
+
+    if (arc_node->which == ARC_T2)
+        bfdev_list_add(&arc_head->t2, &arc_node->node);
+    else
+        bfdev_list_add(&arc_head->t1, &arc_node->node);
+}
+
+static void
+arc_update(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct arc_head *arc_head;
+    struct arc_node *arc_node;
+
+    arc_head = cache_to_arc_head(head);
+    arc_node = cache_to_arc_node(node);
+
+    /* Second reference promotes to the frequency side */
+    if (arc_node->which == ARC_T1) {
+        arc_node->which = ARC_T2;
+        arc_head->t1_size--;
+        arc_head->t2_size++;
+    }
+}
+
+static void
+arc_clear(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct arc_head *arc_head;
+    struct arc_node *arc_node;
+
+    arc_head = cache_to_arc_head(head);
+    arc_node = cache_to_arc_node(node);
+
+    /* Deleted nodes are still accounted until reused */
+    if (arc_node->which == ARC_T1)
+        arc_head->t1_size--;
+    else if (arc_node->which == ARC_T2)
+        arc_head->t2_size--;
+
+    if (arc_head->hit != ARC_NONE) {
+        arc_node->which = ARC_T2;
+        arc_head->t2_size++;
+    } else {
+        arc_node->which = ARC_T1;
+        arc_head->t1_size++;
+    }
+}
+
+static void
+arc_reset(bfdev_cache_head_t *head)
+{
+    struct arc_head *arc_head;
+    struct arc_node *arc_node;
+    unsigned long count;
+
+    arc_head = cache_to_arc_head(head);
+
+    bfdev_list_head_init(&arc_head->t1);
+    bfdev_list_head_init(&arc_head->t2);
+    bfdev_list_head_init(&arc_head->b1);
+    bfdev_list_head_init(&arc_head->b2);
+    bfdev_list_head_init(&arc_head->gfree);
+    bfport_memset(arc_head->ghash, 0, sizeof(*arc_head->ghash) * head->size);
+
+    for (count = 0; count < head->size; ++count) {
+        arc_node = cache_to_arc_node(head->nodes[count]);
+        arc_node->which = ARC_NONE;
+
+        arc_head->ghosts[count].which = ARC_NONE;
+        bfdev_list_add(&arc_head->gfree, &arc_head->ghosts[count].list);
+    }
+
+    arc_head->p = 0;
+    arc_head->t1_size = arc_head->t2_size = 0;
+    arc_head->b1_size = arc_head->b2_size = 0;
+    arc_head->hit = ARC_NONE;
+}
+
+static void
+arc_release(const bfdev_alloc_t *alloc, struct arc_head *arc_head)
+{
+    bfdev_cache_head_t *head;
+
+    head = &arc_head->cache;
+    bfdev_free(alloc, arc_head->ghosts);
+    bfdev_free(alloc, arc_head->ghash);
+    bfdev_free(alloc, head->nodes);
+    bfdev_free(alloc, arc_head);
+}
+
+static bfdev_cache_head_t *
+arc_create(const bfdev_alloc_t *alloc, unsigned long size)
+{
+    bfdev_cache_head_t *head;
+    struct arc_head *arc_head;
+    struct arc_node *arc_node;
+    unsigned long count;
+
+    arc_head = bfdev_zalloc(alloc, sizeof(*arc_head));
+    if (bfdev_unlikely(!arc_head))
+        return NULL;
+
+    head = &arc_head->cache;
+    head->size = size;
+
+    head->nodes = bfdev_zalloc_array(alloc, size, sizeof(*head->nodes));
+    arc_head->ghash = bfdev_zalloc_array(alloc, size, sizeof(*arc_head->ghash));
+    arc_head->ghosts = bfdev_zalloc_array(alloc, size, sizeof(*arc_head->ghosts));
+    if (bfdev_unlikely(!head->nodes || !arc_head->ghash || !arc_head->ghosts))
+        goto free_head;
+
+    for (count = 0; count < size; ++count) {
+        arc_node = bfdev_zalloc(alloc, sizeof(*arc_node));
+        if (bfdev_unlikely(!arc_node))
+            goto free_element;
+
+        head->nodes[count] = &arc_node->cache;
+    }
+
+    arc_reset(head);
+
+    return head;
+
+free_element:
+    while (count--) {
+        arc_node = cache_to_arc_node(head->nodes[count]);
+        bfdev_free(alloc, arc_node);
+    }
+
+free_head:
+    arc_release(alloc, arc_head);
+    return NULL;
+}
+
+static void
+arc_destroy(bfdev_cache_head_t *head)
+{
+    const bfdev_alloc_t *alloc;
+    unsigned long count;
+
+    alloc = head->alloc;
+    for (count = 0; count < head->size; ++count)
+        bfdev_free(alloc, cache_to_arc_node(head->nodes[count]));
+
+    arc_release(alloc, cache_to_arc_head(head));
+}
+
+static bfdev_cache_algo_t
+arc_algorithm = {
+    .name = "arc",
+    .starving = arc_starving,
+    .miss = arc_miss,
+    .obtain = arc_obtain,
+    .get = arc_get,
+    .put = arc_put,
+    .update = arc_update,
+    .clear = arc_clear,
+    .reset = arc_reset,
+    .create = arc_create,
+    .destroy = arc_destroy,
+};
+
+static __bfdev_ctor int
+arc_init(void)
+{
+    return bfdev_cache_register(&arc_algorithm);
+}
+
+static __bfdev_dtor int
+arc_exit(void)
+{
+    return bfdev_cache_unregister(&arc_algorithm);
+}
@@ -6,6 +6,12 @@
 set(BFDEV_SOURCE
     ${BFDEV_SOURCE}
     ${CMAKE_CURRENT_LIST_DIR}/cache.c
+    ${CMAKE_CURRENT_LIST_DIR}/arc.c
+    ${CMAKE_CURRENT_LIST_DIR}/clock.c
+    ${CMAKE_CURRENT_LIST_DIR}/clockpro.c
     ${CMAKE_CURRENT_LIST_DIR}/lru.c
     ${CMAKE_CURRENT_LIST_DIR}/lfu.c
+    ${CMAKE_CURRENT_LIST_DIR}/lfuo1.c
+    ${CMAKE_CURRENT_LIST_DIR}/shard.c
+    ${CMAKE_CURRENT_LIST_DIR}/tinylfu.c
 )
@@ -6,6 +6,7 @@
 #include <base.h>
 #include <bfdev/log2.h>
 #include <bfdev/hashtbl.h>
+#include <bfdev/bitwalk.h>
 #include <bfdev/cache.h>
 #include <export.h>
 
@@ -44,6 +45,19 @@ cache_starving(bfdev_cache_head_t *head)
     return bfdev_list_check_empty(&head->freed) && head->algo->starving(head);
 }
 
+static __bfdev_always_inline bool
+cache_ring(bfdev_cache_head_t *head)
+{
+    return head->algo->flags & BFDEV_CACHE_ALGO_RING;
+}
+
+/* Ring nodes held after a hit stay resident and off the using list */
+static __bfdev_always_inline bool
+cache_pinned(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    return cache_ring(head) && bfdev_list_check_empty(&node->list);
+}
+
 static __bfdev_always_inline unsigned long
 cache_hash(bfdev_cache_head_t *head, const void *tag)
 {
@@ -56,6 +70,114 @@ cache_hash(bfdev_cache_head_t *head, const void *tag)
     return hash;
 }
 
+static __bfdev_always_inline bool
+cache_expired(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    return !bfdev_list_check_empty(&node->timer) &&
+           bfdev_time_before_equal(node->expire, head->clock);
+}
+
+static bfdev_list_head_t *
+cache_timer_slot(bfdev_cache_head_t *head, bfdev_time_t expire)
+{
+    unsigned int level, shift;
+    bfdev_time_t delta;
+    uint64_t index;
+
+    delta = bfdev_time_sub(expire, head->clock);
+    for (level = 0; level < BFDEV_CACHE_WHEEL_LEVELS - 1; ++level) {
+        if (delta < (1LL << (BFDEV_CACHE_WHEEL_BITS * (level + 1))))
+            break;
+    }
+
+    /* Beyond the wheel, park in the last slot and cascade again */
+    shift = BFDEV_CACHE_WHEEL_BITS * (level + 1);
+    if (delta >= (1LL << shift))
+        expire = bfdev_time_add(head->clock, (1LL << shift) - 1);
+
+    index = (uint64_t)expire >> (BFDEV_CACHE_WHEEL_BITS * level);
+    index &= BFDEV_CACHE_WHEEL_MASK;
+
+    return &head->wheel[level * BFDEV_CACHE_WHEEL_SLOTS + index];
+}
+
+static void
+cache_timer_add(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    bfdev_list_head_t *slot;
+
+    if (!bfdev_time_after(node->expire, head->clock)) {
+        bfdev_list_add_prev(&head->due, &node->timer);
+        return;
+    }
+
+    slot = cache_timer_slot(head, node->expire);
+    bfdev_list_add_prev(slot, &node->timer);
+    bfdev_bit_set(head->occupied, slot - head->wheel);
+    head->timers++;
+}
+
+static void
+cache_timer_del(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    bfdev_list_head_t *slot;
+
+    if (bfdev_list_check_empty(&node->timer))
+        return;
+
+    /* Timers still on the wheel always lie in the future */
+    if (bfdev_time_after(node->expire, head->clock)) {
+        head->timers--;
+
+        /* The last timer of a slot leaves it with both links */
+        slot = node->timer.prev;
+        if (slot == node->timer.next)
+            bfdev_bit_clr(head->occupied, slot - head->wheel);
+    }
+
+    bfdev_list_del_init(&node->timer);
+}
+
+static __bfdev_always_inline void
+cache_unweigh(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    head->weight -= node->cost;
+    node->cost = 0;
+}
+
+/* Drop an element that has already left the algorithm */
+static void
+cache_release(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    cache_timer_del(head, node);
+    cache_unweigh(head, node);
+    bfdev_hashtbl_del(&node->hash);
+
+    node->status = BFDEV_CACHE_FREED;
+    bfdev_list_move(&head->freed, &node->list);
+}
+
+static void
+cache_reclaim(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    cache_release(head, node);
+    head->expired++;
+}
+
+static void
+cache_trim(bfdev_cache_head_t *head)
+{
+    const bfdev_cache_algo_t *algo;
+    bfdev_cache_node_t *node;
+
+    /* Elements in use cannot go, the budget may be exceeded meanwhile */
+    algo = head->algo;
+    while (head->weight > head->budget && !algo->starving(head)) {
+        node = algo->obtain(head);
+        cache_release(head, node);
+    }
+}
+
 static __bfdev_always_inline bool
 cache_find(bfdev_cache_head_t *head, bfdev_cache_node_t *node, const char *tag)
 {
@@ -82,6 +204,13 @@ cache_lookup(bfdev_cache_head_t *head, const char *tag, bool change)
         if (!cache_find(head, walk, tag))
             continue;
 
+        /* Expired entries are reclaimed and reported as missing */
+        if (walk->status == BFDEV_CACHE_MANAGED && cache_expired(head, walk)) {
+            head->algo->get(head, walk);
+            cache_reclaim(head, walk);
+            break;
+        }
+
         if (walk->status != BFDEV_CACHE_PENDING || change)
             return walk;
 
@@ -109,10 +238,15 @@ cache_obtain(bfdev_cache_head_t *head, const char *tag)
     bfdev_cache_node_t *node;
 
     algo = head->algo;
+    if (algo->miss)
+        algo->miss(head, tag);
+
     if (bfdev_list_check_empty(&head->freed)) {
         /* Get form algos */
         node = algo->obtain(head);
         bfdev_hashtbl_del(&node->hash);
+        cache_timer_del(head, node);
+        cache_unweigh(head, node);
     } else {
         /* Get form freed */
         node = bfdev_list_first_entry(
@@ -162,16 +296,21 @@ bfdev_cache_obtain(bfdev_cache_head_t *head, const void *tag, unsigned long flag
         }
 
         algo = head->algo;
-        if (node->status == BFDEV_CACHE_MANAGED)
-            algo->get(head, node);
+        if (cache_ring(head)) {
+            /* Nothing moves, the algorithm only marks the node */
+            if (node->status == BFDEV_CACHE_MANAGED)
+                head->pinned++;
+        } else {
+            if (node->status == BFDEV_CACHE_MANAGED)
+                algo->get(head, node);
+            bfdev_list_move(&head->using, &node->list);
+        }
 
         if (algo->update)
             algo->update(head, node);
 
         if (!node->refcnt++)
             head->used++;
-
-        bfdev_list_move(&head->using, &node->list);
         node->status = BFDEV_CACHE_USING;
 
         return node;
@@ -209,11 +348,32 @@ bfdev_cache_put(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
 
     if (!--node->refcnt) {
         bfdev_cache_starving_clr(head);
-        bfdev_list_del_init(&node->list);
+        head->used--;
+
+        if (cache_pinned(head, node)) {
+            /* Never left the algorithm, only release the pin */
+            head->pinned--;
+            if (cache_expired(head, node)) {
+                head->algo->get(head, node);
+                cache_reclaim(head, node);
+                return 0;
+            }
+        } else {
+            bfdev_list_del_init(&node->list);
+
+            /* Expired while in use, reclaim on the last put */
+            if (cache_expired(head, node)) {
+                cache_reclaim(head, node);
+                return 0;
+            }
+
+            head->algo->put(head, node);
+        }
 
-        head->algo->put(head, node);
         node->status = BFDEV_CACHE_MANAGED;
-        head->used--;
+
+        if (head->budget && head->weight > head->budget)
+            cache_trim(head);
     }
 
     return node->refcnt;
@@ -251,11 +411,8 @@ bfdev_cache_del(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
         return -BFDEV_EBUSY;
 
     algo = head->algo;
-    node->status = BFDEV_CACHE_FREED;
-
     algo->get(head, node);
-    bfdev_hashtbl_del(&node->hash);
-    bfdev_list_move(&head->freed, &node->list);
+    cache_release(head, node);
 
     return -BFDEV_ENOERR;
 }
@@ -274,6 +431,201 @@ bfdev_cache_committed(bfdev_cache_head_t *head)
     head->pending = 0;
 }
 
+export int
+bfdev_cache_commit(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    if (bfdev_unlikely(node->status != BFDEV_CACHE_PENDING))
+        return -BFDEV_EINVAL;
+
+    bfdev_list_move(&head->using, &node->list);
+    node->status = BFDEV_CACHE_USING;
+    head->changed++;
+    head->pending--;
+
+    return -BFDEV_ENOERR;
+}
+
+export int
+bfdev_cache_weight(bfdev_cache_head_t *head, bfdev_cache_node_t *node,
+                   unsigned long cost)
+{
+    if (bfdev_unlikely(node->status == BFDEV_CACHE_FREED))
+        return -BFDEV_EINVAL;
+
+    head->weight = head->weight - node->cost + cost;
+    node->cost = cost;
+
+    if (head->weight > head->peak)
+        head->peak = head->weight;
+
+    if (head->budget && head->weight > head->budget)
+        cache_trim(head);
+
+    return -BFDEV_ENOERR;
+}
+
+export void
+bfdev_cache_budget(bfdev_cache_head_t *head, unsigned long budget)
+{
+    head->budget = budget;
+
+    if (budget && head->weight > budget)
+        cache_trim(head);
+}
+
+static int
+cache_wheel_alloc(bfdev_cache_head_t *head)
+{
+    unsigned long count, slots;
+
+    slots = BFDEV_CACHE_WHEEL_TOTAL;
+    head->wheel = bfdev_malloc_array(head->alloc, slots, sizeof(*head->wheel));
+    if (bfdev_unlikely(!head->wheel))
+        return -BFDEV_ENOMEM;
+
+    for (count = 0; count < slots; ++count)
+        bfdev_list_head_init(&head->wheel[count]);
+
+    return -BFDEV_ENOERR;
+}
+
+export int
+bfdev_cache_ttl(bfdev_cache_head_t *head, bfdev_cache_node_t *node,
+                bfdev_time_t ttl)
+{
+    int retval;
+
+    if (bfdev_unlikely(node->status == BFDEV_CACHE_FREED))
+        return -BFDEV_EINVAL;
+
+    if (bfdev_unlikely(!head->wheel)) {
+        retval = cache_wheel_alloc(head);
+        if (bfdev_unlikely(retval))
+            return retval;
+    }
+
+    cache_timer_del(head, node);
+    node->expire = bfdev_time_add(head->clock, ttl);
+    cache_timer_add(head, node);
+
+    return -BFDEV_ENOERR;
+}
+
+export void
+bfdev_cache_persist(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    cache_timer_del(head, node);
+}
+
+static void
+cache_cascade(bfdev_cache_head_t *head)
+{
+    bfdev_cache_node_t *node, *tmp;
+    bfdev_list_head_t *slot, *target;
+    unsigned int level, shift;
+    uint64_t index;
+
+    /* Redistribute the upper slot that just came into range */
+    for (level = 1; level < BFDEV_CACHE_WHEEL_LEVELS; ++level) {
+        shift = BFDEV_CACHE_WHEEL_BITS * level;
+        index = ((uint64_t)head->clock >> shift) & BFDEV_CACHE_WHEEL_MASK;
+        slot = &head->wheel[level * BFDEV_CACHE_WHEEL_SLOTS + index];
+
+        bfdev_bit_clr(head->occupied, slot - head->wheel);
+        bfdev_list_for_each_entry_safe(node, tmp, slot, timer) {
+            target = cache_timer_slot(head, node->expire);
+            bfdev_list_del(&node->timer);
+            bfdev_list_add_prev(target, &node->timer);
+            bfdev_bit_set(head->occupied, target - head->wheel);
+        }
+
+        if (index)
+            break;
+    }
+}
+
+static bool
+cache_wheel_next(bfdev_cache_head_t *head, bfdev_time_t *next)
+{
+    unsigned int level, shift, start, end, hand, bit;
+    bfdev_time_t when;
+    bool found;
+
+    found = false;
+    *next = head->clock;
+
+    for (level = 0; level < BFDEV_CACHE_WHEEL_LEVELS; ++level) {
+        shift = BFDEV_CACHE_WHEEL_BITS * level;
+        start = level * BFDEV_CACHE_WHEEL_SLOTS;
+        end = start + BFDEV_CACHE_WHEEL_SLOTS;
+        hand = ((uint64_t)head->clock >> shift) & BFDEV_CACHE_WHEEL_MASK;
+
+        /* Slots past the hand come in this round, the rest in the next */
+        bit = bfdev_find_next_bit(head->occupied, end, start + hand + 1);
+        if (bit >= end)
+            bit = bfdev_find_next_bit(head->occupied, end, start);
+        if (bit >= end)
+            continue;
+
+        when = (uint64_t)head->clock >> (shift + BFDEV_CACHE_WHEEL_BITS);
+        when = (when << BFDEV_CACHE_WHEEL_BITS | (bit - start)) << shift;
+        if (!bfdev_time_after(when, head->clock))
+            when += (bfdev_time_t)1 << (shift + BFDEV_CACHE_WHEEL_BITS);
+
+        if (!found || bfdev_time_before(when, *next))
+            *next = when;
+        found = true;
+    }
+
+    return found;
+}
+
+export unsigned long
+bfdev_cache_expire(bfdev_cache_head_t *head, bfdev_time_t now)
+{
+    bfdev_cache_node_t *node, *tmp;
+    bfdev_list_head_t *slot;
+    bfdev_time_t next;
+    unsigned long count;
+
+    count = 0;
+    if (!head->wheel) {
+        head->clock = now;
+        return 0;
+    }
+
+    /* Only ticks that fire or cascade something are visited */
+    while (cache_wheel_next(head, &next) && !bfdev_time_after(next, now)) {
+        head->clock = next;
+        if (!(head->clock & BFDEV_CACHE_WHEEL_MASK))
+            cache_cascade(head);
+
+        slot = &head->wheel[head->clock & BFDEV_CACHE_WHEEL_MASK];
+        bfdev_bit_clr(head->occupied, slot - head->wheel);
+        bfdev_list_for_each_entry_safe(node, tmp, slot, timer) {
+            bfdev_list_move_prev(&head->due, &node->timer);
+            head->timers--;
+        }
+    }
+
+    if (bfdev_time_before(head->clock, now))
+        head->clock = now;
+
+    /* Elements still in use wait aside for their last put */
+    bfdev_list_for_each_entry_safe(node, tmp, &head->due, timer) {
+        if (node->status != BFDEV_CACHE_MANAGED) {
+            bfdev_list_move_prev(&head->overdue, &node->timer);
+            continue;
+        }
+
+        head->algo->get(head, node);
+        cache_reclaim(head, node);
+        count++;
+    }
+
+    return count;
+}
+
 export void
 bfdev_cache_reset(bfdev_cache_head_t *head)
 {
@@ -283,13 +635,27 @@ bfdev_cache_reset(bfdev_cache_head_t *head)
     head->flags = 0;
     head->pending = 0;
     head->used = 0;
+    head->pinned = 0;
     head->hits = 0;
     head->misses = 0;
     head->starve = 0;
+    head->expired = 0;
+    head->timers = 0;
+    head->clock = 0;
+    head->weight = 0;
+    head->peak = 0;
 
     bfdev_list_head_init(&head->using);
     bfdev_list_head_init(&head->freed);
     bfdev_list_head_init(&head->changing);
+    bfdev_list_head_init(&head->due);
+    bfdev_list_head_init(&head->overdue);
+    bfdev_bitmap_zero(head->occupied, BFDEV_CACHE_WHEEL_TOTAL);
+
+    if (head->wheel) {
+        for (count = 0; count < BFDEV_CACHE_WHEEL_TOTAL; ++count)
+            bfdev_list_head_init(&head->wheel[count]);
+    }
 
     head->algo->reset(head);
     bfport_memset(head->taghash, 0, sizeof(*head->taghash) * head->size);
@@ -297,6 +663,8 @@ bfdev_cache_reset(bfdev_cache_head_t *head)
     for (count = 0; count < head->size; ++count) {
         node = head->nodes[count];
         bfdev_list_add(&head->freed, &node->list);
+        bfdev_list_head_init(&node->timer);
+        node->cost = 0;
     }
 }
 
@@ -341,6 +709,9 @@ bfdev_cache_create(const char *name, const bfdev_alloc_t *alloc,
     bfdev_list_head_init(&head->using);
     bfdev_list_head_init(&head->freed);
     bfdev_list_head_init(&head->changing);
+    bfdev_list_head_init(&head->due);
+    bfdev_list_head_init(&head->overdue);
+    bfdev_bitmap_zero(head->occupied, BFDEV_CACHE_WHEEL_TOTAL);
 
     for (count = 0; count < size; ++count) {
         bfdev_cache_node_t *node;
@@ -348,6 +719,7 @@ bfdev_cache_create(const char *name, const bfdev_alloc_t *alloc,
         node = head->nodes[count];
         node->index = count;
         bfdev_list_add(&head->freed, &node->list);
+        bfdev_list_head_init(&node->timer);
     }
 
     return head;
@@ -362,6 +734,7 @@ bfdev_cache_destroy(bfdev_cache_head_t *head)
     algo = head->algo;
     alloc = head->alloc;
 
+    bfdev_free(alloc, head->wheel);
     bfdev_free(alloc, head->taghash);
     algo->destroy(head);
 }
@@ -0,0 +1,200 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/cache.h>
+
+/*
+ * Nodes never leave the ring, a hit only sets the reference bit of
+ * the node itself. The hand skips nodes that are not managed, and
+ * gives referenced ones a second chance.
+ */
+struct clock_head {
+    bfdev_cache_head_t cache;
+    unsigned long hand;
+    unsigned long resident;
+};
+
+struct clock_node {
+    bfdev_cache_node_t cache;
+    bool referenced;
+};
+
+#define cache_to_clock_head(ptr) \
+    bfdev_container_of(ptr, struct clock_head, cache)
+
+#define cache_to_clock_node(ptr) \
+    bfdev_container_of(ptr, struct clock_node, cache)
+
+static bool
+clock_starving(bfdev_cache_head_t *head)
+{
+    struct clock_head *clock_head;
+
+    clock_head = cache_to_clock_head(head);
+
+    /* Resident nodes held by users cannot be evicted */
+    return clock_head->resident == head->pinned;
+}
+
+static bfdev_cache_node_t *
+clock_obtain(bfdev_cache_head_t *head)
+{
+    struct clock_head *clock_head;
+    struct clock_node *clock_node;
+
+    clock_head = cache_to_clock_head(head);
+
+    /* At most two revolutions, the first one clears every bit */
+    for (;;) {
+        clock_node = cache_to_clock_node(head->nodes[clock_head->hand]);
+        if (++clock_head->hand == head->size)
+            clock_head->hand = 0;
+
+        if (clock_node->cache.status != BFDEV_CACHE_MANAGED)
+            continue;
+
+        if (!clock_node->referenced)
+            break;
+
+        clock_node->referenced = false;
+    }
+
+    clock_head->resident--;
+
+    return &clock_node->cache;
+}
+
+/* Only called when a node leaves or enters the ring, not on hits */
+static void
+clock_get(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct clock_head *clock_head;
+
+    clock_head = cache_to_clock_head(head);
+    clock_head->resident--;
+}
+
+static void
+clock_put(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct clock_head *clock_head;
+
+    clock_head = cache_to_clock_head(head);
+    clock_head->resident++;
+}
+
+static void
+clock_update(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct clock_node *clock_node;
+
+    clock_node = cache_to_clock_node(node);
+    clock_node->referenced = true;
+}
+
+static void
+clock_clear(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct clock_node *clock_node;
+
+    clock_node = cache_to_clock_node(node);
+    clock_node->referenced = false;
+}
+
+static void
+clock_reset(bfdev_cache_head_t *head)
+{
+    struct clock_head *clock_head;
+    struct clock_node *clock_node;
+    unsigned long count;
+
+    clock_head = cache_to_clock_head(head);
+    clock_head->hand = 0;
+    clock_head->resident = 0;
+
+    for (count = 0; count < head->size; ++count) {
+        clock_node = cache_to_clock_node(head->nodes[count]);
+        clock_node->referenced = false;
+    }
+}
+
+static bfdev_cache_head_t *
+clock_create(const bfdev_alloc_t *alloc, unsigned long size)
+{
+    bfdev_cache_head_t *head;
+    struct clock_head *clock_head;
+    struct clock_node *clock_node;
+    unsigned long count;
+
+    clock_head = bfdev_zalloc(alloc, sizeof(*clock_head));
+    if (bfdev_unlikely(!clock_head))
+        return NULL;
+
+    head = &clock_head->cache;
+    head->nodes = bfdev_zalloc_array(alloc, size, sizeof(*head->nodes));
+    if (bfdev_unlikely(!head->nodes))
+        goto free_head;
+
+    for (count = 0; count < size; ++count) {
+        clock_node = bfdev_zalloc(alloc, sizeof(*clock_node));
+        if (bfdev_unlikely(!clock_node))
+            goto free_element;
+
+        head->nodes[count] = &clock_node->cache;
+    }
+
+    return head;
+
+free_element:
+    while (count--)
+        bfdev_free(alloc, cache_to_clock_node(head->nodes[count]));
+    bfdev_free(alloc, head->nodes);
+
+free_head:
+    bfdev_free(alloc, clock_head);
+    return NULL;
+}
+
+static void
+clock_destroy(bfdev_cache_head_t *head)
+{
+    const bfdev_alloc_t *alloc;
+    unsigned long count;
+
+    alloc = head->alloc;
+    for (count = 0; count < head->size; ++count)
+        bfdev_free(alloc, cache_to_clock_node(head->nodes[count]));
+
+    bfdev_free(alloc, head->nodes);
+    bfdev_free(alloc, cache_to_clock_head(head));
+}
+
+static bfdev_cache_algo_t
+clock_algorithm = {
+    .name = "clock",
+    .flags = BFDEV_CACHE_ALGO_RING,
+    .starving = clock_starving,
+    .obtain = clock_obtain,
+    .get = clock_get,
+    .put = clock_put,
+    .update = clock_update,
+    .clear = clock_clear,
+    .reset = clock_reset,
+    .create = clock_create,
+    .destroy = clock_destroy,
+};
+
+static __bfdev_ctor int
+clock_init(void)
+{
+    return bfdev_cache_register(&clock_algorithm);
+}
+
+static __bfdev_dtor int
+clock_exit(void)
+{
+    return bfdev_cache_unregister(&clock_algorithm);
+}
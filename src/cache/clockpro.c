@@ -0,0 +1,407 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/cache.h>
+#include <bfdev/hashtbl.h>
+#include <bfdev/minmax.h>
+
+/*
+ * Non-resident cold pages are remembered by tag hash only, in a
+ * fifo bounded by the cache size. Hitting one while it is still
+ * there means its reuse distance would have fit, so the cold region
+ * grows and the page comes back hot.
+ */
+struct clockpro_ghost {
+    bfdev_hlist_node_t hash;
+    bfdev_list_head_t list;
+    unsigned long value;
+};
+
+struct clockpro_head {
+    bfdev_cache_head_t cache;
+    bfdev_list_head_t ghosts;
+    bfdev_list_head_t gfree;
+    bfdev_hlist_head_t *ghash;
+    struct clockpro_ghost *gpool;
+
+    unsigned long hand_hot;
+    unsigned long hand_cold;
+    unsigned long resident;
+
+    /* adaptive target of resident cold pages */
+    unsigned long cold_target;
+    unsigned long hot_size;
+
+    /* the current miss hit a non-resident page */
+    bool hit;
+};
+
+struct clockpro_node {
+    bfdev_cache_node_t cache;
+    bool referenced;
+    bool hot;
+    bool test;
+};
+
+#define cache_to_clockpro_head(ptr) \
+    bfdev_container_of(ptr, struct clockpro_head, cache)
+
+#define cache_to_clockpro_node(ptr) \
+    bfdev_container_of(ptr, struct clockpro_node, cache)
+
+static __bfdev_always_inline unsigned long
+clockpro_hash(bfdev_cache_head_t *head, const void *tag)
+{
+    const bfdev_cache_ops_t *ops;
+
+    ops = head->ops;
+
+    return ops->hash(tag, head->pdata);
+}
+
+static __bfdev_always_inline struct clockpro_node *
+clockpro_next(bfdev_cache_head_t *head, unsigned long *hand)
+{
+    bfdev_cache_node_t *node;
+
+    node = head->nodes[*hand];
+    if (++*hand == head->size)
+        *hand = 0;
+
+    return cache_to_clockpro_node(node);
+}
+
+static void
+clockpro_ghost_del(struct clockpro_head *clockpro_head,
+                   struct clockpro_ghost *ghost)
+{
+    bfdev_hlist_del(&ghost->hash);
+    bfdev_list_move(&clockpro_head->gfree, &ghost->list);
+}
+
+static void
+clockpro_ghost_add(struct clockpro_head *clockpro_head, unsigned long value)
+{
+    struct clockpro_ghost *ghost;
+
+    if (bfdev_list_check_empty(&clockpro_head->gfree)) {
+        ghost = bfdev_list_last_entry(&clockpro_head->ghosts,
+                                      struct clockpro_ghost, list);
+        clockpro_ghost_del(clockpro_head, ghost);
+    }
+
+    ghost = bfdev_list_first_entry(&clockpro_head->gfree,
+                                   struct clockpro_ghost, list);
+    bfdev_list_move(&clockpro_head->ghosts, &ghost->list);
+    ghost->value = value;
+
+    bfdev_hashtbl_add(clockpro_head->ghash, clockpro_head->cache.size,
+                      &ghost->hash, value);
+}
+
+static struct clockpro_ghost *
+clockpro_ghost_find(struct clockpro_head *clockpro_head, unsigned long value)
+{
+    struct clockpro_ghost *ghost;
+    unsigned long index;
+
+    index = bfdev_hashtbl_index(clockpro_head->cache.size, value);
+    bfdev_hashtbl_for_each_idx_entry(ghost, clockpro_head->ghash,
+                                     clockpro_head->cache.size, hash, index) {
+        if (ghost->value == value)
+            return ghost;
+    }
+
+    return NULL;
+}
+
+static void
+clockpro_hand_hot(struct clockpro_head *clockpro_head)
+{
+    bfdev_cache_head_t *head;
+    struct clockpro_node *node;
+
+    head = &clockpro_head->cache;
+    while (clockpro_head->hot_size > head->size - clockpro_head->cold_target) {
+        node = clockpro_next(head, &clockpro_head->hand_hot);
+
+        if (!node->hot) {
+            /* A cold page passed by without reuse ends its test */
+            if (node->test) {
+                node->test = false;
+                if (clockpro_head->cold_target > 1)
+                    clockpro_head->cold_target--;
+            }
+            continue;
+        }
+
+        if (node->referenced) {
+            node->referenced = false;
+            continue;
+        }
+
+        node->hot = false;
+        clockpro_head->hot_size--;
+    }
+}
+
+static bool
+clockpro_starving(bfdev_cache_head_t *head)
+{
+    struct clockpro_head *clockpro_head;
+
+    clockpro_head = cache_to_clockpro_head(head);
+
+    /* Resident pages held by users cannot be evicted */
+    return clockpro_head->resident == head->pinned;
+}
+
+static void
+clockpro_miss(bfdev_cache_head_t *head, const void *tag)
+{
+    struct clockpro_head *clockpro_head;
+    struct clockpro_ghost *ghost;
+
+    clockpro_head = cache_to_clockpro_head(head);
+    clockpro_head->hit = false;
+
+    ghost = clockpro_ghost_find(clockpro_head, clockpro_hash(head, tag));
+    if (!ghost)
+        return;
+
+    clockpro_head->cold_target = bfdev_min(clockpro_head->cold_target + 1,
+                                           head->size - 1);
+    clockpro_head->hit = true;
+    clockpro_ghost_del(clockpro_head, ghost);
+}
+
+static bfdev_cache_node_t *
+clockpro_obtain(bfdev_cache_head_t *head)
+{
+    struct clockpro_head *clockpro_head;
+    struct clockpro_node *node;
+    unsigned long steps;
+
+    clockpro_head = cache_to_clockpro_head(head);
+
+    for (steps = 0;; ++steps) {
+        node = clockpro_next(head, &clockpro_head->hand_cold);
+        if (node->cache.status != BFDEV_CACHE_MANAGED)
+            continue;
+
+        /* Only when every managed page stays hot for two rounds */
+        if (node->hot) {
+            if (steps < head->size * 2)
+                continue;
+            break;
+        }
+
+        if (!node->referenced)
+            break;
+
+        node->referenced = false;
+        if (!node->test) {
+            node->test = true;
+            continue;
+        }
+
+        /* Reused within its test period */
+        node->test = false;
+        node->hot = true;
+        clockpro_head->hot_size++;
+        clockpro_hand_hot(clockpro_head);
+    }
+
+    if (node->test)
+        clockpro_ghost_add(clockpro_head,
+                           clockpro_hash(head, node->cache.tag));
+
+    clockpro_head->resident--;
+
+    return &node->cache;
+}
+
+/* Only called when a page leaves or enters the ring, not on hits */
+static void
+clockpro_get(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct clockpro_head *clockpro_head;
+
+    clockpro_head = cache_to_clockpro_head(head);
+    clockpro_head->resident--;
+}
+
+static void
+clockpro_put(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct clockpro_head *clockpro_head;
+
+    clockpro_head = cache_to_clockpro_head(head);
+    clockpro_head->resident++;
+}
+
+static void
+clockpro_update(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct clockpro_node *clockpro_node;
+
+    clockpro_node = cache_to_clockpro_node(node);
+    clockpro_node->referenced = true;
+}
+
+static void
+clockpro_clear(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct clockpro_head *clockpro_head;
+    struct clockpro_node *clockpro_node;
+
+    clockpro_head = cache_to_clockpro_head(head);
+    clockpro_node = cache_to_clockpro_node(node);
+
+    if (clockpro_node->hot)
+        clockpro_head->hot_size--;
+
+    clockpro_node->referenced = false;
+    clockpro_node->hot = clockpro_head->hit;
+    clockpro_node->test = !clockpro_head->hit;
+
+    if (clockpro_head->hit) {
+        clockpro_head->hot_size++;
+        clockpro_hand_hot(clockpro_head);
+    }
+}
+
+static void
+clockpro_reset(bfdev_cache_head_t *head)
+{
+    struct clockpro_head *clockpro_head;
+    struct clockpro_node *clockpro_node;
+    unsigned long count;
+
+    clockpro_head = cache_to_clockpro_head(head);
+
+    bfdev_list_head_init(&clockpro_head->ghosts);
+    bfdev_list_head_init(&clockpro_head->gfree);
+    bfport_memset(clockpro_head->ghash, 0,
+                  sizeof(*clockpro_head->ghash) * head->size);
+
+    for (count = 0; count < head->size; ++count) {
+        clockpro_node = cache_to_clockpro_node(head->nodes[count]);
+        clockpro_node->referenced = false;
+        clockpro_node->hot = false;
+        clockpro_node->test = false;
+
+        bfdev_list_add(&clockpro_head->gfree,
+                       &clockpro_head->gpool[count].list);
+    }
+
+    clockpro_head->hand_hot = 0;
+    clockpro_head->hand_cold = 0;
+    clockpro_head->resident = 0;
+    clockpro_head->hot_size = 0;
+    clockpro_head->cold_target = bfdev_max(head->size / 100, 1UL);
+    clockpro_head->hit = false;
+}
+
+static void
+clockpro_release(const bfdev_alloc_t *alloc,
+                 struct clockpro_head *clockpro_head)
+{
+    bfdev_free(alloc, clockpro_head->gpool);
+    bfdev_free(alloc, clockpro_head->ghash);
+    bfdev_free(alloc, clockpro_head->cache.nodes);
+    bfdev_free(alloc, clockpro_head);
+}
+
+static bfdev_cache_head_t *
+clockpro_create(const bfdev_alloc_t *alloc, unsigned long size)
+{
+    bfdev_cache_head_t *head;
+    struct clockpro_head *clockpro_head;
+    struct clockpro_node *clockpro_node;
+    unsigned long count;
+
+    /* The hot region needs at least one slot besides the cold one */
+    if (bfdev_unlikely(size < 2))
+        return NULL;
+
+    clockpro_head = bfdev_zalloc(alloc, sizeof(*clockpro_head));
+    if (bfdev_unlikely(!clockpro_head))
+        return NULL;
+
+    head = &clockpro_head->cache;
+    head->size = size;
+
+    head->nodes = bfdev_zalloc_array(alloc, size, sizeof(*head->nodes));
+    clockpro_head->ghash = bfdev_zalloc_array(alloc, size,
+                                              sizeof(*clockpro_head->ghash));
+    clockpro_head->gpool = bfdev_zalloc_array(alloc, size,
+                                              sizeof(*clockpro_head->gpool));
+    if (bfdev_unlikely(!head->nodes || !clockpro_head->ghash ||
+                       !clockpro_head->gpool))
+        goto free_head;
+
+    for (count = 0; count < size; ++count) {
+        clockpro_node = bfdev_zalloc(alloc, sizeof(*clockpro_node));
+        if (bfdev_unlikely(!clockpro_node))
+            goto free_element;
+
+        head->nodes[count] = &clockpro_node->cache;
+    }
+
+    clockpro_reset(head);
+
+    return head;
+
+free_element:
+    while (count--)
+        bfdev_free(alloc, cache_to_clockpro_node(head->nodes[count]));
+
+free_head:
+    clockpro_release(alloc, clockpro_head);
+    return NULL;
+}
+
+static void
+clockpro_destroy(bfdev_cache_head_t *head)
+{
+    const bfdev_alloc_t *alloc;
+    unsigned long count;
+
+    alloc = head->alloc;
+    for (count = 0; count < head->size; ++count)
+        bfdev_free(alloc, cache_to_clockpro_node(head->nodes[count]));
+
+    clockpro_release(alloc, cache_to_clockpro_head(head));
+}
+
+static bfdev_cache_algo_t
+clockpro_algorithm = {
+    .name = "clockpro",
+    .flags = BFDEV_CACHE_ALGO_RING,
+    .starving = clockpro_starving,
+    .miss = clockpro_miss,
+    .obtain = clockpro_obtain,
+    .get = clockpro_get,
+    .put = clockpro_put,
+    .update = clockpro_update,
+    .clear = clockpro_clear,
+    .reset = clockpro_reset,
+    .create = clockpro_create,
+    .destroy = clockpro_destroy,
+};
+
+static __bfdev_ctor int
+clockpro_init(void)
+{
+    return bfdev_cache_register(&clockpro_algorithm);
+}
+
+static __bfdev_dtor int
+clockpro_exit(void)
+{
+    return bfdev_cache_unregister(&clockpro_algorithm);
+}
@@ -0,0 +1,329 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/cache.h>
+
+/*
+ * Frequency buckets are kept in ascending order, each one holds
+ * the managed nodes of that frequency in insertion order. Only
+ * buckets with managed nodes stay listed, one emptied by nodes in
+ * use is unlinked but lives as long as any node refers to it, and
+ * remembers its former neighbour to find the way back on put.
+ */
+struct lfuo1_bucket {
+    bfdev_list_head_t list;
+    bfdev_list_head_t nodes;
+    bfdev_list_head_t *hint;
+    unsigned long count;
+    unsigned long refcnt;
+};
+
+struct lfuo1_head {
+    bfdev_cache_head_t cache;
+    bfdev_list_head_t buckets;
+    bfdev_list_head_t bfree;
+    struct lfuo1_bucket *pool;
+    unsigned long managed;
+};
+
+struct lfuo1_node {
+    bfdev_cache_node_t cache;
+    bfdev_list_head_t node;
+    struct lfuo1_bucket *bucket;
+    unsigned long count;
+};
+
+#define cache_to_lfuo1_head(ptr) \
+    bfdev_container_of(ptr, struct lfuo1_head, cache)
+
+#define cache_to_lfuo1_node(ptr) \
+    bfdev_container_of(ptr, struct lfuo1_node, cache)
+
+static void
+lfuo1_bucket_put(struct lfuo1_head *lfuo1_head, struct lfuo1_bucket *bucket)
+{
+    if (!bucket || --bucket->refcnt)
+        return;
+
+    bfdev_list_move(&lfuo1_head->bfree, &bucket->list);
+}
+
+static __bfdev_always_inline bool
+lfuo1_bucket_linked(struct lfuo1_bucket *bucket)
+{
+    return !bfdev_list_check_empty(&bucket->list);
+}
+
+static void
+lfuo1_bucket_unlink(struct lfuo1_bucket *bucket)
+{
+    if (!bfdev_list_check_empty(&bucket->nodes))
+        return;
+
+    bucket->hint = bucket->list.prev;
+    bfdev_list_del_init(&bucket->list);
+}
+
+static bfdev_list_head_t *
+lfuo1_bucket_prev(struct lfuo1_head *lfuo1_head, struct lfuo1_bucket *bucket,
+                  unsigned long count)
+{
+    struct lfuo1_bucket *hint;
+
+    if (!bucket)
+        return &lfuo1_head->buckets;
+
+    if (lfuo1_bucket_linked(bucket))
+        return &bucket->list;
+
+    if (bucket->hint == &lfuo1_head->buckets)
+        return &lfuo1_head->buckets;
+
+    /*
+     * The former neighbour may have been unlinked or recycled since,
+     * any listed bucket of no higher frequency is still a valid start.
+     */
+    hint = bfdev_list_entry(bucket->hint, struct lfuo1_bucket, list);
+    if (hint->refcnt && lfuo1_bucket_linked(hint) && hint->count <= count)
+        return hint->list.prev;
+
+    return &lfuo1_head->buckets;
+}
+
+static struct lfuo1_bucket *
+lfuo1_bucket_get(struct lfuo1_head *lfuo1_head, bfdev_list_head_t *prev,
+                 unsigned long count)
+{
+    struct lfuo1_bucket *bucket;
+
+    /* Usually one step, several hits while in use may skip further */
+    while (prev->next != &lfuo1_head->buckets) {
+        bucket = bfdev_list_entry(prev->next, struct lfuo1_bucket, list);
+        if (bucket->count > count)
+            break;
+
+        if (bucket->count == count)
+            goto finish;
+
+        prev = prev->next;
+    }
+
+    /* Each node holds one bucket, plus the one being switched to */
+    bucket = bfdev_list_first_entry(&lfuo1_head->bfree,
+                                    struct lfuo1_bucket, list);
+    bfdev_list_move(prev, &bucket->list);
+    bfdev_list_head_init(&bucket->nodes);
+    bucket->count = count;
+
+finish:
+    bucket->refcnt++;
+    return bucket;
+}
+
+static bool
+lfuo1_starving(bfdev_cache_head_t *head)
+{
+    struct lfuo1_head *lfuo1_head;
+
+    lfuo1_head = cache_to_lfuo1_head(head);
+
+    return !lfuo1_head->managed;
+}
+
+static bfdev_cache_node_t *
+lfuo1_obtain(bfdev_cache_head_t *head)
+{
+    struct lfuo1_head *lfuo1_head;
+    struct lfuo1_bucket *bucket;
+    struct lfuo1_node *lfuo1_node;
+
+    lfuo1_head = cache_to_lfuo1_head(head);
+    bucket = bfdev_list_first_entry(&lfuo1_head->buckets,
+                                    struct lfuo1_bucket, list);
+
+    lfuo1_node = bfdev_list_first_entry(&bucket->nodes,
+                                        struct lfuo1_node, node);
+    bfdev_list_del(&lfuo1_node->node);
+    lfuo1_bucket_unlink(bucket);
+    lfuo1_head->managed--;
+
+    return &lfuo1_node->cache;
+}
+
+static void
+lfuo1_get(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct lfuo1_head *lfuo1_head;
+    struct lfuo1_node *lfuo1_node;
+
+    lfuo1_head = cache_to_lfuo1_head(head);
+    lfuo1_node = cache_to_lfuo1_node(node);
+
+    bfdev_list_del(&lfuo1_node->node);
+    lfuo1_bucket_unlink(lfuo1_node->bucket);
+    lfuo1_head->managed--;
+}
+
+static void
+lfuo1_put(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct lfuo1_head *lfuo1_head;
+    struct lfuo1_node *lfuo1_node;
+    struct lfuo1_bucket *bucket;
+    bfdev_list_head_t *prev;
+
+    lfuo1_head = cache_to_lfuo1_head(head);
+    lfuo1_node = cache_to_lfuo1_node(node);
+    bucket = lfuo1_node->bucket;
+
+    if (!bucket || bucket->count != lfuo1_node->count ||
+        !lfuo1_bucket_linked(bucket)) {
+        prev = lfuo1_bucket_prev(lfuo1_head, bucket, lfuo1_node->count);
+        lfuo1_node->bucket = lfuo1_bucket_get(lfuo1_head, prev,
+                                              lfuo1_node->count);
+        lfuo1_bucket_put(lfuo1_head, bucket);
+    }
+
+    bfdev_list_add_prev(&lfuo1_node->bucket->nodes, &lfuo1_node->node);
+    lfuo1_head->managed++;
+}
+
+static void
+lfuo1_update(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct lfuo1_node *lfuo1_node;
+
+    lfuo1_node = cache_to_lfuo1_node(node);
+    lfuo1_node->count++;
+}
+
+static void
+lfuo1_clear(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct lfuo1_head *lfuo1_head;
+    struct lfuo1_node *lfuo1_node;
+
+    lfuo1_head = cache_to_lfuo1_head(head);
+    lfuo1_node = cache_to_lfuo1_node(node);
+
+    lfuo1_bucket_put(lfuo1_head, lfuo1_node->bucket);
+    lfuo1_node->bucket = NULL;
+    lfuo1_node->count = 0;
+}
+
+static void
+lfuo1_reset(bfdev_cache_head_t *head)
+{
+    struct lfuo1_head *lfuo1_head;
+    struct lfuo1_node *lfuo1_node;
+    unsigned long count;
+
+    lfuo1_head = cache_to_lfuo1_head(head);
+
+    bfdev_list_head_init(&lfuo1_head->buckets);
+    bfdev_list_head_init(&lfuo1_head->bfree);
+
+    for (count = 0; count < head->size; ++count) {
+        lfuo1_node = cache_to_lfuo1_node(head->nodes[count]);
+        lfuo1_node->bucket = NULL;
+        lfuo1_node->count = 0;
+    }
+
+    for (count = 0; count <= head->size; ++count) {
+        lfuo1_head->pool[count].refcnt = 0;
+        bfdev_list_add(&lfuo1_head->bfree, &lfuo1_head->pool[count].list);
+    }
+
+    lfuo1_head->managed = 0;
+}
+
+static void
+lfuo1_release(const bfdev_alloc_t *alloc, struct lfuo1_head *lfuo1_head)
+{
+    bfdev_free(alloc, lfuo1_head->pool);
+    bfdev_free(alloc, lfuo1_head->cache.nodes);
+    bfdev_free(alloc, lfuo1_head);
+}
+
+static bfdev_cache_head_t *
+lfuo1_create(const bfdev_alloc_t *alloc, unsigned long size)
+{
+    bfdev_cache_head_t *head;
+    struct lfuo1_head *lfuo1_head;
+    struct lfuo1_node *lfuo1_node;
+    unsigned long count;
+
+    lfuo1_head = bfdev_zalloc(alloc, sizeof(*lfuo1_head));
+    if (bfdev_unlikely(!lfuo1_head))
+        return NULL;
+
+    head = &lfuo1_head->cache;
+    head->size = size;
+
+    head->nodes = bfdev_zalloc_array(alloc, size, sizeof(*head->nodes));
+    lfuo1_head->pool = bfdev_zalloc_array(alloc, size + 1, sizeof(*lfuo1_head->pool));
+    if (bfdev_unlikely(!head->nodes || !lfuo1_head->pool))
+        goto free_head;
+
+    for (count = 0; count < size; ++count) {
+        lfuo1_node = bfdev_zalloc(alloc, sizeof(*lfuo1_node));
+        if (bfdev_unlikely(!lfuo1_node))
+            goto free_element;
+
+        head->nodes[count] = &lfuo1_node->cache;
+    }
+
+    lfuo1_reset(head);
+
+    return head;
+
+free_element:
+    while (count--)
+        bfdev_free(alloc, cache_to_lfuo1_node(head->nodes[count]));
+
+free_head:
+    lfuo1_release(alloc, lfuo1_head);
+    return NULL;
+}
+
+static void
+lfuo1_destroy(bfdev_cache_head_t *head)
+{
+    const bfdev_alloc_t *alloc;
+    unsigned long count;
+
+    alloc = head->alloc;
+    for (count = 0; count < head->size; ++count)
+        bfdev_free(alloc, cache_to_lfuo1_node(head->nodes[count]));
+
+    lfuo1_release(alloc, cache_to_lfuo1_head(head));
+}
+
+static bfdev_cache_algo_t
+lfuo1_algorithm = {
+    .name = "lfuo1",
+    .starving = lfuo1_starving,
+    .obtain = lfuo1_obtain,
+    .get = lfuo1_get,
+    .put = lfuo1_put,
+    .update = lfuo1_update,
+    .clear = lfuo1_clear,
+    .reset = lfuo1_reset,
+    .create = lfuo1_create,
+    .destroy = lfuo1_destroy,
+};
+
+static __bfdev_ctor int
+lfuo1_init(void)
+{
+    return bfdev_cache_register(&lfuo1_algorithm);
+}
+
+static __bfdev_dtor int
+lfuo1_exit(void)
+{
+    return bfdev_cache_unregister(&lfuo1_algorithm);
+}
@@ -0,0 +1,263 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/log2.h>
+#include <bfdev/hash.h>
+#include <bfdev/align.h>
+#include <bfdev/math.h>
+#include <bfdev/minmax.h>
+#include <bfdev/cache-shard.h>
+#include <export.h>
+
+static __bfdev_always_inline bfdev_cache_slot_t *
+shard_slot(bfdev_cache_shard_t *shard, const void *tag)
+{
+    const bfdev_cache_ops_t *ops;
+    unsigned long hash;
+
+    ops = shard->ops;
+    hash = ops->hash(tag, shard->pdata);
+
+    /*
+     * The partition caches index their buckets with the top bits of
+     * the mixed hash, pick the partition from the middle bits so that
+     * both stay evenly spread.
+     */
+    hash = bfdev_hashvl(hash) >> (BFDEV_BITS_PER_LONG / 2);
+
+    return &shard->slots[hash & (shard->nslots - 1)];
+}
+
+export bfdev_cache_node_t *
+bfdev_cache_shard_obtain(bfdev_cache_shard_t *shard, const void *tag,
+                         unsigned long flags)
+{
+    bfdev_cache_slot_t *slot;
+    bfdev_cache_node_t *node;
+
+    slot = shard_slot(shard, tag);
+    bfdev_spin_lock(&slot->lock);
+    node = bfdev_cache_obtain(slot->head, tag, flags);
+    bfdev_spin_unlock(&slot->lock);
+
+    return node;
+}
+
+export int
+bfdev_cache_shard_commit(bfdev_cache_shard_t *shard, bfdev_cache_node_t *node)
+{
+    bfdev_cache_slot_t *slot;
+    int retval;
+
+    slot = shard_slot(shard, node->tag);
+    bfdev_spin_lock(&slot->lock);
+    retval = bfdev_cache_commit(slot->head, node);
+    bfdev_spin_unlock(&slot->lock);
+
+    return retval;
+}
+
+export unsigned long
+bfdev_cache_shard_put(bfdev_cache_shard_t *shard, bfdev_cache_node_t *node)
+{
+    bfdev_cache_slot_t *slot;
+    unsigned long retval;
+
+    slot = shard_slot(shard, node->tag);
+    bfdev_spin_lock(&slot->lock);
+    retval = bfdev_cache_put(slot->head, node);
+    bfdev_spin_unlock(&slot->lock);
+
+    return retval;
+}
+
+export int
+bfdev_cache_shard_del(bfdev_cache_shard_t *shard, bfdev_cache_node_t *node)
+{
+    bfdev_cache_slot_t *slot;
+    int retval;
+
+    slot = shard_slot(shard, node->tag);
+    bfdev_spin_lock(&slot->lock);
+    retval = bfdev_cache_del(slot->head, node);
+    bfdev_spin_unlock(&slot->lock);
+
+    return retval;
+}
+
+export int
+bfdev_cache_shard_weight(bfdev_cache_shard_t *shard, bfdev_cache_node_t *node,
+                         unsigned long cost)
+{
+    bfdev_cache_slot_t *slot;
+    int retval;
+
+    slot = shard_slot(shard, node->tag);
+    bfdev_spin_lock(&slot->lock);
+    retval = bfdev_cache_weight(slot->head, node, cost);
+    bfdev_spin_unlock(&slot->lock);
+
+    return retval;
+}
+
+export void
+bfdev_cache_shard_budget(bfdev_cache_shard_t *shard, unsigned long budget)
+{
+    bfdev_cache_slot_t *slot;
+    unsigned long count;
+
+    budget = BFDEV_DIV_ROUND_UP(budget, shard->nslots);
+    for (count = 0; count < shard->nslots; ++count) {
+        slot = &shard->slots[count];
+
+        bfdev_spin_lock(&slot->lock);
+        bfdev_cache_budget(slot->head, budget);
+        bfdev_spin_unlock(&slot->lock);
+    }
+}
+
+export int
+bfdev_cache_shard_ttl(bfdev_cache_shard_t *shard, bfdev_cache_node_t *node,
+                      bfdev_time_t ttl)
+{
+    bfdev_cache_slot_t *slot;
+    int retval;
+
+    slot = shard_slot(shard, node->tag);
+    bfdev_spin_lock(&slot->lock);
+    retval = bfdev_cache_ttl(slot->head, node, ttl);
+    bfdev_spin_unlock(&slot->lock);
+
+    return retval;
+}
+
+export unsigned long
+bfdev_cache_shard_expire(bfdev_cache_shard_t *shard, bfdev_time_t now)
+{
+    bfdev_cache_slot_t *slot;
+    unsigned long count, expired;
+
+    expired = 0;
+    for (count = 0; count < shard->nslots; ++count) {
+        slot = &shard->slots[count];
+
+        bfdev_spin_lock(&slot->lock);
+        expired += bfdev_cache_expire(slot->head, now);
+        bfdev_spin_unlock(&slot->lock);
+    }
+
+    return expired;
+}
+
+export void
+bfdev_cache_shard_stats(bfdev_cache_shard_t *shard, bfdev_cache_stats_t *stats)
+{
+    bfdev_cache_stats_t value;
+    bfdev_cache_slot_t *slot;
+    unsigned long count;
+
+    bfport_memset(stats, 0, sizeof(*stats));
+    for (count = 0; count < shard->nslots; ++count) {
+        slot = &shard->slots[count];
+
+        bfdev_spin_lock(&slot->lock);
+        bfdev_cache_stats(slot->head, &value);
+        bfdev_spin_unlock(&slot->lock);
+
+        stats->used += value.used;
+        stats->changed += value.changed;
+        stats->starve += value.starve;
+        stats->hits += value.hits;
+        stats->misses += value.misses;
+        stats->expired += value.expired;
+        stats->weight += value.weight;
+
+        /*
+         * Partitions peak at different times, their sum is only an
+         * upper bound, report the highest partition peak instead.
+         */
+        stats->peak = bfdev_max(stats->peak, value.peak);
+    }
+}
+
+export void
+bfdev_cache_shard_reset(bfdev_cache_shard_t *shard)
+{
+    bfdev_cache_slot_t *slot;
+    unsigned long count;
+
+    for (count = 0; count < shard->nslots; ++count) {
+        slot = &shard->slots[count];
+
+        bfdev_spin_lock(&slot->lock);
+        bfdev_cache_reset(slot->head);
+        bfdev_spin_unlock(&slot->lock);
+    }
+}
+
+export bfdev_cache_shard_t *
+bfdev_cache_shard_create(const char *name, const bfdev_alloc_t *alloc,
+                         const bfdev_cache_ops_t *ops, unsigned long shards,
+                         unsigned long size, unsigned long maxpend, void *pdata)
+{
+    bfdev_cache_shard_t *shard;
+    bfdev_cache_slot_t *slot;
+    unsigned long count;
+
+    shards = bfdev_pow2_roundup(shards);
+    if (bfdev_unlikely(!shards || size / shards < 2))
+        return NULL;
+
+    shard = bfdev_zalloc(alloc, sizeof(*shard));
+    if (bfdev_unlikely(!shard))
+        return NULL;
+
+    shard->block = bfdev_zalloc(alloc, sizeof(*shard->slots) *
+                                shards + BFDEV_CACHELINE_SIZE);
+    if (bfdev_unlikely(!shard->block))
+        goto free_shard;
+
+    shard->slots = bfdev_align_ptr_high(shard->block, BFDEV_CACHELINE_SIZE);
+    shard->nslots = shards;
+    shard->alloc = alloc;
+    shard->ops = ops;
+    shard->pdata = pdata;
+
+    for (count = 0; count < shards; ++count) {
+        slot = &shard->slots[count];
+        bfdev_spin_init(&slot->lock);
+
+        slot->head = bfdev_cache_create(name, alloc, ops, size / shards,
+                                        maxpend, pdata);
+        if (bfdev_unlikely(!slot->head))
+            goto free_slots;
+    }
+
+    return shard;
+
+free_slots:
+    while (count--)
+        bfdev_cache_destroy(shard->slots[count].head);
+    bfdev_free(alloc, shard->block);
+
+free_shard:
+    bfdev_free(alloc, shard);
+    return NULL;
+}
+
+export void
+bfdev_cache_shard_destroy(bfdev_cache_shard_t *shard)
+{
+    const bfdev_alloc_t *alloc;
+    unsigned long count;
+
+    alloc = shard->alloc;
+    for (count = 0; count < shard->nslots; ++count)
+        bfdev_cache_destroy(shard->slots[count].head);
+
+    bfdev_free(alloc, shard->block);
+    bfdev_free(alloc, shard);
+}
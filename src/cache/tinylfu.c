@@ -0,0 +1,438 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/cache.h>
+#include <bfdev/hash.h>
+#include <bfdev/log2.h>
+#include <bfdev/minmax.h>
+
+#define TINYLFU_DEPTH 4
+#define TINYLFU_COUNTER_MAX 15
+#define TINYLFU_SAMPLE_FACTOR 10
+
+enum tinylfu_region {
+    TINYLFU_NONE = 0,
+    TINYLFU_WINDOW,
+    TINYLFU_PROBATION,
+    TINYLFU_PROTECTED,
+};
+
+/*
+ * Count-min sketch: every tag bumps one small counter in each row,
+ * the estimate is the minimum of them. Counters are halved once the
+ * sample count reaches a multiple of the cache size, so that stale
+ * popularity fades away.
+ */
+struct tinylfu_sketch {
+    uint8_t *table;
+    unsigned int bits;
+    unsigned long samples;
+    unsigned long limit;
+};
+
+struct tinylfu_head {
+    bfdev_cache_head_t cache;
+    struct tinylfu_sketch sketch;
+
+    bfdev_list_head_t window;
+    bfdev_list_head_t probation;
+    bfdev_list_head_t protected;
+
+    unsigned long window_max;
+    unsigned long protected_max;
+    unsigned long window_size;
+    unsigned long probation_size;
+    unsigned long protected_size;
+};
+
+struct tinylfu_node {
+    bfdev_cache_node_t cache;
+    bfdev_list_head_t node;
+    enum tinylfu_region region;
+};
+
+#define cache_to_tinylfu_head(ptr) \
+    bfdev_container_of(ptr, struct tinylfu_head, cache)
+
+#define cache_to_tinylfu_node(ptr) \
+    bfdev_container_of(ptr, struct tinylfu_node, cache)
+
+static __bfdev_always_inline unsigned long
+sketch_index(struct tinylfu_sketch *sketch, unsigned long value,
+             unsigned int row)
+{
+    unsigned long h1, h2;
+
+    /* Double hashing gives the row positions */
+    h1 = bfdev_hashvl(value);
+    h2 = bfdev_hashvl(h1 ^ value) | 1;
+    value = (h1 + row * h2) >> (BFDEV_BITS_PER_LONG - sketch->bits);
+
+    return (row << sketch->bits) + value;
+}
+
+static unsigned int
+sketch_estimate(struct tinylfu_sketch *sketch, unsigned long value)
+{
+    unsigned int row, freq;
+
+    freq = TINYLFU_COUNTER_MAX;
+    for (row = 0; row < TINYLFU_DEPTH; ++row)
+        freq = bfdev_min(freq, (unsigned int)
+            sketch->table[sketch_index(sketch, value, row)]);
+
+    return freq;
+}
+
+static void
+sketch_age(struct tinylfu_sketch *sketch)
+{
+    unsigned long count, size;
+
+    size = TINYLFU_DEPTH << sketch->bits;
+    for (count = 0; count < size; ++count)
+        sketch->table[count] >>= 1;
+
+    sketch->samples /= 2;
+}
+
+static void
+sketch_increment(struct tinylfu_sketch *sketch, unsigned long value)
+{
+    unsigned long index;
+    unsigned int row;
+
+    for (row = 0; row < TINYLFU_DEPTH; ++row) {
+        index = sketch_index(sketch, value, row);
+        if (sketch->table[index] < TINYLFU_COUNTER_MAX)
+            sketch->table[index]++;
+    }
+
+    if (++sketch->samples >= sketch->limit)
+        sketch_age(sketch);
+}
+
+static __bfdev_always_inline unsigned long
+tinylfu_hash(bfdev_cache_head_t *head, const void *tag)
+{
+    const bfdev_cache_ops_t *ops;
+
+    ops = head->ops;
+
+    return ops->hash(tag, head->pdata);
+}
+
+static __bfdev_always_inline unsigned int
+tinylfu_frequency(struct tinylfu_head *tinylfu_head, struct tinylfu_node *node)
+{
+    unsigned long value;
+
+    value = tinylfu_hash(&tinylfu_head->cache, node->cache.tag);
+
+    return sketch_estimate(&tinylfu_head->sketch, value);
+}
+
+static __bfdev_always_inline unsigned long *
+tinylfu_region_size(struct tinylfu_head *tinylfu_head,
+                    enum tinylfu_region region)
+{
+    switch (region) {
+        case TINYLFU_WINDOW:
+            return &tinylfu_head->window_size;
+
+        case TINYLFU_PROBATION:
+            return &tinylfu_head->probation_size;
+
+        case TINYLFU_PROTECTED:
+            return &tinylfu_head->protected_size;
+
+        default:
+            return NULL;
+    }
+}
+
+static void
+tinylfu_move(struct tinylfu_head *tinylfu_head, struct tinylfu_node *node,
+             enum tinylfu_region region)
+{
+    unsigned long *size;
+
+    if ((size = tinylfu_region_size(tinylfu_head, node->region)))
+        (*size)--;
+
+    if ((size = tinylfu_region_size(tinylfu_head, region)))
+        (*size)++;
+
+    node->region = region;
+}
+
+static __bfdev_always_inline struct tinylfu_node *
+tinylfu_last(bfdev_list_head_t *list)
+{
+    if (bfdev_list_check_empty(list))
+        return NULL;
+
+    return bfdev_list_last_entry(list, struct tinylfu_node, node);
+}
+
+static bool
+tinylfu_starving(bfdev_cache_head_t *head)
+{
+    struct tinylfu_head *tinylfu_head;
+
+    tinylfu_head = cache_to_tinylfu_head(head);
+
+    return bfdev_list_check_empty(&tinylfu_head->window) &&
+           bfdev_list_check_empty(&tinylfu_head->probation) &&
+           bfdev_list_check_empty(&tinylfu_head->protected);
+}
+
+static void
+tinylfu_miss(bfdev_cache_head_t *head, const void *tag)
+{
+    struct tinylfu_head *tinylfu_head;
+
+    tinylfu_head = cache_to_tinylfu_head(head);
+    sketch_increment(&tinylfu_head->sketch, tinylfu_hash(head, tag));
+}
+
+static bfdev_cache_node_t *
+tinylfu_obtain(bfdev_cache_head_t *head)
+{
+    struct tinylfu_head *tinylfu_head;
+    struct tinylfu_node *candidate, *victim;
+
+    tinylfu_head = cache_to_tinylfu_head(head);
+    candidate = NULL;
+
+    /* The new tag will enter the window, push its oldest entry out */
+    if (tinylfu_head->window_size >= tinylfu_head->window_max)
+        candidate = tinylfu_last(&tinylfu_head->window);
+
+    victim = tinylfu_last(&tinylfu_head->probation);
+    if (!victim)
+        victim = tinylfu_last(&tinylfu_head->protected);
+
+    if (candidate && victim) {
+        /* Admission: the window candidate must beat the main victim */
+        if (tinylfu_frequency(tinylfu_head, candidate) >
+            tinylfu_frequency(tinylfu_head, victim)) {
+            bfdev_list_move(&tinylfu_head->probation, &candidate->node);
+            tinylfu_move(tinylfu_head, candidate, TINYLFU_PROBATION);
+        } else
+            victim = candidate;
+    } else if (!victim) {
+        victim = candidate ?: tinylfu_last(&tinylfu_head->window);
+    }
+
+    bfdev_list_del(&victim->node);
+    tinylfu_move(tinylfu_head, victim, TINYLFU_NONE);
+
+    return &victim->cache;
+}
+
+static void
+tinylfu_get(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct tinylfu_node *tinylfu_node;
+
+    tinylfu_node = cache_to_tinylfu_node(node);
+
+    bfdev_list_del(&tinylfu_node->node);
+}
+
+static void
+tinylfu_put(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct tinylfu_head *tinylfu_head;
+    struct tinylfu_node *tinylfu_node;
+
+    tinylfu_head = cache_to_tinylfu_head(head);
+    tinylfu_node = cache_to_tinylfu_node(node);
+
+    switch (tinylfu_node->region) {
+        case TINYLFU_PROTECTED:
+            bfdev_list_add(&tinylfu_head->protected, &tinylfu_node->node);
+            break;
+
+        case TINYLFU_PROBATION:
+            bfdev_list_add(&tinylfu_head->probation, &tinylfu_node->node);
+            break;
+
+        default:
+            bfdev_list_add(&tinylfu_head->window, &tinylfu_node->node);
+            break;
+    }
+}
+
+static void
+tinylfu_update(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct tinylfu_head *tinylfu_head;
+    struct tinylfu_node *tinylfu_node, *demote;
+
+    tinylfu_head = cache_to_tinylfu_head(head);
+    tinylfu_node = cache_to_tinylfu_node(node);
+    sketch_increment(&tinylfu_head->sketch, tinylfu_hash(head, node->tag));
+
+    if (tinylfu_node->region != TINYLFU_PROBATION)
+        return;
+
+    /* Probation hit earns a protected slot */
+    tinylfu_move(tinylfu_head, tinylfu_node, TINYLFU_PROTECTED);
+    if (tinylfu_head->protected_size <= tinylfu_head->protected_max)
+        return;
+
+    demote = tinylfu_last(&tinylfu_head->protected);
+    if (demote) {
+        bfdev_list_move(&tinylfu_head->probation, &demote->node);
+        tinylfu_move(tinylfu_head, demote, TINYLFU_PROBATION);
+    }
+}
+
+static void
+tinylfu_clear(bfdev_cache_head_t *head, bfdev_cache_node_t *node)
+{
+    struct tinylfu_head *tinylfu_head;
+    struct tinylfu_node *tinylfu_node;
+
+    tinylfu_head = cache_to_tinylfu_head(head);
+    tinylfu_node = cache_to_tinylfu_node(node);
+    tinylfu_move(tinylfu_head, tinylfu_node, TINYLFU_WINDOW);
+
+    /* While the main region still has room, overflow enters freely */
+    if (tinylfu_head->window_size <= tinylfu_head->window_max)
+        return;
+
+    tinylfu_node = tinylfu_last(&tinylfu_head->window);
+    if (tinylfu_node) {
+        bfdev_list_move(&tinylfu_head->probation, &tinylfu_node->node);
+        tinylfu_move(tinylfu_head, tinylfu_node, TINYLFU_PROBATION);
+    }
+}
+
+static void
+tinylfu_reset(bfdev_cache_head_t *head)
+{
+    struct tinylfu_head *tinylfu_head;
+    struct tinylfu_sketch *sketch;
+    unsigned long count;
+
+    tinylfu_head = cache_to_tinylfu_head(head);
+    sketch = &tinylfu_head->sketch;
+
+    bfdev_list_head_init(&tinylfu_head->window);
+    bfdev_list_head_init(&tinylfu_head->probation);
+    bfdev_list_head_init(&tinylfu_head->protected);
+
+    for (count = 0; count < head->size; ++count)
+        cache_to_tinylfu_node(head->nodes[count])->region = TINYLFU_NONE;
+
+    tinylfu_head->window_size = 0;
+    tinylfu_head->probation_size = 0;
+    tinylfu_head->protected_size = 0;
+
+    bfport_memset(sketch->table, 0, TINYLFU_DEPTH << sketch->bits);
+    sketch->samples = 0;
+}
+
+static void
+tinylfu_release(const bfdev_alloc_t *alloc, struct tinylfu_head *tinylfu_head)
+{
+    bfdev_free(alloc, tinylfu_head->sketch.table);
+    bfdev_free(alloc, tinylfu_head->cache.nodes);
+    bfdev_free(alloc, tinylfu_head);
+}
+
+static bfdev_cache_head_t *
+tinylfu_create(const bfdev_alloc_t *alloc, unsigned long size)
+{
+    struct tinylfu_head *tinylfu_head;
+    struct tinylfu_node *tinylfu_node;
+    struct tinylfu_sketch *sketch;
+    bfdev_cache_head_t *head;
+    unsigned long count;
+
+    tinylfu_head = bfdev_zalloc(alloc, sizeof(*tinylfu_head));
+    if (bfdev_unlikely(!tinylfu_head))
+        return NULL;
+
+    head = &tinylfu_head->cache;
+    head->size = size;
+
+    /* 1% window, the main region splits 20% probation 80% protected */
+    tinylfu_head->window_max = bfdev_max(size / 100, 1UL);
+    tinylfu_head->protected_max = (size - tinylfu_head->window_max) * 4 / 5;
+
+    sketch = &tinylfu_head->sketch;
+    sketch->bits = bfdev_ilog2(size) + 1;
+    sketch->limit = size * TINYLFU_SAMPLE_FACTOR;
+
+    head->nodes = bfdev_zalloc_array(alloc, size, sizeof(*head->nodes));
+    sketch->table = bfdev_zalloc(alloc, TINYLFU_DEPTH << sketch->bits);
+    if (bfdev_unlikely(!head->nodes || !sketch->table))
+        goto free_head;
+
+    for (count = 0; count < size; ++count) {
+        tinylfu_node = bfdev_zalloc(alloc, sizeof(*tinylfu_node));
+        if (bfdev_unlikely(!tinylfu_node))
+            goto free_element;
+
+        head->nodes[count] = &tinylfu_node->cache;
+    }
+
+    tinylfu_reset(head);
+
+    return head;
+
+free_element:
+    while (count--)
+        bfdev_free(alloc, cache_to_tinylfu_node(head->nodes[count]));
+
+free_head:
+    tinylfu_release(alloc, tinylfu_head);
+    return NULL;
+}
+
+static void
+tinylfu_destroy(bfdev_cache_head_t *head)
+{
+    const bfdev_alloc_t *alloc;
+    unsigned long count;
+
+    alloc = head->alloc;
+    for (count = 0; count < head->size; ++count)
+        bfdev_free(alloc, cache_to_tinylfu_node(head->nodes[count]));
+
+    tinylfu_release(alloc, cache_to_tinylfu_head(head));
+}
+
+static bfdev_cache_algo_t
+tinylfu_algorithm = {
+    .name = "tinylfu",
+    .starving = tinylfu_starving,
+    .miss = tinylfu_miss,
+    .obtain = tinylfu_obtain,
+    .get = tinylfu_get,
+    .put = tinylfu_put,
+    .update = tinylfu_update,
+    .clear = tinylfu_clear,
+    .reset = tinylfu_reset,
+    .create = tinylfu_create,
+    .destroy = tinylfu_destroy,
+};
+
+static __bfdev_ctor int
+tinylfu_init(void)
+{
+    return bfdev_cache_register(&tinylfu_algorithm);
+}
+
+static __bfdev_dtor int
+tinylfu_exit(void)
+{
+    return bfdev_cache_unregister(&tinylfu_algorithm);
+}
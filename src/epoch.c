@@ -0,0 +1,61 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/epoch.h>
+#include <export.h>
+
+export void
+bfdev_epoch_register(bfdev_epoch_t *epoch, bfdev_epoch_reader_t *reader)
+{
+    bfdev_atomic_write(&reader->state, 0);
+    bfdev_spin_lock(&epoch->lock);
+    bfdev_list_add(&epoch->readers, &reader->list);
+    bfdev_spin_unlock(&epoch->lock);
+}
+
+export void
+bfdev_epoch_unregister(bfdev_epoch_t *epoch, bfdev_epoch_reader_t *reader)
+{
+    bfdev_spin_lock(&epoch->lock);
+    bfdev_list_del(&reader->list);
+    bfdev_spin_unlock(&epoch->lock);
+}
+
+static __bfdev_always_inline bool
+epoch_reader_stale(bfdev_epoch_reader_t *reader, bfdev_atomic_t target)
+{
+    bfdev_atomic_t state;
+
+    state = bfdev_load_acquire(&reader->state);
+    if (!state)
+        return false;
+
+    /* Entered before the epoch reached target */
+    return (bfdev_atomic_t)((state & ~1) - target) < 0;
+}
+
+export void
+bfdev_epoch_synchronize(bfdev_epoch_t *epoch)
+{
+    bfdev_epoch_reader_t *reader;
+    bfdev_atomic_t target;
+    unsigned int count;
+
+    /*
+     * The fetch-add is a full barrier: it orders the unlink done by
+     * the caller before the reader state loads below, pairing with
+     * the barrier in bfdev_epoch_enter().
+     */
+    target = bfdev_atomic_add_fetch(&epoch->epoch, 2);
+
+    bfdev_spin_lock(&epoch->lock);
+    bfdev_list_for_each_entry(reader, &epoch->readers, list) {
+        count = 0;
+        while (epoch_reader_stale(reader, target))
+            bfdev_spin_backoff(&count);
+    }
+    bfdev_spin_unlock(&epoch->lock);
+}
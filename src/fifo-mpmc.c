@@ -0,0 +1,146 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/fifo-mpmc.h>
+#include <bfdev/atomic.h>
+#include <bfdev/cmpxchg.h>
+#include <bfdev/align.h>
+#include <bfdev/log2.h>
+#include <export.h>
+
+static __bfdev_always_inline bfdev_atomic_t *
+mpmc_slot(bfdev_fifo_mpmc_t *mpmc, bfdev_atomic_t pos)
+{
+    return mpmc->slots + (pos & mpmc->mask) * mpmc->stride;
+}
+
+static __bfdev_always_inline void *
+mpmc_data(bfdev_atomic_t *slot)
+{
+    return slot + 1;
+}
+
+/*
+ * Count the slots from @pos on whose sequence equals their position
+ * plus @lap, i.e. that are ready for the caller, up to @len.
+ */
+static unsigned long
+mpmc_ready(bfdev_fifo_mpmc_t *mpmc, bfdev_atomic_t pos,
+           bfdev_atomic_t lap, unsigned long len, bfdev_atomic_t *diff)
+{
+    bfdev_atomic_t *slot;
+    unsigned long count;
+
+    for (count = 0; count < len; ++count) {
+        slot = mpmc_slot(mpmc, pos + count);
+        *diff = bfdev_load_acquire(slot) - (pos + count + lap);
+        if (*diff)
+            break;
+    }
+
+    return count;
+}
+
+static unsigned long
+mpmc_claim(bfdev_fifo_mpmc_t *mpmc, bfdev_atomic_t *index,
+           bfdev_atomic_t lap, unsigned long len, bfdev_atomic_t *start)
+{
+    bfdev_atomic_t pos, diff;
+    unsigned long count;
+
+    pos = bfdev_atomic_read(index);
+    for (;;) {
+        count = mpmc_ready(mpmc, pos, lap, len, &diff);
+        if (count) {
+            if (bfdev_try_cmpxchg(index, &pos, pos + count))
+                break;
+            continue;
+        }
+
+        /* The slot still belongs to the previous lap */
+        if (diff < 0)
+            return 0;
+
+        pos = bfdev_atomic_read(index);
+    }
+
+    *start = pos;
+
+    return count;
+}
+
+export unsigned long
+bfdev_fifo_mpmc_in(bfdev_fifo_mpmc_t *mpmc, const void *buff, unsigned long len)
+{
+    bfdev_atomic_t pos, *slot;
+    unsigned long count, index;
+
+    count = mpmc_claim(mpmc, &mpmc->enqueue, 0, len, &pos);
+    for (index = 0; index < count; ++index) {
+        slot = mpmc_slot(mpmc, pos + index);
+        bfport_memcpy(mpmc_data(slot), buff + index * mpmc->esize,
+                      mpmc->esize);
+        bfdev_store_release(slot, pos + index + 1);
+    }
+
+    return count;
+}
+
+export unsigned long
+bfdev_fifo_mpmc_out(bfdev_fifo_mpmc_t *mpmc, void *buff, unsigned long len)
+{
+    bfdev_atomic_t pos, *slot;
+    unsigned long count, index;
+
+    count = mpmc_claim(mpmc, &mpmc->dequeue, 1, len, &pos);
+    for (index = 0; index < count; ++index) {
+        slot = mpmc_slot(mpmc, pos + index);
+        bfport_memcpy(buff + index * mpmc->esize, mpmc_data(slot),
+                      mpmc->esize);
+        bfdev_store_release(slot, pos + index + mpmc->mask + 1);
+    }
+
+    return count;
+}
+
+export int
+bfdev_fifo_mpmc_alloc(bfdev_fifo_mpmc_t *mpmc, const bfdev_alloc_t *alloc,
+                      size_t esize, size_t size)
+{
+    bfdev_atomic_t *slot;
+    unsigned long count;
+
+    size = bfdev_pow2_roundup(size);
+    if (size < 2 || !esize)
+        return -BFDEV_EINVAL;
+
+    mpmc->stride = bfdev_align_high(sizeof(*slot) + esize, sizeof(*slot));
+    mpmc->slots = bfdev_malloc_array(alloc, size, mpmc->stride);
+    if (!mpmc->slots)
+        return -BFDEV_ENOMEM;
+
+    mpmc->alloc = alloc;
+    mpmc->mask = size - 1;
+    mpmc->esize = esize;
+
+    for (count = 0; count < size; ++count) {
+        slot = mpmc_slot(mpmc, count);
+        bfdev_atomic_write(slot, count);
+    }
+
+    bfdev_atomic_write(&mpmc->enqueue, 0);
+    bfdev_atomic_write(&mpmc->dequeue, 0);
+
+    return -BFDEV_ENOERR;
+}
+
+export void
+bfdev_fifo_mpmc_free(bfdev_fifo_mpmc_t *mpmc)
+{
+    bfdev_free(mpmc->alloc, mpmc->slots);
+    mpmc->slots = NULL;
+    mpmc->mask = 0;
+}
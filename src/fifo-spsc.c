@@ -0,0 +1,145 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/fifo-spsc.h>
+#include <bfdev/log2.h>
+#include <bfdev/minmax.h>
+#include <export.h>
+
+static __bfdev_always_inline void
+spsc_copy_in(bfdev_fifo_spsc_t *spsc, const void *buff,
+             unsigned long len, unsigned long offset)
+{
+    unsigned long size, llen;
+
+    size = (spsc->mask + 1) * spsc->esize;
+    offset = (offset & spsc->mask) * spsc->esize;
+    len *= spsc->esize;
+
+    llen = bfdev_min(len, size - offset);
+    bfport_memcpy(spsc->data + offset, buff, llen);
+    bfport_memcpy(spsc->data, buff + llen, len - llen);
+}
+
+static __bfdev_always_inline void
+spsc_copy_out(bfdev_fifo_spsc_t *spsc, void *buff,
+              unsigned long len, unsigned long offset)
+{
+    unsigned long size, llen;
+
+    size = (spsc->mask + 1) * spsc->esize;
+    offset = (offset & spsc->mask) * spsc->esize;
+    len *= spsc->esize;
+
+    llen = bfdev_min(len, size - offset);
+    bfport_memcpy(buff, spsc->data + offset, llen);
+    bfport_memcpy(buff + llen, spsc->data, len - llen);
+}
+
+export unsigned long
+bfdev_fifo_spsc_in(bfdev_fifo_spsc_t *spsc, const void *buff, unsigned long len)
+{
+    unsigned long in, unused;
+
+    in = spsc->in;
+    unused = spsc->mask + 1 - (in - spsc->cached_out);
+
+    /* Only look at the consumer when the cached view runs short */
+    if (unused < len) {
+        spsc->cached_out = bfdev_load_acquire(&spsc->out);
+        unused = spsc->mask + 1 - (in - spsc->cached_out);
+        bfdev_min_adj(len, unused);
+    }
+
+    if (!len)
+        return 0;
+
+    spsc_copy_in(spsc, buff, len, in);
+    bfdev_store_release(&spsc->in, in + len);
+
+    return len;
+}
+
+export unsigned long
+bfdev_fifo_spsc_out(bfdev_fifo_spsc_t *spsc, void *buff, unsigned long len)
+{
+    unsigned long out, valid;
+
+    out = spsc->out;
+    valid = spsc->cached_in - out;
+
+    if (valid < len) {
+        spsc->cached_in = bfdev_load_acquire(&spsc->in);
+        valid = spsc->cached_in - out;
+        bfdev_min_adj(len, valid);
+    }
+
+    if (!len)
+        return 0;
+
+    spsc_copy_out(spsc, buff, len, out);
+    bfdev_store_release(&spsc->out, out + len);
+
+    return len;
+}
+
+export int
+bfdev_fifo_spsc_init(bfdev_fifo_spsc_t *spsc, void *buffer,
+                     size_t esize, size_t size)
+{
+    if (size < 2 || (size & (size - 1)) || !esize)
+        return -BFDEV_EINVAL;
+
+    spsc->alloc = NULL;
+    spsc->owned = false;
+    spsc->mask = size - 1;
+    spsc->esize = esize;
+    spsc->data = buffer;
+
+    spsc->in = spsc->cached_out = 0;
+    spsc->out = spsc->cached_in = 0;
+
+    return -BFDEV_ENOERR;
+}
+
+export int
+bfdev_fifo_spsc_alloc(bfdev_fifo_spsc_t *spsc, const bfdev_alloc_t *alloc,
+                      size_t esize, size_t size)
+{
+    void *buffer;
+    int retval;
+
+    size = bfdev_pow2_roundup(size);
+    if (size < 2)
+        return -BFDEV_EINVAL;
+
+    buffer = bfdev_malloc_array(alloc, size, esize);
+    if (!buffer)
+        return -BFDEV_ENOMEM;
+
+    retval = bfdev_fifo_spsc_init(spsc, buffer, esize, size);
+    if (retval) {
+        bfdev_free(alloc, buffer);
+        return retval;
+    }
+
+    spsc->alloc = alloc;
+    spsc->owned = true;
+
+    return -BFDEV_ENOERR;
+}
+
+export void
+bfdev_fifo_spsc_free(bfdev_fifo_spsc_t *spsc)
+{
+    if (!spsc->owned)
+        return;
+
+    bfdev_free(spsc->alloc, spsc->data);
+    spsc->data = NULL;
+    spsc->owned = false;
+    spsc->mask = 0;
+}
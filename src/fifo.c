@@ -7,6 +7,9 @@
 #include <bfdev/log2.h>
 #include <bfdev/fifo.h>
 #include <bfdev/bits.h>
+#include <bfdev/span.h>
+#include <bfdev/mirror.h>
+#include <bfdev/minmax.h>
 #include <export.h>
 
 #define FIFO_GENERIC_COPY(copy1, copy2, fold1, fold2) do {  \
@@ -22,7 +25,10 @@
         len *= esize;                                       \
     }                                                       \
                                                             \
-    llen = bfdev_min(len, size - offset);                   \
+    if (fifo->mirror)                                       \
+        llen = len;                                         \
+    else                                                    \
+        llen = bfdev_min(len, size - offset);               \
     bfport_memcpy(copy1, copy2, llen);                      \
     bfport_memcpy(fold1, fold2, len - llen);                \
 } while (0)
@@ -47,10 +53,38 @@ fifo_in_copy(bfdev_fifo_t *fifo, const void *buff, unsigned long len,
     );
 }
 
+static __bfdev_always_inline void
+fifo_span(bfdev_fifo_t *fifo, bfdev_span_t *span, unsigned long len,
+          unsigned long offset)
+{
+    unsigned long size, esize, llen;
+
+    size = fifo->mask + 1;
+    esize = fifo->esize;
+    offset &= fifo->mask;
+
+    if (esize != 1) {
+        offset *= esize;
+        size *= esize;
+        len *= esize;
+    }
+
+    /* A mirrored buffer continues past its end */
+    if (fifo->mirror)
+        llen = len;
+    else
+        llen = bfdev_min(len, size - offset);
+
+    span[0].base = fifo->data + offset;
+    span[0].len = llen;
+    span[1].base = fifo->data;
+    span[1].len = len - llen;
+}
+
 static __bfdev_always_inline unsigned long
 fifo_record_peek(bfdev_fifo_t *fifo, unsigned long recsize)
 {
-    unsigned long mask, offset, length;
+    unsigned long mask, offset, length, shift;
     uint8_t *data;
 
     mask = fifo->mask;
@@ -64,9 +98,9 @@ fifo_record_peek(bfdev_fifo_t *fifo, unsigned long recsize)
         mask += fifo->esize - 1;
     }
 
-    while (recsize--) {
-        length <<= BFDEV_BITS_PER_U8;
-        length |= data[offset & mask];
+    /* Little endian, the same order record_poke stores */
+    for (shift = 0; recsize--; shift += BFDEV_BITS_PER_U8) {
+        length |= (unsigned long)data[offset & mask] << shift;
         offset += fifo->esize;
     }
 
@@ -74,13 +108,13 @@ fifo_record_peek(bfdev_fifo_t *fifo, unsigned long recsize)
 }
 
 static __bfdev_always_inline void
-fifo_record_poke(bfdev_fifo_t *fifo, unsigned long len, unsigned long recsize)
+fifo_record_poke(bfdev_fifo_t *fifo, unsigned long len, unsigned long recsize,
+                 unsigned long offset)
 {
-    unsigned long mask, offset;
+    unsigned long mask;
     uint8_t *data;
 
     mask = fifo->mask;
-    offset = fifo->out;
     data = fifo->data;
 
     if (fifo->esize != 1) {
@@ -150,6 +184,54 @@ bfdev_fifo_in_flat(bfdev_fifo_t *fifo, const void *buff, unsigned long len)
     return len;
 }
 
+export unsigned long
+bfdev_fifo_reserve_flat(bfdev_fifo_t *fifo, bfdev_span_t *span, unsigned long len)
+{
+    unsigned long unused;
+
+    unused = fifo_unused(fifo);
+    bfdev_min_adj(len, unused);
+    fifo_span(fifo, span, len, fifo->in);
+
+    return len;
+}
+
+export unsigned long
+bfdev_fifo_commit_flat(bfdev_fifo_t *fifo, unsigned long len)
+{
+    unsigned long unused;
+
+    unused = fifo_unused(fifo);
+    bfdev_min_adj(len, unused);
+    fifo->in += len;
+
+    return len;
+}
+
+export unsigned long
+bfdev_fifo_peek_span_flat(bfdev_fifo_t *fifo, bfdev_span_t *span, unsigned long len)
+{
+    unsigned long valid;
+
+    valid = fifo_valid(fifo);
+    bfdev_min_adj(len, valid);
+    fifo_span(fifo, span, len, fifo->out);
+
+    return len;
+}
+
+export unsigned long
+bfdev_fifo_consume_flat(bfdev_fifo_t *fifo, unsigned long len)
+{
+    unsigned long valid;
+
+    valid = fifo_valid(fifo);
+    bfdev_min_adj(len, valid);
+    fifo->out += len;
+
+    return len;
+}
+
 export unsigned long
 bfdev_fifo_peek_record(bfdev_fifo_t *fifo, void *buff, unsigned long len,
                        unsigned long record)
@@ -190,13 +272,45 @@ bfdev_fifo_in_record(bfdev_fifo_t *fifo, const void *buff, unsigned long len,
     if (len + record > fifo_unused(fifo))
         return 0;
 
-    fifo_record_poke(fifo, len, record);
+    fifo_record_poke(fifo, len, record, fifo->in);
     fifo_in_copy(fifo, buff, len, fifo->in + record);
     fifo->in += len + record;
 
     return len;
 }
 
+export unsigned long
+bfdev_fifo_peek_span_record(bfdev_fifo_t *fifo, bfdev_span_t *span, unsigned long len,
+                            unsigned long record)
+{
+    unsigned long datalen;
+
+    if (fifo_empty(fifo)) {
+        fifo_span(fifo, span, 0, fifo->out);
+        return 0;
+    }
+
+    datalen = fifo_record_peek(fifo, record);
+    bfdev_min_adj(len, datalen);
+    fifo_span(fifo, span, len, fifo->out + record);
+
+    return len;
+}
+
+export unsigned long
+bfdev_fifo_consume_record(bfdev_fifo_t *fifo, unsigned long record)
+{
+    unsigned long datalen;
+
+    if (fifo_empty(fifo))
+        return 0;
+
+    datalen = fifo_record_peek(fifo, record);
+    fifo->out += datalen + record;
+
+    return datalen;
+}
+
 export int
 bfdev_fifo_dynamic_alloc(bfdev_fifo_t *fifo, const bfdev_alloc_t *alloc,
                          size_t esize, size_t size)
@@ -214,6 +328,39 @@ bfdev_fifo_dynamic_alloc(bfdev_fifo_t *fifo, const bfdev_alloc_t *alloc,
     fifo->mask = size - 1;
     fifo->esize = esize;
     fifo->alloc = alloc;
+    fifo->mirror = false;
+
+    return -BFDEV_ENOERR;
+}
+
+export int
+bfdev_fifo_mirror_alloc(bfdev_fifo_t *fifo, size_t esize, size_t size)
+{
+    size_t granule;
+    int retval;
+
+    granule = bfdev_mirror_granule();
+    if (!granule)
+        return -BFDEV_EOPNOTSUPP;
+
+    /* Power of two elements keep the buffer whole pages */
+    if (!esize || (esize & (esize - 1)))
+        return -BFDEV_EINVAL;
+
+    size = bfdev_pow2_roundup(bfdev_max(size, granule / esize));
+    if (size < 2)
+        return -BFDEV_EINVAL;
+
+    retval = bfdev_mirror_map(&fifo->data, size * esize);
+    if (retval)
+        return retval;
+
+    fifo->in = 0;
+    fifo->out = 0;
+    fifo->mask = size - 1;
+    fifo->esize = esize;
+    fifo->alloc = NULL;
+    fifo->mirror = true;
 
     return -BFDEV_ENOERR;
 }
@@ -222,13 +369,23 @@ export void
 bfdev_fifo_dynamic_free(bfdev_fifo_t *fifo)
 {
     const bfdev_alloc_t *alloc;
+    unsigned long size, esize;
+
+    size = fifo->mask + 1;
+    esize = fifo->esize;
 
     fifo->in = 0;
     fifo->out = 0;
     fifo->mask = 0;
     fifo->esize = 0;
 
-    alloc = fifo->alloc;
-    bfdev_free(alloc, fifo->data);
+    if (fifo->mirror)
+        bfdev_mirror_unmap(fifo->data, size * esize);
+    else {
+        alloc = fifo->alloc;
+        bfdev_free(alloc, fifo->data);
+    }
+
     fifo->data = NULL;
+    fifo->mirror = false;
 }
@@ -0,0 +1,434 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/flatmap.h>
+#include <bfdev/bitops.h>
+#include <bfdev/hash.h>
+#include <export.h>
+
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
+#define FLATMAP_H2_BITS 7
+#define FLATMAP_H2_MASK BFDEV_BIT_LOW_MASK(FLATMAP_H2_BITS)
+#define FLATMAP_MAX_BITS (BFDEV_BITS_PER_LONG - FLATMAP_H2_BITS)
+
+static __bfdev_always_inline unsigned int
+group_match(const uint8_t *group, uint8_t value)
+{
+#ifdef __SSE2__
+    __m128i ctrl, match;
+
+    ctrl = _mm_loadu_si128((const __m128i *)group);
+    match = _mm_cmpeq_epi8(_mm_set1_epi8((char)value), ctrl);
+
+    return (unsigned int)_mm_movemask_epi8(match);
+#else
+    unsigned int count, mask;
+
+    for (mask = count = 0; count < BFDEV_FLATMAP_GROUP; ++count)
+        mask |= (unsigned int)(group[count] == value) << count;
+
+    return mask;
+#endif
+}
+
+static __bfdev_always_inline unsigned int
+group_match_empty(const uint8_t *group)
+{
+    return group_match(group, BFDEV_FLATMAP_EMPTY);
+}
+
+static __bfdev_always_inline unsigned int
+group_match_free(const uint8_t *group)
+{
+#ifdef __SSE2__
+    __m128i ctrl;
+
+    /* Both empty and deleted have the high bit set */
+    ctrl = _mm_loadu_si128((const __m128i *)group);
+
+    return (unsigned int)_mm_movemask_epi8(ctrl);
+#else
+    unsigned int count, mask;
+
+    for (mask = count = 0; count < BFDEV_FLATMAP_GROUP; ++count)
+        mask |= (unsigned int)(group[count] >> 7) << count;
+
+    return mask;
+#endif
+}
+
+static __bfdev_always_inline unsigned long
+flatmap_hash_node(bfdev_flatmap_t *flatmap, const void *node)
+{
+    const bfdev_flatmap_ops_t *ops;
+    unsigned long retval;
+
+    ops = flatmap->ops;
+    retval = ops->hash_node(node, flatmap->pdata);
+
+    return bfdev_hashvl(retval);
+}
+
+static __bfdev_always_inline unsigned long
+flatmap_hash_key(bfdev_flatmap_t *flatmap, const void *key)
+{
+    const bfdev_flatmap_ops_t *ops;
+    unsigned long retval;
+
+    ops = flatmap->ops;
+    retval = ops->hash_key(key, flatmap->pdata);
+
+    return bfdev_hashvl(retval);
+}
+
+static __bfdev_always_inline long
+flatmap_equal(bfdev_flatmap_t *flatmap, const void *node1,
+              const void *node2)
+{
+    const bfdev_flatmap_ops_t *ops;
+    long retval;
+
+    ops = flatmap->ops;
+    retval = ops->equal(node1, node2, flatmap->pdata);
+
+    return retval;
+}
+
+static __bfdev_always_inline long
+flatmap_find(bfdev_flatmap_t *flatmap, const void *key,
+             const void *node)
+{
+    const bfdev_flatmap_ops_t *ops;
+    long retval;
+
+    ops = flatmap->ops;
+    retval = ops->find(node, key, flatmap->pdata);
+
+    return retval;
+}
+
+/* H1 selects the first probe position, taken from the high bits */
+static __bfdev_always_inline unsigned long
+flatmap_h1(unsigned long hash, unsigned int bits)
+{
+    return hash >> (BFDEV_BITS_PER_LONG - bits);
+}
+
+/* H2 is stored in the control byte, taken right below H1 */
+static __bfdev_always_inline uint8_t
+flatmap_h2(unsigned long hash, unsigned int bits)
+{
+    hash >>= BFDEV_BITS_PER_LONG - bits - FLATMAP_H2_BITS;
+    return hash & FLATMAP_H2_MASK;
+}
+
+static __bfdev_always_inline unsigned long
+flatmap_max_load(unsigned long capacity)
+{
+    /* Keep at most 87.5% of slots filled */
+    return capacity - capacity / 8;
+}
+
+static __bfdev_always_inline void
+flatmap_set_ctrl(bfdev_flatmap_t *flatmap, unsigned long index,
+                 uint8_t ctrl)
+{
+    flatmap->ctrls[index] = ctrl;
+
+    /* Keep the cloned group behind the table in sync */
+    if (index < BFDEV_FLATMAP_GROUP)
+        flatmap->ctrls[flatmap->capacity + index] = ctrl;
+}
+
+static inline bool
+flatmap_find_node(bfdev_flatmap_t *flatmap, const void *node,
+                  unsigned long hash, unsigned long *index)
+{
+    unsigned long mask, pos, probe, walk;
+    unsigned int match;
+    uint8_t *group, h2;
+
+    if (!flatmap->capacity)
+        return false;
+
+    mask = flatmap->capacity - 1;
+    pos = flatmap_h1(hash, flatmap->bits);
+    h2 = flatmap_h2(hash, flatmap->bits);
+
+    /* Overlap the slot miss with the control byte miss */
+    bfdev_prefetch(flatmap->slots + pos);
+
+    for (probe = 0; probe < flatmap->capacity; probe += BFDEV_FLATMAP_GROUP) {
+        group = flatmap->ctrls + pos;
+
+        for (match = group_match(group, h2); match; match &= match - 1) {
+            walk = (pos + bfdev_ffsuf(match)) & mask;
+            if (!flatmap_equal(flatmap, node, flatmap->slots[walk])) {
+                *index = walk;
+                return true;
+            }
+        }
+
+        if (group_match_empty(group))
+            break;
+
+        pos = (pos + BFDEV_FLATMAP_GROUP) & mask;
+    }
+
+    return false;
+}
+
+static inline bool
+flatmap_find_key(bfdev_flatmap_t *flatmap, const void *key,
+                 unsigned long hash, unsigned long *index)
+{
+    unsigned long mask, pos, probe, walk;
+    unsigned int match;
+    uint8_t *group, h2;
+
+    if (!flatmap->capacity)
+        return false;
+
+    mask = flatmap->capacity - 1;
+    pos = flatmap_h1(hash, flatmap->bits);
+    h2 = flatmap_h2(hash, flatmap->bits);
+
+    /* Overlap the slot miss with the control byte miss */
+    bfdev_prefetch(flatmap->slots + pos);
+
+    for (probe = 0; probe < flatmap->capacity; probe += BFDEV_FLATMAP_GROUP) {
+        group = flatmap->ctrls + pos;
+
+        for (match = group_match(group, h2); match; match &= match - 1) {
+            walk = (pos + bfdev_ffsuf(match)) & mask;
+            if (!flatmap_find(flatmap, key, flatmap->slots[walk])) {
+                *index = walk;
+                return true;
+            }
+        }
+
+        if (group_match_empty(group))
+            break;
+
+        pos = (pos + BFDEV_FLATMAP_GROUP) & mask;
+    }
+
+    return false;
+}
+
+static inline unsigned long
+flatmap_find_free(bfdev_flatmap_t *flatmap, unsigned long hash)
+{
+    unsigned long mask, pos;
+    unsigned int match;
+
+    mask = flatmap->capacity - 1;
+    pos = flatmap_h1(hash, flatmap->bits);
+
+    /* The load factor guarantees there is always a free slot */
+    while (!(match = group_match_free(flatmap->ctrls + pos)))
+        pos = (pos + BFDEV_FLATMAP_GROUP) & mask;
+
+    return (pos + bfdev_ffsuf(match)) & mask;
+}
+
+static int
+flatmap_rehash(bfdev_flatmap_t *flatmap, unsigned int nbits)
+{
+    bfdev_flatmap_t nflatmap;
+    unsigned long ncapacity, index, walk, hash;
+    void *block, *node;
+
+    if (nbits > FLATMAP_MAX_BITS)
+        return -BFDEV_EOVERFLOW;
+
+    ncapacity = BFDEV_BIT(nbits);
+    block = bfdev_malloc(flatmap->alloc, ncapacity * sizeof(*nflatmap.slots) +
+                         ncapacity + BFDEV_FLATMAP_GROUP);
+    if (bfdev_unlikely(!block))
+        return -BFDEV_ENOMEM;
+
+    nflatmap = *flatmap;
+    nflatmap.slots = block;
+    nflatmap.ctrls = block + ncapacity * sizeof(*nflatmap.slots);
+    nflatmap.bits = nbits;
+    nflatmap.capacity = ncapacity;
+    nflatmap.growth = flatmap_max_load(ncapacity) - flatmap->used;
+    bfport_memset(nflatmap.ctrls, BFDEV_FLATMAP_EMPTY,
+                  ncapacity + BFDEV_FLATMAP_GROUP);
+
+    bfdev_flatmap_for_each(node, flatmap, index) {
+        hash = flatmap_hash_node(flatmap, node);
+        walk = flatmap_find_free(&nflatmap, hash);
+        flatmap_set_ctrl(&nflatmap, walk, flatmap_h2(hash, nbits));
+        nflatmap.slots[walk] = node;
+    }
+
+    /* Slots and control bytes share one block */
+    bfdev_free(flatmap->alloc, flatmap->slots);
+    *flatmap = nflatmap;
+
+    return -BFDEV_ENOERR;
+}
+
+static inline int
+flatmap_grow(bfdev_flatmap_t *flatmap)
+{
+    unsigned int nbits;
+
+    /*
+     * If the table is mostly filled with tombstones, rehashing in
+     * place is enough to reclaim room, otherwise double the size.
+     */
+    nbits = flatmap->bits;
+    if (flatmap->used >= flatmap_max_load(flatmap->capacity) / 2)
+        nbits++;
+
+    if (nbits < BFDEV_FLATMAP_MIN_BITS)
+        nbits = BFDEV_FLATMAP_MIN_BITS;
+
+    return flatmap_rehash(flatmap, nbits);
+}
+
+export int
+bfdev_flatmap_insert(bfdev_flatmap_t *flatmap, void *node, void **old,
+                     bfdev_hashmap_strategy_t strategy)
+{
+    unsigned long hash, index;
+    int retval;
+
+    if (bfdev_unlikely(!node))
+        return -BFDEV_EINVAL;
+
+    hash = flatmap_hash_node(flatmap, node);
+    if (strategy != BFDEV_HASHMAP_APPEND &&
+        flatmap_find_node(flatmap, node, hash, &index)) {
+        if (old)
+            *old = flatmap->slots[index];
+
+        if (strategy == BFDEV_HASHMAP_ADD)
+            return -BFDEV_EEXIST;
+
+        /* BFDEV_HASHMAP_{SET / UPDATE} */
+        flatmap->slots[index] = node;
+        return -BFDEV_ENOERR;
+    }
+
+    if (strategy == BFDEV_HASHMAP_UPDATE)
+        return -BFDEV_ENOENT;
+
+    if (!flatmap->capacity) {
+        retval = flatmap_grow(flatmap);
+        if (retval)
+            return retval;
+    }
+
+    index = flatmap_find_free(flatmap, hash);
+    if (!flatmap->growth && flatmap->ctrls[index] == BFDEV_FLATMAP_EMPTY) {
+        retval = flatmap_grow(flatmap);
+        if (retval)
+            return retval;
+        index = flatmap_find_free(flatmap, hash);
+    }
+
+    if (flatmap->ctrls[index] == BFDEV_FLATMAP_EMPTY)
+        flatmap->growth--;
+
+    flatmap_set_ctrl(flatmap, index, flatmap_h2(hash, flatmap->bits));
+    flatmap->slots[index] = node;
+    flatmap->used++;
+
+    return -BFDEV_ENOERR;
+}
+
+export int
+bfdev_flatmap_del(bfdev_flatmap_t *flatmap, const void *key, void **node)
+{
+    unsigned long hash, index, before;
+    unsigned int empty_before, empty_after;
+    unsigned int leading, trailing;
+
+    hash = flatmap_hash_key(flatmap, key);
+    if (!flatmap_find_key(flatmap, key, hash, &index))
+        return -BFDEV_ENOENT;
+
+    if (node)
+        *node = flatmap->slots[index];
+
+    before = (index - BFDEV_FLATMAP_GROUP) & (flatmap->capacity - 1);
+    empty_before = group_match_empty(flatmap->ctrls + before);
+    empty_after = group_match_empty(flatmap->ctrls + index);
+
+    /*
+     * If every group window covering this slot still holds an empty
+     * slot, no probe sequence could ever have passed through it, so
+     * it can become empty again instead of leaving a tombstone.
+     */
+    if (empty_before && empty_after) {
+        leading = BFDEV_FLATMAP_GROUP - 1 - bfdev_flsuf(empty_before);
+        trailing = bfdev_ffsuf(empty_after);
+
+        if (leading + trailing < BFDEV_FLATMAP_GROUP) {
+            flatmap_set_ctrl(flatmap, index, BFDEV_FLATMAP_EMPTY);
+            flatmap->growth++;
+            goto finish;
+        }
+    }
+
+    flatmap_set_ctrl(flatmap, index, BFDEV_FLATMAP_DELETED);
+
+finish:
+    flatmap->used--;
+    return -BFDEV_ENOERR;
+}
+
+export void *
+bfdev_flatmap_find(bfdev_flatmap_t *flatmap, const void *key)
+{
+    unsigned long hash, index;
+
+    hash = flatmap_hash_key(flatmap, key);
+    if (!flatmap_find_key(flatmap, key, hash, &index))
+        return NULL;
+
+    return flatmap->slots[index];
+}
+
+export int
+bfdev_flatmap_reserve(bfdev_flatmap_t *flatmap, unsigned long count)
+{
+    unsigned int nbits;
+
+    nbits = BFDEV_FLATMAP_MIN_BITS;
+    while (flatmap_max_load(BFDEV_BIT(nbits)) < count) {
+        if (++nbits > FLATMAP_MAX_BITS)
+            return -BFDEV_EOVERFLOW;
+    }
+
+    if (nbits <= flatmap->bits)
+        return -BFDEV_ENOERR;
+
+    return flatmap_rehash(flatmap, nbits);
+}
+
+export void
+bfdev_flatmap_release(bfdev_flatmap_t *flatmap)
+{
+    const bfdev_alloc_t *alloc;
+
+    alloc = flatmap->alloc;
+    bfdev_free(alloc, flatmap->slots);
+    flatmap->slots = NULL;
+    flatmap->ctrls = NULL;
+
+    flatmap->used = 0;
+    flatmap->growth = 0;
+    flatmap->capacity = 0;
+    flatmap->bits = 0;
+}
@@ -59,6 +59,25 @@ hashmap_find(bfdev_hashmap_t *hashmap, const void *key,
     return retval;
 }
 
+static __bfdev_always_inline unsigned long
+hashmap_hash_stored(bfdev_hashmap_t *hashmap,
+                    const bfdev_hlist_node_t *node)
+{
+    if (bfdev_hashmap_cached_test(hashmap))
+        return bfdev_hashmap_node_entry(node)->hash;
+
+    return hashmap_hash_node(hashmap, node);
+}
+
+static __bfdev_always_inline bool
+hashmap_hash_differ(bfdev_hashmap_t *hashmap,
+                    const bfdev_hlist_node_t *node, unsigned long hash)
+{
+    /* Cheap word compare before calling into the user comparator */
+    return bfdev_hashmap_cached_test(hashmap) &&
+           bfdev_hashmap_node_entry(node)->hash != hash;
+}
+
 static __bfdev_always_inline bool
 hashmap_need_extend(bfdev_hashmap_t *hashmap)
 {
@@ -100,6 +119,23 @@ hashmap_find_node(bfdev_hashmap_t *hashmap, const bfdev_hlist_node_t *node,
 
     index = bfdev_hashtbl_index(hashmap->capacity, hash);
     bfdev_hashtbl_for_each_idx(walk, hashmap->buckets, hashmap->capacity, index) {
+        if (hashmap_hash_differ(hashmap, walk, hash))
+            continue;
+        if (!hashmap_equal(hashmap, node, walk))
+            return walk;
+    }
+
+    if (!hashmap->obuckets)
+        return NULL;
+
+    /* Fall back to the table being migrated */
+    index = bfdev_hashtbl_index(hashmap->ocapacity, hash);
+    if (index < hashmap->migrate)
+        return NULL;
+
+    bfdev_hashtbl_for_each_idx(walk, hashmap->obuckets, hashmap->ocapacity, index) {
+        if (hashmap_hash_differ(hashmap, walk, hash))
+            continue;
         if (!hashmap_equal(hashmap, node, walk))
             return walk;
     }
@@ -119,6 +155,23 @@ hashmap_find_key(bfdev_hashmap_t *hashmap, const void *key,
 
     index = bfdev_hashtbl_index(hashmap->capacity, hash);
     bfdev_hashtbl_for_each_idx(walk, hashmap->buckets, hashmap->capacity, index) {
+        if (hashmap_hash_differ(hashmap, walk, hash))
+            continue;
+        if (!hashmap_find(hashmap, key, walk))
+            return walk;
+    }
+
+    if (!hashmap->obuckets)
+        return NULL;
+
+    /* Fall back to the table being migrated */
+    index = bfdev_hashtbl_index(hashmap->ocapacity, hash);
+    if (index < hashmap->migrate)
+        return NULL;
+
+    bfdev_hashtbl_for_each_idx(walk, hashmap->obuckets, hashmap->ocapacity, index) {
+        if (hashmap_hash_differ(hashmap, walk, hash))
+            continue;
         if (!hashmap_find(hashmap, key, walk))
             return walk;
     }
@@ -126,6 +179,31 @@ hashmap_find_key(bfdev_hashmap_t *hashmap, const void *key,
     return NULL;
 }
 
+static void
+hashmap_migrate(bfdev_hashmap_t *hashmap, unsigned long step)
+{
+    bfdev_hlist_node_t *walk, *tmp;
+    bfdev_hlist_head_t *bucket;
+    unsigned long value;
+
+    while (hashmap->obuckets && step--) {
+        bucket = &hashmap->obuckets[hashmap->migrate];
+        bfdev_hlist_for_each_safe(walk, tmp, bucket) {
+            value = hashmap_hash_stored(hashmap, walk);
+            bfdev_hlist_del(walk);
+            bfdev_hashtbl_add(hashmap->buckets, hashmap->capacity, walk, value);
+        }
+
+        if (++hashmap->migrate < hashmap->ocapacity)
+            continue;
+
+        bfdev_free(hashmap->alloc, hashmap->obuckets);
+        hashmap->obuckets = NULL;
+        hashmap->ocapacity = 0;
+        hashmap->migrate = 0;
+    }
+}
+
 static inline int
 hashmap_rehash(bfdev_hashmap_t *hashmap, unsigned int nbits)
 {
@@ -137,18 +215,37 @@ hashmap_rehash(bfdev_hashmap_t *hashmap, unsigned int nbits)
     ncapacity = BFDEV_BIT(nbits);
     alloc = hashmap->alloc;
 
-    nbuckets = bfdev_malloc_array(alloc, ncapacity, sizeof(*nbuckets));
+    /* Empty hlist heads are all zero, let the allocator provide them */
+    nbuckets = bfdev_zalloc_array(alloc, ncapacity, sizeof(*nbuckets));
     if (!nbuckets)
         return -BFDEV_ENOMEM;
 
-    bfdev_hashtbl_init(nbuckets, ncapacity);
+    if (bfdev_hashmap_incremental_test(hashmap) && hashmap->buckets) {
+        /* Leave the nodes in place, they move over on later operations */
+        hashmap->obuckets = hashmap->buckets;
+        hashmap->ocapacity = hashmap->capacity;
+        hashmap->migrate = 0;
+
+        /*
+         * Finish before the next threshold: a shrink leaves a quarter
+         * of the new capacity either way, but the old table is twice
+         * as large, so it moves twice as fast.
+         */
+        hashmap->mstep = BFDEV_HASHMAP_MIGRATE_STEP;
+        if (nbits < hashmap->bits)
+            hashmap->mstep *= 2;
+        goto finish;
+    }
+
     bfdev_hashmap_for_each_safe(walk, tmp, hashmap, index) {
-        value = hashmap_hash_node(hashmap, walk);
+        value = hashmap_hash_stored(hashmap, walk);
         bfdev_hlist_del(walk);
         bfdev_hashtbl_add(nbuckets, ncapacity, walk, value);
     }
 
     bfdev_free(alloc, hashmap->buckets);
+
+finish:
     hashmap->bits = nbits;
     hashmap->capacity = ncapacity;
     hashmap->buckets = nbuckets;
@@ -177,6 +274,9 @@ hashmap_shrink(bfdev_hashmap_t *hashmap)
     if (nbits < BFDEV_HASHMAP_MIN_BITS)
         nbits = BFDEV_HASHMAP_MIN_BITS;
 
+    if (nbits == hashmap->bits)
+        return -BFDEV_ENOERR;
+
     return hashmap_rehash(hashmap, nbits);
 }
 
@@ -189,6 +289,9 @@ bfdev_hashmap_insert(bfdev_hashmap_t *hashmap, bfdev_hlist_node_t *node,
     int retval;
 
     value = hashmap_hash_node(hashmap, node);
+    if (bfdev_hashmap_cached_test(hashmap))
+        bfdev_hashmap_node_entry(node)->hash = value;
+
     if (strategy != BFDEV_HASHMAP_APPEND &&
         (exist = hashmap_find_node(hashmap, node, value))) {
         if (old)
@@ -205,13 +308,14 @@ bfdev_hashmap_insert(bfdev_hashmap_t *hashmap, bfdev_hlist_node_t *node,
     if (strategy == BFDEV_HASHMAP_UPDATE)
         return -BFDEV_ENOENT;
 
-    if (hashmap_need_extend(hashmap)) {
+    /* Only one migration can be in flight, the next one waits */
+    if (!hashmap->obuckets && hashmap_need_extend(hashmap)) {
         retval = hashmap_extend(hashmap);
         if (retval)
             return retval;
-        value = hashmap_hash_node(hashmap, node);
     }
 
+    hashmap_migrate(hashmap, hashmap->mstep);
     bfdev_hashtbl_add(hashmap->buckets, hashmap->capacity, node, value);
     hashmap->used++;
 
@@ -232,8 +336,9 @@ bfdev_hashmap_del(bfdev_hashmap_t *hashmap, const void *key,
     bfdev_hashtbl_del(exist);
     hashmap->used--;
 
-    if (hashmap_need_shrink(hashmap))
+    if (!hashmap->obuckets && hashmap_need_shrink(hashmap))
         hashmap_shrink(hashmap);
+    hashmap_migrate(hashmap, hashmap->mstep);
 
     if (node)
         *node = exist;
@@ -249,10 +354,60 @@ bfdev_hashmap_find(bfdev_hashmap_t *hashmap, const void *key)
 
     value = hashmap_hash_key(hashmap, key);
     exist = hashmap_find_key(hashmap, key, value);
+    hashmap_migrate(hashmap, hashmap->mstep);
 
     return exist;
 }
 
+export unsigned int
+bfdev_hashmap_find_batch(bfdev_hashmap_t *hashmap, const void *const *keys,
+                         bfdev_hlist_node_t **nodes, unsigned int count)
+{
+    unsigned long hash[BFDEV_HASHMAP_BATCH];
+    unsigned long index[BFDEV_HASHMAP_BATCH];
+    unsigned int batch, offset, found;
+
+    if (!hashmap->buckets) {
+        bfport_memset(nodes, 0, sizeof(*nodes) * count);
+        return 0;
+    }
+
+    for (found = 0; count; count -= batch) {
+        batch = bfdev_min(count, BFDEV_HASHMAP_BATCH);
+
+        /* Stage 1: hash everything and pull in the buckets */
+        for (offset = 0; offset < batch; ++offset) {
+            hash[offset] = hashmap_hash_key(hashmap, keys[offset]);
+            index[offset] = bfdev_hashtbl_prefetch(hashmap->buckets,
+                hashmap->capacity, hash[offset]);
+        }
+
+        /* Stage 2: buckets are in flight, pull in the chain heads */
+        for (offset = 0; offset < batch; ++offset)
+            bfdev_hashtbl_prefetch_idx(hashmap->buckets, index[offset]);
+
+        /* Stage 3: walk the chains */
+        for (offset = 0; offset < batch; ++offset) {
+            nodes[offset] = hashmap_find_key(hashmap, keys[offset], hash[offset]);
+            if (nodes[offset])
+                found++;
+        }
+
+        keys += batch;
+        nodes += batch;
+    }
+
+    hashmap_migrate(hashmap, hashmap->mstep);
+
+    return found;
+}
+
+export void
+bfdev_hashmap_migrate(bfdev_hashmap_t *hashmap)
+{
+    hashmap_migrate(hashmap, BFDEV_ULONG_MAX);
+}
+
 export void
 bfdev_hashmap_release(bfdev_hashmap_t *hashmap)
 {
@@ -260,7 +415,11 @@ bfdev_hashmap_release(bfdev_hashmap_t *hashmap)
 
     alloc = hashmap->alloc;
     bfdev_free(alloc, hashmap->buckets);
+    bfdev_free(alloc, hashmap->obuckets);
     hashmap->buckets = NULL;
+    hashmap->obuckets = NULL;
+    hashmap->ocapacity = 0;
+    hashmap->migrate = 0;
 
     hashmap->used = 0;
     hashmap->capacity = 0;
@@ -0,0 +1,207 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/hugealloc.h>
+#include <bfdev/atomic.h>
+#include <bfdev/minmax.h>
+#include <bfdev/mman.h>
+#include <export.h>
+
+/*
+ * Every block starts with a two word header: the mapping length, or
+ * zero for blocks of the wrapped allocator, then the requested size.
+ */
+
+static void *
+hugealloc_map_hugetlb(size_t length)
+{
+#ifdef MAP_HUGETLB
+    void *map;
+
+    map = bfport_mmap(NULL, length, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (map != MAP_FAILED)
+        return map;
+#endif
+
+    return NULL;
+}
+
+static void *
+hugealloc_map_aligned(size_t length, bool advise)
+{
+    void *map, *start;
+    size_t head, tail;
+
+    /* Over-map, then trim to a huge page boundary */
+    map = bfport_mmap(NULL, length + BFDEV_HUGEALLOC_PAGE,
+                      PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                      -1, 0);
+    if (map == MAP_FAILED)
+        return NULL;
+
+    start = bfdev_align_ptr_high(map, BFDEV_HUGEALLOC_PAGE);
+    head = start - map;
+    tail = BFDEV_HUGEALLOC_PAGE - head;
+
+    if (head)
+        bfport_munmap(map, head);
+    if (tail)
+        bfport_munmap(start + length, tail);
+
+#ifdef MADV_HUGEPAGE
+    if (advise)
+        bfport_madvise(start, length, MADV_HUGEPAGE);
+#endif
+
+    return start;
+}
+
+static void *
+hugealloc_map(bfdev_hugealloc_t *huge, size_t size)
+{
+    size_t length, *block;
+
+    length = bfdev_align_high(size + BFDEV_HUGEALLOC_HEADER,
+                              BFDEV_HUGEALLOC_PAGE);
+
+    block = NULL;
+    if (huge->flags & BFDEV_HUGEALLOC_HUGETLB) {
+        block = hugealloc_map_hugetlb(length);
+        if (block)
+            bfdev_atomic_add(&huge->hugetlb, 1);
+    }
+
+    if (!block) {
+        block = hugealloc_map_aligned(length,
+                                      huge->flags & BFDEV_HUGEALLOC_THP);
+        if (bfdev_unlikely(!block))
+            return NULL;
+        bfdev_atomic_add(&huge->mapped, 1);
+    }
+
+    block[0] = length;
+    block[1] = size;
+
+    return (void *)block + BFDEV_HUGEALLOC_HEADER;
+}
+
+static void *
+hugealloc_small(bfdev_hugealloc_t *huge, size_t size, bool zero)
+{
+    size_t *block;
+
+    if (zero)
+        block = bfdev_zalloc(huge->alloc, size + BFDEV_HUGEALLOC_HEADER);
+    else
+        block = bfdev_malloc(huge->alloc, size + BFDEV_HUGEALLOC_HEADER);
+
+    if (bfdev_unlikely(!block))
+        return NULL;
+
+    block[0] = 0;
+    block[1] = size;
+
+    return (void *)block + BFDEV_HUGEALLOC_HEADER;
+}
+
+static void *
+hugealloc_alloc(size_t size, void *pdata)
+{
+    bfdev_hugealloc_t *huge;
+
+    huge = pdata;
+    if (size >= huge->threshold)
+        return hugealloc_map(huge, size);
+
+    return hugealloc_small(huge, size, false);
+}
+
+static void *
+hugealloc_zalloc(size_t size, void *pdata)
+{
+    bfdev_hugealloc_t *huge;
+
+    /* Anonymous mappings come zeroed */
+    huge = pdata;
+    if (size >= huge->threshold)
+        return hugealloc_map(huge, size);
+
+    return hugealloc_small(huge, size, true);
+}
+
+static void
+hugealloc_free(void *block, void *pdata)
+{
+    bfdev_hugealloc_t *huge;
+    size_t *base;
+
+    huge = pdata;
+    base = block - BFDEV_HUGEALLOC_HEADER;
+
+    if (base[0])
+        bfport_munmap(base, base[0]);
+    else
+        bfdev_free(huge->alloc, base);
+}
+
+static void *
+hugealloc_realloc(void *block, size_t resize, void *pdata)
+{
+    bfdev_hugealloc_t *huge;
+    size_t *base;
+    void *retval;
+
+    huge = pdata;
+    base = block - BFDEV_HUGEALLOC_HEADER;
+
+    if (!base[0] && resize < huge->threshold) {
+        base = bfdev_realloc(huge->alloc, base,
+                             resize + BFDEV_HUGEALLOC_HEADER);
+        if (bfdev_unlikely(!base))
+            return NULL;
+
+        base[1] = resize;
+        return (void *)base + BFDEV_HUGEALLOC_HEADER;
+    }
+
+    /* Still fits the mapping */
+    if (base[0] && resize + BFDEV_HUGEALLOC_HEADER <= base[0]) {
+        base[1] = resize;
+        return block;
+    }
+
+    retval = hugealloc_alloc(resize, pdata);
+    if (bfdev_unlikely(!retval))
+        return NULL;
+
+    bfport_memcpy(retval, block, bfdev_min(base[1], resize));
+    hugealloc_free(block, pdata);
+
+    return retval;
+}
+
+export int
+bfdev_hugealloc_init(bfdev_hugealloc_t *huge, const bfdev_alloc_t *alloc,
+                     size_t threshold, unsigned long flags)
+{
+    /* No page size means the platform cannot map memory */
+    if (!bfport_pagesize())
+        return -BFDEV_EOPNOTSUPP;
+
+    huge->alloc = alloc;
+    huge->threshold = threshold ?: BFDEV_HUGEALLOC_THRESHOLD;
+    huge->flags = flags;
+
+    bfdev_atomic_write(&huge->hugetlb, 0);
+    bfdev_atomic_write(&huge->mapped, 0);
+
+    bfdev_alloc_ops_init(&huge->ops, hugealloc_alloc, hugealloc_zalloc,
+                         hugealloc_realloc, hugealloc_free);
+    bfdev_alloc_init(&huge->allocator, &huge->ops, huge);
+
+    return -BFDEV_ENOERR;
+}
@@ -8,6 +8,7 @@
 
 #include <base.h>
 #include <bfdev/bits.h>
+#include <bfdev/bitops.h>
 #include <bfdev/log.h>
 #include <bfdev/memalloc.h>
 #include <export.h>
@@ -62,6 +63,69 @@ memalloc_check(void *block)
     return node;
 }
 
+static __bfdev_always_inline void
+tlsf_mapping(size_t size, unsigned int *fl, unsigned int *sl)
+{
+    unsigned int msb;
+
+    if (size < BFDEV_MEMALLOC_TLSF_SLN) {
+        *fl = 0;
+        *sl = size;
+        return;
+    }
+
+    /* Each power of two is split into SLN linear classes */
+    msb = bfdev_flsuf(size);
+    *fl = msb - BFDEV_MEMALLOC_TLSF_SLI + 1;
+    *sl = (size >> (msb - BFDEV_MEMALLOC_TLSF_SLI)) ^ BFDEV_MEMALLOC_TLSF_SLN;
+}
+
+static void
+tlsf_insert(bfdev_memalloc_tlsf_t *tlsf, bfdev_memalloc_chunk_t *node)
+{
+    unsigned int fl, sl;
+
+    tlsf_mapping(pnode_get_size(node), &fl, &sl);
+    bfdev_list_add(&tlsf->bins[fl][sl], &node->free);
+
+    tlsf->sl_bitmap[fl] |= BFDEV_BIT(sl);
+    tlsf->fl_bitmap |= BFDEV_BIT(fl);
+}
+
+static void
+tlsf_remove(bfdev_memalloc_tlsf_t *tlsf, bfdev_memalloc_chunk_t *node)
+{
+    unsigned int fl, sl;
+
+    tlsf_mapping(pnode_get_size(node), &fl, &sl);
+    bfdev_list_del_init(&node->free);
+
+    if (!bfdev_list_check_empty(&tlsf->bins[fl][sl]))
+        return;
+
+    tlsf->sl_bitmap[fl] &= ~BFDEV_BIT(sl);
+    if (!tlsf->sl_bitmap[fl])
+        tlsf->fl_bitmap &= ~BFDEV_BIT(fl);
+}
+
+static void
+memalloc_insert(bfdev_memalloc_head_t *head, bfdev_memalloc_chunk_t *node)
+{
+    if (head->tlsf)
+        tlsf_insert(bfdev_container_of(head, bfdev_memalloc_tlsf_t, head), node);
+    else
+        bfdev_list_add(&head->free_list, &node->free);
+}
+
+static void
+memalloc_remove(bfdev_memalloc_head_t *head, bfdev_memalloc_chunk_t *node)
+{
+    if (head->tlsf)
+        tlsf_remove(bfdev_container_of(head, bfdev_memalloc_tlsf_t, head), node);
+    else
+        bfdev_list_del_init(&node->free);
+}
+
 export bfdev_memalloc_chunk_t *
 bfdev_memalloc_first_fit(bfdev_memalloc_head_t *head, size_t size)
 {
@@ -123,6 +187,39 @@ bfdev_memalloc_worst_fit(bfdev_memalloc_head_t *head, size_t size)
     return worst;
 }
 
+export bfdev_memalloc_chunk_t *
+bfdev_memalloc_tlsf(bfdev_memalloc_head_t *head, size_t size)
+{
+    bfdev_memalloc_tlsf_t *tlsf;
+    unsigned long bitmap;
+    unsigned int fl, sl;
+
+    if (bfdev_unlikely(!head->tlsf))
+        return NULL;
+
+    tlsf = bfdev_container_of(head, bfdev_memalloc_tlsf_t, head);
+
+    /* Round up so that any chunk of the class fits */
+    if (size >= BFDEV_MEMALLOC_TLSF_SLN)
+        size += BFDEV_BIT(bfdev_flsuf(size) - BFDEV_MEMALLOC_TLSF_SLI) - 1;
+    tlsf_mapping(size, &fl, &sl);
+
+    bitmap = tlsf->sl_bitmap[fl] & (~0UL << sl);
+    if (!bitmap) {
+        bitmap = tlsf->fl_bitmap & (~0UL << (fl + 1));
+        if (!bitmap)
+            return NULL;
+
+        fl = bfdev_ffsuf(bitmap);
+        bitmap = tlsf->sl_bitmap[fl];
+    }
+
+    sl = bfdev_ffsuf(bitmap);
+
+    return bfdev_list_first_entry(&tlsf->bins[fl][sl],
+                                  bfdev_memalloc_chunk_t, free);
+}
+
 export void *
 bfdev_memalloc_alloc(bfdev_memalloc_head_t *head, size_t size)
 {
@@ -139,6 +236,7 @@ bfdev_memalloc_alloc(bfdev_memalloc_head_t *head, size_t size)
         return NULL;
 
     /* Adjust available size */
+    memalloc_remove(head, node);
     nsize = pnode_get_size(node);
     head->avail -= nsize;
 
@@ -154,13 +252,12 @@ bfdev_memalloc_alloc(bfdev_memalloc_head_t *head, size_t size)
     head->avail += fsize;
 
     bfdev_list_add(&node->block, &free->block);
-    bfdev_list_add(&head->free_list, &free->free);
+    memalloc_insert(head, free);
     pnode_set_size(node, size);
 
 finish:
     /* Set node used */
     pnode_set_used(node, true);
-    bfdev_list_del_init(&node->free);
     return node->data;
 }
 
@@ -204,7 +301,7 @@ bfdev_memalloc_realloc(bfdev_memalloc_head_t *head, void *block, size_t resize)
     nsize = pnode_get_size(expand);
     head->avail -= nsize;
 
-    bfdev_list_del(&expand->free);
+    memalloc_remove(head, expand);
     bfdev_list_del(&expand->block);
 
     /* Use all space of the next node */
@@ -223,7 +320,7 @@ bfdev_memalloc_realloc(bfdev_memalloc_head_t *head, void *block, size_t resize)
     head->avail += fsize;
 
     bfdev_list_add(&node->block, &free->block);
-    bfdev_list_add(&head->free_list, &free->free);
+    memalloc_insert(head, free);
 
 finish:
     pnode_set_size(node, resize);
@@ -242,7 +339,6 @@ bfdev_memalloc_free(bfdev_memalloc_head_t *head, void *block)
 
     /* Set node freed */
     pnode_set_used(node, false);
-    bfdev_list_add(&head->free_list, &node->free);
 
     /* Adjust available size */
     nsize = pnode_get_size(node);
@@ -251,7 +347,7 @@ bfdev_memalloc_free(bfdev_memalloc_head_t *head, void *block)
     /* Merge next node */
     side = bfdev_list_next_entry_or_null(node, &head->block_list, block);
     if (side && !pnode_get_used(side)) {
-        bfdev_list_del(&side->free);
+        memalloc_remove(head, side);
         bfdev_list_del(&side->block);
 
         /* node size = this node + next node + next size */
@@ -263,19 +359,23 @@ bfdev_memalloc_free(bfdev_memalloc_head_t *head, void *block)
     /* Merge prev node */
     side = bfdev_list_prev_entry_or_null(node, &head->block_list, block);
     if (side && !pnode_get_used(side)) {
-        bfdev_list_del(&node->free);
+        memalloc_remove(head, side);
         bfdev_list_del(&node->block);
 
         /* prev size = prev size + this node + this size */
         fsize = sizeof(*node) + pnode_get_size(node);
         pnode_set_size(side, pnode_get_size(side) + fsize);
         head->avail += sizeof(*node);
+        node = side;
     }
+
+    /* Sizes are settled, file it by its final size */
+    memalloc_insert(head, node);
 }
 
-export void
-bfdev_memalloc_init(bfdev_memalloc_head_t *head, bfdev_memalloc_find_t find,
-                    void *array, size_t size)
+static void
+memalloc_setup(bfdev_memalloc_head_t *head, bfdev_memalloc_find_t find,
+               void *array, size_t size)
 {
     bfdev_memalloc_chunk_t *node;
 
@@ -288,5 +388,30 @@ bfdev_memalloc_init(bfdev_memalloc_head_t *head, bfdev_memalloc_find_t find,
     head->avail = size - sizeof(*node);
 
     bfdev_list_add(&head->block_list, &node->block);
-    bfdev_list_add(&head->free_list, &node->free);
+    memalloc_insert(head, node);
+}
+
+export void
+bfdev_memalloc_init(bfdev_memalloc_head_t *head, bfdev_memalloc_find_t find,
+                    void *array, size_t size)
+{
+    head->tlsf = false;
+    memalloc_setup(head, find, array, size);
+}
+
+export void
+bfdev_memalloc_tlsf_init(bfdev_memalloc_tlsf_t *tlsf, void *memory, size_t size)
+{
+    unsigned int fl, sl;
+
+    tlsf->fl_bitmap = 0;
+    for (fl = 0; fl < BFDEV_MEMALLOC_TLSF_FLN; ++fl) {
+        tlsf->sl_bitmap[fl] = 0;
+        for (sl = 0; sl < BFDEV_MEMALLOC_TLSF_SLN; ++sl)
+            bfdev_list_head_init(&tlsf->bins[fl][sl]);
+    }
+
+    /* Only this path may file chunks into the bins */
+    tlsf->head.tlsf = true;
+    memalloc_setup(&tlsf->head, bfdev_memalloc_tlsf, memory, size);
 }
@@ -0,0 +1,108 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/mirror.h>
+#include <bfdev/atomic.h>
+#include <bfdev/mman.h>
+#include <bfdev/stdio.h>
+#include <export.h>
+
+#ifndef bfport_memfd_create
+static bfdev_atomic_t
+mirror_serial;
+#endif
+
+static int
+mirror_file(size_t size)
+{
+    int fd;
+
+#ifdef bfport_memfd_create
+    fd = bfport_memfd_create("bfdev-mirror", MFD_CLOEXEC);
+#else
+    char name[48];
+    long serial;
+
+    /* Concurrent maps of one process need distinct names */
+    serial = bfdev_atomic_add_fetch(&mirror_serial, 1);
+    bfport_snprintf(name, sizeof(name), "/bfdev-mirror-%ld-%ld",
+                    bfport_getpid(), serial);
+
+    /* The name only lives until the object is unlinked */
+    fd = bfport_shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0)
+        bfport_shm_unlink(name);
+#endif
+
+    if (fd < 0)
+        return fd;
+
+    if (bfport_ftruncate(fd, size)) {
+        bfport_close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+export size_t
+bfdev_mirror_granule(void)
+{
+    return bfport_pagesize();
+}
+
+export int
+bfdev_mirror_map(void **datap, size_t size)
+{
+    void *base, *map;
+    size_t granule;
+    int fd;
+
+    granule = bfdev_mirror_granule();
+    if (!granule)
+        return -BFDEV_EOPNOTSUPP;
+
+    if (!size || size % granule)
+        return -BFDEV_EINVAL;
+
+    fd = mirror_file(size);
+    if (fd < 0)
+        return -BFDEV_ENOMEM;
+
+    /* Reserve both halves first, then replace them with the file */
+    base = bfport_mmap(NULL, size * 2, PROT_NONE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED)
+        goto failed;
+
+    map = bfport_mmap(base, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_FIXED, fd, 0);
+    if (map != base)
+        goto failed_unmap;
+
+    map = bfport_mmap(base + size, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_FIXED, fd, 0);
+    if (map != base + size)
+        goto failed_unmap;
+
+    /* The mappings keep the memory alive */
+    bfport_close(fd);
+    *datap = base;
+
+    return -BFDEV_ENOERR;
+
+failed_unmap:
+    bfport_munmap(base, size * 2);
+failed:
+    bfport_close(fd);
+    return -BFDEV_ENOMEM;
+}
+
+export void
+bfdev_mirror_unmap(void *data, size_t size)
+{
+    bfport_munmap(data, size * 2);
+}
@@ -7,6 +7,9 @@
 #include <bfdev/log2.h>
 #include <bfdev/ringbuf.h>
 #include <bfdev/bits.h>
+#include <bfdev/span.h>
+#include <bfdev/mirror.h>
+#include <bfdev/minmax.h>
 #include <export.h>
 
 #define RINGBUF_GENERIC_COPY(copy1, copy2, fold1, fold2) do {   \
@@ -22,7 +25,10 @@
         len *= esize;                                           \
     }                                                           \
                                                                 \
-    llen = bfdev_min(len, size - offset);                       \
+    if (ringbuf->mirror)                                        \
+        llen = len;                                             \
+    else                                                        \
+        llen = bfdev_min(len, size - offset);                   \
     bfport_memcpy(copy1, copy2, llen);                          \
     bfport_memcpy(fold1, fold2, len - llen);                    \
 } while (0)
@@ -47,10 +53,38 @@ ringbuf_in_copy(bfdev_ringbuf_t *ringbuf, const void *buff,
     );
 }
 
+static __bfdev_always_inline void
+ringbuf_span(bfdev_ringbuf_t *ringbuf, bfdev_span_t *span, unsigned long len,
+             unsigned long offset)
+{
+    unsigned long size, esize, llen;
+
+    size = ringbuf->mask + 1;
+    esize = ringbuf->esize;
+    offset &= ringbuf->mask;
+
+    if (esize != 1) {
+        offset *= esize;
+        size *= esize;
+        len *= esize;
+    }
+
+    /* A mirrored buffer continues past its end */
+    if (ringbuf->mirror)
+        llen = len;
+    else
+        llen = bfdev_min(len, size - offset);
+
+    span[0].base = ringbuf->data + offset;
+    span[0].len = llen;
+    span[1].base = ringbuf->data;
+    span[1].len = len - llen;
+}
+
 static __bfdev_always_inline unsigned long
 ringbuf_record_peek(bfdev_ringbuf_t *ringbuf, unsigned long recsize)
 {
-    unsigned long mask, offset, length;
+    unsigned long mask, offset, length, shift;
     uint8_t *data;
 
     mask = ringbuf->mask;
@@ -64,9 +98,9 @@ ringbuf_record_peek(bfdev_ringbuf_t *ringbuf, unsigned long recsize)
         mask += ringbuf->esize - 1;
     }
 
-    while (recsize--) {
-        length <<= BFDEV_BITS_PER_U8;
-        length |= data[offset & mask];
+    /* Little endian, the same order record_poke stores */
+    for (shift = 0; recsize--; shift += BFDEV_BITS_PER_U8) {
+        length |= (unsigned long)data[offset & mask] << shift;
         offset += ringbuf->esize;
     }
 
@@ -74,13 +108,13 @@ ringbuf_record_peek(bfdev_ringbuf_t *ringbuf, unsigned long recsize)
 }
 
 static __bfdev_always_inline void
-ringbuf_record_poke(bfdev_ringbuf_t *ringbuf, unsigned long len, unsigned long recsize)
+ringbuf_record_poke(bfdev_ringbuf_t *ringbuf, unsigned long len, unsigned long recsize,
+                    unsigned long offset)
 {
-    unsigned long mask, offset;
+    unsigned long mask;
     uint8_t *data;
 
     mask = ringbuf->mask;
-    offset = ringbuf->out;
     data = ringbuf->data;
 
     if (ringbuf->esize != 1) {
@@ -163,6 +197,60 @@ bfdev_ringbuf_in_flat(bfdev_ringbuf_t *ringbuf, const void *buff, unsigned long
     return len;
 }
 
+export unsigned long
+bfdev_ringbuf_reserve_flat(bfdev_ringbuf_t *ringbuf, bfdev_span_t *span,
+                           unsigned long len)
+{
+    unsigned long size;
+
+    size = ringbuf->mask + 1;
+    bfdev_min_adj(len, size);
+    ringbuf_span(ringbuf, span, len, ringbuf->in);
+
+    return len;
+}
+
+export unsigned long
+bfdev_ringbuf_commit_flat(bfdev_ringbuf_t *ringbuf, unsigned long len)
+{
+    unsigned long size, overflow;
+
+    size = ringbuf->mask + 1;
+    bfdev_min_adj(len, size);
+    ringbuf->in += len;
+
+    overflow = ringbuf_overflow(ringbuf);
+    if (overflow)
+        ringbuf->out += overflow;
+
+    return len;
+}
+
+export unsigned long
+bfdev_ringbuf_peek_span_flat(bfdev_ringbuf_t *ringbuf, bfdev_span_t *span,
+                             unsigned long len)
+{
+    unsigned long valid;
+
+    valid = ringbuf_valid(ringbuf);
+    bfdev_min_adj(len, valid);
+    ringbuf_span(ringbuf, span, len, ringbuf->out);
+
+    return len;
+}
+
+export unsigned long
+bfdev_ringbuf_consume_flat(bfdev_ringbuf_t *ringbuf, unsigned long len)
+{
+    unsigned long valid;
+
+    valid = ringbuf_valid(ringbuf);
+    bfdev_min_adj(len, valid);
+    ringbuf->out += len;
+
+    return len;
+}
+
 export unsigned long
 bfdev_ringbuf_peek_record(bfdev_ringbuf_t *ringbuf, void *buff, unsigned long len,
                           unsigned long record)
@@ -216,12 +304,44 @@ bfdev_ringbuf_in_record(bfdev_ringbuf_t *ringbuf, const void *buff, unsigned lon
         overflow -= bfdev_min(datalen, overflow);
     }
 
-    ringbuf_record_poke(ringbuf, len, record);
+    ringbuf_record_poke(ringbuf, len, record, offset - record);
     ringbuf_in_copy(ringbuf, buff, len, offset);
 
     return len;
 }
 
+export unsigned long
+bfdev_ringbuf_peek_span_record(bfdev_ringbuf_t *ringbuf, bfdev_span_t *span,
+                               unsigned long len, unsigned long record)
+{
+    unsigned long datalen;
+
+    if (ringbuf_empty(ringbuf)) {
+        ringbuf_span(ringbuf, span, 0, ringbuf->out);
+        return 0;
+    }
+
+    datalen = ringbuf_record_peek(ringbuf, record);
+    bfdev_min_adj(len, datalen);
+    ringbuf_span(ringbuf, span, len, ringbuf->out + record);
+
+    return len;
+}
+
+export unsigned long
+bfdev_ringbuf_consume_record(bfdev_ringbuf_t *ringbuf, unsigned long record)
+{
+    unsigned long datalen;
+
+    if (ringbuf_empty(ringbuf))
+        return 0;
+
+    datalen = ringbuf_record_peek(ringbuf, record);
+    ringbuf->out += datalen + record;
+
+    return datalen;
+}
+
 export int
 bfdev_ringbuf_dynamic_alloc(bfdev_ringbuf_t *ringbuf, const bfdev_alloc_t *alloc,
                             size_t esize, size_t size)
@@ -239,6 +359,39 @@ bfdev_ringbuf_dynamic_alloc(bfdev_ringbuf_t *ringbuf, const bfdev_alloc_t *alloc
     ringbuf->mask = size - 1;
     ringbuf->esize = esize;
     ringbuf->alloc = alloc;
+    ringbuf->mirror = false;
+
+    return -BFDEV_ENOERR;
+}
+
+export int
+bfdev_ringbuf_mirror_alloc(bfdev_ringbuf_t *ringbuf, size_t esize, size_t size)
+{
+    size_t granule;
+    int retval;
+
+    granule = bfdev_mirror_granule();
+    if (!granule)
+        return -BFDEV_EOPNOTSUPP;
+
+    /* Power of two elements keep the buffer whole pages */
+    if (!esize || (esize & (esize - 1)))
+        return -BFDEV_EINVAL;
+
+    size = bfdev_pow2_roundup(bfdev_max(size, granule / esize));
+    if (size < 2)
+        return -BFDEV_EINVAL;
+
+    retval = bfdev_mirror_map(&ringbuf->data, size * esize);
+    if (retval)
+        return retval;
+
+    ringbuf->in = 0;
+    ringbuf->out = 0;
+    ringbuf->mask = size - 1;
+    ringbuf->esize = esize;
+    ringbuf->alloc = NULL;
+    ringbuf->mirror = true;
 
     return -BFDEV_ENOERR;
 }
@@ -247,13 +400,23 @@ export void
 bfdev_ringbuf_dynamic_free(bfdev_ringbuf_t *ringbuf)
 {
     const bfdev_alloc_t *alloc;
+    unsigned long size, esize;
+
+    size = ringbuf->mask + 1;
+    esize = ringbuf->esize;
 
     ringbuf->in = 0;
     ringbuf->out = 0;
     ringbuf->mask = 0;
     ringbuf->esize = 0;
 
-    alloc = ringbuf->alloc;
-    bfdev_free(alloc, ringbuf->data);
+    if (ringbuf->mirror)
+        bfdev_mirror_unmap(ringbuf->data, size * esize);
+    else {
+        alloc = ringbuf->alloc;
+        bfdev_free(alloc, ringbuf->data);
+    }
+
     ringbuf->data = NULL;
+    ringbuf->mirror = false;
 }
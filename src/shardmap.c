@@ -0,0 +1,271 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/shardmap.h>
+#include <bfdev/poison.h>
+#include <bfdev/align.h>
+#include <export.h>
+
+/*
+ * Writers of a bucket are serialized by its stripe lock, readers walk
+ * the chain without any lock. Every pointer a reader may follow is
+ * published with release semantics, and unlinked nodes keep their
+ * next pointer so that a reader standing on them can carry on.
+ */
+
+static __bfdev_always_inline void
+shardmap_add_rcu(bfdev_hlist_head_t *head, bfdev_hlist_node_t *node)
+{
+    bfdev_hlist_node_t *first;
+
+    first = head->node;
+    node->next = first;
+    node->pprev = &head->node;
+
+    if (first)
+        first->pprev = &node->next;
+    bfdev_store_release(&head->node, node);
+}
+
+static __bfdev_always_inline void
+shardmap_del_rcu(bfdev_hlist_node_t *node)
+{
+    bfdev_hlist_node_t *next, **pprev;
+
+    next = node->next;
+    pprev = node->pprev;
+
+    if (next)
+        next->pprev = pprev;
+    bfdev_store_release(pprev, next);
+    node->pprev = BFDEV_POISON_HLIST2;
+}
+
+static __bfdev_always_inline void
+shardmap_replace_rcu(bfdev_hlist_node_t *old, bfdev_hlist_node_t *newn)
+{
+    bfdev_hlist_node_t *next;
+
+    next = old->next;
+    newn->next = next;
+    newn->pprev = old->pprev;
+
+    if (next)
+        next->pprev = &newn->next;
+    bfdev_store_release(old->pprev, newn);
+    old->pprev = BFDEV_POISON_HLIST2;
+}
+
+static __bfdev_always_inline unsigned long
+shardmap_index(bfdev_shardmap_t *shardmap, unsigned long value)
+{
+    return bfdev_hashtbl_index(shardmap->capacity, value);
+}
+
+static __bfdev_always_inline bfdev_shardmap_stripe_t *
+shardmap_stripe(bfdev_shardmap_t *shardmap, unsigned long index)
+{
+    return &shardmap->stripes[index & (shardmap->nstripes - 1)];
+}
+
+static bfdev_hlist_node_t *
+shardmap_find_node(bfdev_shardmap_t *shardmap, bfdev_hlist_head_t *head,
+                   const bfdev_hlist_node_t *node)
+{
+    const bfdev_hashmap_ops_t *ops;
+    bfdev_hlist_node_t *walk;
+
+    ops = shardmap->ops;
+    bfdev_hlist_for_each(walk, head) {
+        if (!ops->equal(walk, node, shardmap->pdata))
+            return walk;
+    }
+
+    return NULL;
+}
+
+static bfdev_hlist_node_t *
+shardmap_find_key(bfdev_shardmap_t *shardmap, bfdev_hlist_head_t *head,
+                  const void *key)
+{
+    const bfdev_hashmap_ops_t *ops;
+    bfdev_hlist_node_t *walk;
+
+    ops = shardmap->ops;
+    bfdev_hlist_for_each(walk, head) {
+        if (!ops->find(walk, key, shardmap->pdata))
+            return walk;
+    }
+
+    return NULL;
+}
+
+export int
+bfdev_shardmap_insert(bfdev_shardmap_t *shardmap, bfdev_hlist_node_t *node,
+                      bfdev_hlist_node_t **old, bfdev_hashmap_strategy_t strategy)
+{
+    bfdev_shardmap_stripe_t *stripe;
+    bfdev_hlist_node_t *exist;
+    bfdev_hlist_head_t *head;
+    unsigned long index;
+    int retval;
+
+    index = shardmap_index(shardmap, shardmap->ops->hash_node(node, shardmap->pdata));
+    stripe = shardmap_stripe(shardmap, index);
+    head = &shardmap->buckets[index];
+
+    bfdev_spin_lock(&stripe->lock);
+    if (strategy != BFDEV_HASHMAP_APPEND &&
+        (exist = shardmap_find_node(shardmap, head, node))) {
+        if (old)
+            *old = exist;
+
+        if (strategy == BFDEV_HASHMAP_ADD) {
+            retval = -BFDEV_EEXIST;
+            goto finish;
+        }
+
+        /* BFDEV_HASHMAP_{SET / UPDATE} */
+        shardmap_replace_rcu(exist, node);
+        retval = -BFDEV_ENOERR;
+        goto finish;
+    }
+
+    if (strategy == BFDEV_HASHMAP_UPDATE) {
+        retval = -BFDEV_ENOENT;
+        goto finish;
+    }
+
+    shardmap_add_rcu(head, node);
+    stripe->used++;
+    retval = -BFDEV_ENOERR;
+
+finish:
+    bfdev_spin_unlock(&stripe->lock);
+    return retval;
+}
+
+export int
+bfdev_shardmap_del(bfdev_shardmap_t *shardmap, const void *key,
+                   bfdev_hlist_node_t **node)
+{
+    bfdev_shardmap_stripe_t *stripe;
+    bfdev_hlist_node_t *exist;
+    bfdev_hlist_head_t *head;
+    unsigned long index;
+
+    index = shardmap_index(shardmap, shardmap->ops->hash_key(key, shardmap->pdata));
+    stripe = shardmap_stripe(shardmap, index);
+    head = &shardmap->buckets[index];
+
+    bfdev_spin_lock(&stripe->lock);
+    exist = shardmap_find_key(shardmap, head, key);
+    if (exist) {
+        shardmap_del_rcu(exist);
+        stripe->used--;
+    }
+    bfdev_spin_unlock(&stripe->lock);
+
+    if (!exist)
+        return -BFDEV_ENOENT;
+
+    if (node)
+        *node = exist;
+
+    return -BFDEV_ENOERR;
+}
+
+export bfdev_hlist_node_t *
+bfdev_shardmap_find(bfdev_shardmap_t *shardmap, const void *key)
+{
+    const bfdev_hashmap_ops_t *ops;
+    bfdev_hlist_node_t *walk;
+    bfdev_hlist_head_t *head;
+    unsigned long index;
+
+    ops = shardmap->ops;
+    index = shardmap_index(shardmap, ops->hash_key(key, shardmap->pdata));
+    head = &shardmap->buckets[index];
+
+    for (walk = bfdev_load_acquire(&head->node); walk;
+         walk = bfdev_load_acquire(&walk->next)) {
+        if (!ops->find(walk, key, shardmap->pdata))
+            return walk;
+    }
+
+    return NULL;
+}
+
+export unsigned long
+bfdev_shardmap_used(bfdev_shardmap_t *shardmap)
+{
+    unsigned long count, used;
+
+    used = 0;
+    for (count = 0; count < shardmap->nstripes; ++count)
+        used += BFDEV_READ_ONCE(shardmap->stripes[count].used);
+
+    return used;
+}
+
+export int
+bfdev_shardmap_init(bfdev_shardmap_t *shardmap, const bfdev_alloc_t *alloc,
+                    const bfdev_hashmap_ops_t *ops, unsigned int bits,
+                    unsigned int sbits, void *pdata)
+{
+    unsigned long capacity, nstripes;
+    bfdev_hlist_head_t *buckets;
+    void *block;
+
+    if (bfdev_unlikely(bits >= BFDEV_BITS_PER_LONG))
+        return -BFDEV_EINVAL;
+
+    if (sbits > bits)
+        sbits = bits;
+
+    capacity = BFDEV_BIT(bits);
+    nstripes = BFDEV_BIT(sbits);
+
+    buckets = bfdev_zalloc_array(alloc, capacity, sizeof(*buckets));
+    if (bfdev_unlikely(!buckets))
+        return -BFDEV_ENOMEM;
+
+    block = bfdev_zalloc(alloc, sizeof(*shardmap->stripes) *
+                         nstripes + BFDEV_CACHELINE_SIZE);
+    if (bfdev_unlikely(!block)) {
+        bfdev_free(alloc, buckets);
+        return -BFDEV_ENOMEM;
+    }
+
+    shardmap->buckets = buckets;
+    shardmap->bits = bits;
+    shardmap->capacity = capacity;
+
+    shardmap->block = block;
+    shardmap->stripes = bfdev_align_ptr_high(block, BFDEV_CACHELINE_SIZE);
+    shardmap->nstripes = nstripes;
+
+    bfdev_epoch_init(&shardmap->epoch);
+    shardmap->alloc = alloc;
+    shardmap->ops = ops;
+    shardmap->pdata = pdata;
+
+    return -BFDEV_ENOERR;
+}
+
+export void
+bfdev_shardmap_release(bfdev_shardmap_t *shardmap)
+{
+    const bfdev_alloc_t *alloc;
+
+    alloc = shardmap->alloc;
+    bfdev_free(alloc, shardmap->buckets);
+    bfdev_free(alloc, shardmap->block);
+
+    shardmap->buckets = NULL;
+    shardmap->stripes = NULL;
+    shardmap->block = NULL;
+}
@@ -0,0 +1,366 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#include <base.h>
+#include <bfdev/slab.h>
+#include <bfdev/atomic.h>
+#include <bfdev/align.h>
+#include <bfdev/minmax.h>
+#include <bfdev/sched.h>
+#include <export.h>
+
+#ifdef bfport_thread
+static bfport_thread unsigned int
+slab_thread;
+#endif
+
+static bfdev_atomic_t
+slab_threads;
+
+static __bfdev_always_inline bfdev_slab_cpu_t *
+slab_cpu(bfdev_slab_t *slab)
+{
+    unsigned int index;
+
+#ifdef bfport_thread
+    /* Threads are spread round-robin over the caches on first use */
+    if (bfdev_unlikely(!slab_thread))
+        slab_thread = bfdev_atomic_add_fetch(&slab_threads, 1);
+    index = slab_thread - 1;
+#else
+    /* Without thread locals every call takes the next cache */
+    index = bfdev_atomic_add_fetch(&slab_threads, 1);
+#endif
+
+    return &slab->cpus[index % BFDEV_SLAB_CPUS];
+}
+
+static bool
+slab_page_alloc(bfdev_slab_t *slab)
+{
+    size_t size;
+    void *page;
+
+    size = bfdev_max(BFDEV_SLAB_PAGE, slab->objsize * 8);
+    size += sizeof(void *) + slab->align;
+
+    page = bfdev_malloc(slab->alloc, size);
+    if (bfdev_unlikely(!page))
+        return false;
+
+    /* The first word chains the pages together */
+    *(void **)page = slab->pages;
+    slab->pages = page;
+
+    slab->bump = bfdev_align_ptr_high(page + sizeof(void *), slab->align);
+    slab->limit = page + size;
+
+    return true;
+}
+
+/* Called with the slab lock held */
+static void *
+slab_object_alloc(bfdev_slab_t *slab)
+{
+    void *block;
+
+    if (slab->freelist) {
+        block = slab->freelist;
+        slab->freelist = *(void **)block;
+        return block;
+    }
+
+    if (slab->bump + slab->objsize > slab->limit) {
+        if (!slab_page_alloc(slab))
+            return NULL;
+    }
+
+    block = slab->bump;
+    slab->bump += slab->objsize;
+
+    return block;
+}
+
+/* Called with the slab lock held */
+static __bfdev_always_inline void
+slab_object_free(bfdev_slab_t *slab, void *block)
+{
+    *(void **)block = slab->freelist;
+    slab->freelist = block;
+}
+
+static void
+slab_magazine_flush(bfdev_slab_t *slab, bfdev_slab_magazine_t *magazine)
+{
+    while (magazine->count)
+        slab_object_free(slab, magazine->objects[--magazine->count]);
+
+    magazine->next = slab->empty;
+    slab->empty = magazine;
+}
+
+export __bfdev_malloc void *
+bfdev_slab_alloc(bfdev_slab_t *slab)
+{
+    bfdev_slab_magazine_t *magazine;
+    bfdev_slab_cpu_t *cpu;
+    void *block;
+
+    cpu = slab_cpu(slab);
+    bfdev_spin_lock(&cpu->lock);
+
+    if (bfdev_likely(cpu->loaded && cpu->loaded->count))
+        goto finish;
+
+    if (cpu->previous && cpu->previous->count) {
+        bfdev_swap(cpu->loaded, cpu->previous);
+        goto finish;
+    }
+
+    bfdev_spin_lock(&slab->lock);
+    magazine = slab->full;
+
+    if (!magazine) {
+        block = slab_object_alloc(slab);
+        bfdev_spin_unlock(&slab->lock);
+        bfdev_spin_unlock(&cpu->lock);
+        return block;
+    }
+
+    /* Trade the empty previous magazine for a full one */
+    slab->full = magazine->next;
+    if (cpu->previous) {
+        cpu->previous->next = slab->empty;
+        slab->empty = cpu->previous;
+    }
+
+    bfdev_spin_unlock(&slab->lock);
+    cpu->previous = cpu->loaded;
+    cpu->loaded = magazine;
+
+finish:
+    block = cpu->loaded->objects[--cpu->loaded->count];
+    bfdev_spin_unlock(&cpu->lock);
+
+    return block;
+}
+
+export void
+bfdev_slab_free(bfdev_slab_t *slab, void *block)
+{
+    bfdev_slab_magazine_t *magazine;
+    bfdev_slab_cpu_t *cpu;
+
+    cpu = slab_cpu(slab);
+    bfdev_spin_lock(&cpu->lock);
+
+    if (bfdev_likely(cpu->loaded && cpu->loaded->count < BFDEV_SLAB_MAGAZINE))
+        goto finish;
+
+    if (cpu->previous && cpu->previous->count < BFDEV_SLAB_MAGAZINE) {
+        bfdev_swap(cpu->loaded, cpu->previous);
+        goto finish;
+    }
+
+    bfdev_spin_lock(&slab->lock);
+    magazine = slab->empty;
+
+    if (magazine)
+        slab->empty = magazine->next;
+    else {
+        magazine = bfdev_malloc(slab->alloc, sizeof(*magazine));
+        if (bfdev_unlikely(!magazine)) {
+            slab_object_free(slab, block);
+            bfdev_spin_unlock(&slab->lock);
+            bfdev_spin_unlock(&cpu->lock);
+            return;
+        }
+    }
+
+    /* Trade the full previous magazine for an empty one */
+    if (cpu->previous) {
+        cpu->previous->next = slab->full;
+        slab->full = cpu->previous;
+    }
+
+    bfdev_spin_unlock(&slab->lock);
+    magazine->count = 0;
+    cpu->previous = cpu->loaded;
+    cpu->loaded = magazine;
+
+finish:
+    cpu->loaded->objects[cpu->loaded->count++] = block;
+    bfdev_spin_unlock(&cpu->lock);
+}
+
+export void
+bfdev_slab_drain(bfdev_slab_t *slab)
+{
+    bfdev_slab_magazine_t *magazine, *detached;
+    bfdev_slab_cpu_t *cpu;
+    unsigned int count;
+
+    /* Same order as the hot path, never hold a cpu lock under the slab lock */
+    detached = NULL;
+    for (count = 0; count < BFDEV_SLAB_CPUS; ++count) {
+        cpu = &slab->cpus[count];
+        bfdev_spin_lock(&cpu->lock);
+
+        if (cpu->loaded) {
+            cpu->loaded->next = detached;
+            detached = cpu->loaded;
+        }
+
+        if (cpu->previous) {
+            cpu->previous->next = detached;
+            detached = cpu->previous;
+        }
+
+        cpu->loaded = cpu->previous = NULL;
+        bfdev_spin_unlock(&cpu->lock);
+    }
+
+    bfdev_spin_lock(&slab->lock);
+
+    while ((magazine = detached)) {
+        detached = magazine->next;
+        slab_magazine_flush(slab, magazine);
+    }
+
+    while ((magazine = slab->full)) {
+        slab->full = magazine->next;
+        slab_magazine_flush(slab, magazine);
+    }
+
+    while ((magazine = slab->empty)) {
+        slab->empty = magazine->next;
+        bfdev_free(slab->alloc, magazine);
+    }
+
+    bfdev_spin_unlock(&slab->lock);
+}
+
+static void *
+slab_adapter_alloc(size_t size, void *pdata)
+{
+    bfdev_slab_t *slab;
+    size_t header;
+    void *block;
+
+    slab = pdata;
+    header = bfdev_slab_header(slab);
+
+    if (size + header <= slab->objsize) {
+        block = bfdev_slab_alloc(slab);
+        if (bfdev_unlikely(!block))
+            return NULL;
+        *(size_t *)block = 0;
+    } else {
+        block = bfdev_malloc(slab->alloc, size + header);
+        if (bfdev_unlikely(!block))
+            return NULL;
+        *(size_t *)block = size;
+    }
+
+    return block + header;
+}
+
+static void *
+slab_adapter_zalloc(size_t size, void *pdata)
+{
+    void *block;
+
+    block = slab_adapter_alloc(size, pdata);
+    if (bfdev_likely(block))
+        bfport_memset(block, 0, size);
+
+    return block;
+}
+
+static void
+slab_adapter_free(void *block, void *pdata)
+{
+    bfdev_slab_t *slab;
+
+    slab = pdata;
+    block -= bfdev_slab_header(slab);
+
+    if (!*(size_t *)block)
+        bfdev_slab_free(slab, block);
+    else
+        bfdev_free(slab->alloc, block);
+}
+
+static void *
+slab_adapter_realloc(void *block, size_t resize, void *pdata)
+{
+    bfdev_slab_t *slab;
+    size_t header;
+    void *base, *retval;
+
+    slab = pdata;
+    header = bfdev_slab_header(slab);
+    base = block - header;
+
+    if (*(size_t *)base) {
+        base = bfdev_realloc(slab->alloc, base, resize + header);
+        if (bfdev_unlikely(!base))
+            return NULL;
+
+        *(size_t *)base = resize;
+        return base + header;
+    }
+
+    if (resize + header <= slab->objsize)
+        return block;
+
+    retval = slab_adapter_alloc(resize, pdata);
+    if (bfdev_unlikely(!retval))
+        return NULL;
+
+    bfport_memcpy(retval, block, slab->objsize - header);
+    bfdev_slab_free(slab, base);
+
+    return retval;
+}
+
+export int
+bfdev_slab_init(bfdev_slab_t *slab, const bfdev_alloc_t *alloc,
+                size_t objsize, size_t align)
+{
+    if (bfdev_unlikely(!objsize || (align & (align - 1))))
+        return -BFDEV_EINVAL;
+
+    bfport_memset(slab, 0, sizeof(*slab));
+    slab->alloc = alloc;
+
+    /* Free objects hold the freelist link */
+    slab->align = align ? bfdev_max(align, sizeof(void *)) : BFDEV_SLAB_ALIGN;
+    slab->objsize = bfdev_align_high(bfdev_max(objsize, sizeof(void *)),
+                                     slab->align);
+
+    bfdev_alloc_ops_init(&slab->ops, slab_adapter_alloc, slab_adapter_zalloc,
+                         slab_adapter_realloc, slab_adapter_free);
+    bfdev_alloc_init(&slab->allocator, &slab->ops, slab);
+
+    return -BFDEV_ENOERR;
+}
+
+export void
+bfdev_slab_release(bfdev_slab_t *slab)
+{
+    void *page, *next;
+
+    bfdev_slab_drain(slab);
+
+    for (page = slab->pages; page; page = next) {
+        next = *(void **)page;
+        bfdev_free(slab->alloc, page);
+    }
+
+    slab->pages = NULL;
+    slab->freelist = NULL;
+    slab->bump = slab->limit = NULL;
+}
@@ -0,0 +1,97 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "arena-realloc"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <bfdev/log.h>
+#include <bfdev/arena.h>
+#include <testsuite.h>
+
+#define TEST_CHUNK 4096
+#define TEST_SMALL 16
+#define TEST_LARGE 64
+
+static bool
+test_pattern(const uint8_t *block, size_t size, uint8_t seed)
+{
+    size_t count;
+
+    for (count = 0; count < size; ++count) {
+        if (block[count] != (uint8_t)(seed + count))
+            return false;
+    }
+
+    return true;
+}
+
+static void
+test_fill(uint8_t *block, size_t size, uint8_t seed)
+{
+    size_t count;
+
+    for (count = 0; count < size; ++count)
+        block[count] = seed + count;
+}
+
+TESTSUITE(
+    "arena:realloc", NULL, NULL,
+    "arena realloc of an older block"
+) {
+    const bfdev_alloc_t *alloc;
+    bfdev_arena_t arena;
+    uint8_t *blka, *blkb, *grown;
+    int retval;
+
+    bfdev_arena_init(&arena, NULL, TEST_CHUNK);
+    alloc = bfdev_arena_allocator(&arena);
+    retval = -BFDEV_EFAULT;
+
+    blka = bfdev_malloc(alloc, TEST_SMALL);
+    blkb = bfdev_malloc(alloc, TEST_SMALL);
+    if (!blka || !blkb)
+        goto failed;
+
+    test_fill(blka, TEST_SMALL, 0x10);
+    test_fill(blkb, TEST_SMALL, 0x80);
+
+    /* Not the latest block, the copy lands in the same chunk */
+    grown = bfdev_realloc(alloc, blka, TEST_LARGE);
+    if (!grown || grown == blka) {
+        bfdev_log_err("older block not moved\n");
+        goto failed;
+    }
+
+    if (grown < blkb + TEST_SMALL) {
+        bfdev_log_err("new block overlaps the old ones\n");
+        goto failed;
+    }
+
+    if (!test_pattern(grown, TEST_SMALL, 0x10) ||
+        !test_pattern(blkb, TEST_SMALL, 0x80)) {
+        bfdev_log_err("content lost on realloc\n");
+        goto failed;
+    }
+
+    /* The latest block grows in place */
+    if (bfdev_realloc(alloc, grown, TEST_LARGE * 2) != grown)
+        goto failed;
+
+    /* Moving an older block into a chunk of its own */
+    grown = bfdev_realloc(alloc, blkb, TEST_CHUNK * 2);
+    if (!grown || !test_pattern(grown, TEST_SMALL, 0x80)) {
+        bfdev_log_err("content lost across chunks\n");
+        goto failed;
+    }
+
+    retval = -BFDEV_ENOERR;
+
+failed:
+    bfdev_arena_release(&arena);
+    return retval;
+}
@@ -0,0 +1,241 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "cache-expire"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <bfdev/log.h>
+#include <bfdev/cache.h>
+#include <testsuite.h>
+
+#define TEST_SIZE 256
+#define TEST_STEP 997
+#define TEST_FAR ((bfdev_time_t)1 << 25)
+
+static unsigned long
+cache_hash(const void *tag, void *pdata)
+{
+    return (unsigned long)(uintptr_t)tag;
+}
+
+static long
+cache_find(const void *node, const void *tag, void *pdata)
+{
+    return node != tag;
+}
+
+static const bfdev_cache_ops_t
+cache_ops = {
+    .hash = cache_hash,
+    .find = cache_find,
+};
+
+static bfdev_time_t
+test_ttl(unsigned long value)
+{
+    /* Spread over every wheel level, and one beyond the wheel */
+    if (value == TEST_SIZE)
+        return TEST_FAR;
+
+    return (value * value * value) % 400000 + 1;
+}
+
+static int
+test_fill(bfdev_cache_head_t *cache)
+{
+    bfdev_cache_node_t *node;
+    unsigned long value;
+    int retval;
+
+    for (value = 1; value <= TEST_SIZE; ++value) {
+        node = bfdev_cache_get(cache, (void *)value);
+        if (!node || node->status != BFDEV_CACHE_PENDING)
+            return -BFDEV_EFAULT;
+
+        node->data = (void *)value;
+        bfdev_cache_committed(cache);
+
+        retval = bfdev_cache_ttl(cache, node, test_ttl(value));
+        if (retval)
+            return retval;
+
+        bfdev_cache_put(cache, node);
+    }
+
+    return -BFDEV_ENOERR;
+}
+
+static int
+test_verify(bfdev_cache_head_t *cache, bfdev_time_t now)
+{
+    bfdev_cache_node_t *node;
+    unsigned long value;
+    bool alive;
+
+    for (value = 1; value <= TEST_SIZE; ++value) {
+        alive = test_ttl(value) > now;
+        node = bfdev_cache_find(cache, (void *)value);
+
+        if (!!node != alive) {
+            bfdev_log_err("tag %lu at %lld: expected %s\n", value,
+                          (long long)now, alive ? "alive" : "expired");
+            return -BFDEV_EFAULT;
+        }
+    }
+
+    return -BFDEV_ENOERR;
+}
+
+TESTSUITE(
+    "cache:expire", NULL, NULL,
+    "cache timing wheel expire test"
+) {
+    bfdev_cache_head_t *cache;
+    unsigned long expired, total;
+    bfdev_time_t now;
+    int retval;
+
+    cache = bfdev_cache_create("lru", NULL, &cache_ops, TEST_SIZE, 1, NULL);
+    if (!cache)
+        return -BFDEV_ENOMEM;
+
+    retval = test_fill(cache);
+    if (retval)
+        goto failed;
+
+    total = 0;
+    for (now = 0; now < 400000 + TEST_STEP; now += TEST_STEP) {
+        expired = bfdev_cache_expire(cache, now);
+        total += expired;
+
+        retval = test_verify(cache, now);
+        if (retval)
+            goto failed;
+    }
+
+    /* Only the far timer is left, and the wheel fast-forwards to it */
+    if (total != TEST_SIZE - 1 || bfdev_cache_expire(cache, TEST_FAR) != 1) {
+        bfdev_log_err("expired count mismatch %lu\n", total);
+        retval = -BFDEV_EFAULT;
+    }
+
+failed:
+    bfdev_cache_destroy(cache);
+    return retval;
+}
+
+TESTSUITE(
+    "cache:pinned", NULL, NULL,
+    "cache expire while in use test"
+) {
+    bfdev_cache_head_t *cache;
+    bfdev_cache_node_t *node;
+    int retval;
+
+    cache = bfdev_cache_create("lru", NULL, &cache_ops, 2, 1, NULL);
+    if (!cache)
+        return -BFDEV_ENOMEM;
+
+    retval = -BFDEV_EFAULT;
+    node = bfdev_cache_get(cache, (void *)1);
+    if (!node)
+        goto failed;
+
+    node->data = (void *)1;
+    bfdev_cache_committed(cache);
+    if (bfdev_cache_ttl(cache, node, 10))
+        goto failed;
+
+    /* Pinned element survives its deadline until the last put */
+    if (bfdev_cache_expire(cache, 20) != 0 ||
+        bfdev_cache_get(cache, (void *)1) != node)
+        goto failed;
+
+    bfdev_cache_put(cache, node);
+    bfdev_cache_put(cache, node);
+
+    if (node->status != BFDEV_CACHE_FREED || cache->expired != 1 ||
+        bfdev_cache_find(cache, (void *)1))
+        goto failed;
+
+    retval = -BFDEV_ENOERR;
+
+failed:
+    bfdev_cache_destroy(cache);
+    return retval;
+}
+
+TESTSUITE(
+    "cache:idle", NULL, NULL,
+    "cache expire after long idle test"
+) {
+    static bfdev_time_t ttls[TEST_SIZE + 1];
+    bfdev_cache_head_t *cache;
+    bfdev_cache_node_t *node;
+    unsigned long value, alive, expired;
+    bfdev_time_t now, step;
+    unsigned int seed;
+    int retval;
+
+    cache = bfdev_cache_create("lru", NULL, &cache_ops, TEST_SIZE, 1, NULL);
+    if (!cache)
+        return -BFDEV_ENOMEM;
+
+    /* Deadlines far beyond the wheel, reached in a few huge jumps */
+    seed = TEST_SIZE;
+    for (value = 1; value <= TEST_SIZE; ++value) {
+        ttls[value] = (bfdev_time_t)rand_r(&seed) + 1;
+
+        node = bfdev_cache_get(cache, (void *)value);
+        if (!node || node->status != BFDEV_CACHE_PENDING) {
+            retval = -BFDEV_EFAULT;
+            goto failed;
+        }
+
+        node->data = (void *)value;
+        bfdev_cache_committed(cache);
+
+        retval = bfdev_cache_ttl(cache, node, ttls[value]);
+        if (retval)
+            goto failed;
+
+        bfdev_cache_put(cache, node);
+    }
+
+    alive = TEST_SIZE;
+    retval = -BFDEV_EFAULT;
+
+    for (now = 0; alive; now += step) {
+        step = (rand_r(&seed) >> 4) + 1;
+        expired = bfdev_cache_expire(cache, now);
+        alive -= expired;
+
+        for (value = 1; value <= TEST_SIZE; ++value) {
+            if (!!bfdev_cache_find(cache, (void *)value) != (ttls[value] > now)) {
+                bfdev_log_err("tag %lu at %lld: deadline %lld\n", value,
+                              (long long)now, (long long)ttls[value]);
+                goto failed;
+            }
+        }
+    }
+
+    /* The far deadline still fires exactly on its tick */
+    if (test_fill(cache))
+        goto failed;
+
+    now = cache->clock;
+    if (bfdev_cache_expire(cache, now + TEST_FAR - 1) != TEST_SIZE - 1 ||
+        bfdev_cache_expire(cache, now + TEST_FAR - 1) != 0 ||
+        bfdev_cache_expire(cache, now + TEST_FAR) != 1)
+        goto failed;
+
+    retval = -BFDEV_ENOERR;
+
+failed:
+    bfdev_cache_destroy(cache);
+    return retval;
+}
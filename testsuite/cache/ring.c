@@ -0,0 +1,136 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "cache-ring"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <bfdev/log.h>
+#include <bfdev/cache.h>
+#include <testsuite.h>
+
+#define TEST_SIZE 64
+#define TEST_LOOP 4096
+
+static unsigned long
+cache_hash(const void *tag, void *pdata)
+{
+    return (unsigned long)(uintptr_t)tag;
+}
+
+static long
+cache_find(const void *node, const void *tag, void *pdata)
+{
+    return node != tag;
+}
+
+static const bfdev_cache_ops_t
+cache_ops = {
+    .hash = cache_hash,
+    .find = cache_find,
+};
+
+static bfdev_cache_node_t *
+test_fill(bfdev_cache_head_t *cache, unsigned long value)
+{
+    bfdev_cache_node_t *node;
+
+    node = bfdev_cache_get(cache, (void *)value);
+    if (node && node->status == BFDEV_CACHE_PENDING) {
+        node->data = (void *)value;
+        bfdev_cache_committed(cache);
+    }
+
+    return node;
+}
+
+static int
+test_ring(const char *name)
+{
+    bfdev_cache_head_t *cache;
+    bfdev_cache_node_t *node, *held[TEST_SIZE];
+    unsigned long count, value;
+    int retval;
+
+    cache = bfdev_cache_create(name, NULL, &cache_ops, TEST_SIZE, 1, NULL);
+    if (!cache)
+        return -BFDEV_ENOMEM;
+
+    retval = -BFDEV_EFAULT;
+    for (value = 1; value <= TEST_SIZE; ++value) {
+        node = test_fill(cache, value);
+        if (!node)
+            goto failed;
+        bfdev_cache_put(cache, node);
+    }
+
+    /* Hits pin nodes in place without moving them */
+    for (count = 0; count < TEST_SIZE / 2; ++count) {
+        held[count] = bfdev_cache_get(cache, (void *)(count + 1));
+        if (!held[count] || held[count]->status != BFDEV_CACHE_USING ||
+            !bfdev_list_check_empty(&held[count]->list))
+            goto failed;
+    }
+
+    /* Misses must sweep around the pinned ones */
+    for (value = TEST_SIZE + 1; value < TEST_LOOP; ++value) {
+        node = test_fill(cache, value);
+        if (!node)
+            goto failed;
+        bfdev_cache_put(cache, node);
+    }
+
+    for (count = 0; count < TEST_SIZE / 2; ++count) {
+        if (held[count]->data != (void *)(count + 1) ||
+            bfdev_cache_find(cache, (void *)(count + 1)) != held[count])
+            goto failed;
+    }
+
+    /* With every node pinned the cache starves */
+    for (value = TEST_LOOP - TEST_SIZE / 2; value < TEST_LOOP; ++value) {
+        held[count] = bfdev_cache_get(cache, (void *)value);
+        if (!held[count++])
+            goto failed;
+    }
+
+    if (bfdev_cache_get(cache, (void *)(uintptr_t)TEST_LOOP))
+        goto failed;
+
+    for (count = 0; count < TEST_SIZE; ++count)
+        bfdev_cache_put(cache, held[count]);
+
+    node = test_fill(cache, TEST_LOOP);
+    if (!node || node->status != BFDEV_CACHE_USING)
+        goto failed;
+    bfdev_cache_put(cache, node);
+
+    retval = -BFDEV_ENOERR;
+
+failed:
+    if (retval)
+        bfdev_log_err("%s: ring check failed\n", name);
+    bfdev_cache_destroy(cache);
+    return retval;
+}
+
+TESTSUITE(
+    "cache:ring", NULL, NULL,
+    "cache ring algorithm hit test"
+) {
+    const char *algos[] = {
+        "clock", "clockpro",
+    };
+    unsigned int index;
+    int retval;
+
+    for (index = 0; index < BFDEV_ARRAY_SIZE(algos); ++index) {
+        retval = test_ring(algos[index]);
+        if (retval)
+            return retval;
+    }
+
+    return -BFDEV_ENOERR;
+}
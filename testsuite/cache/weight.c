@@ -0,0 +1,134 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "cache-weight"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <bfdev/log.h>
+#include <bfdev/cache.h>
+#include <testsuite.h>
+
+#define TEST_SIZE 1024
+#define TEST_LOOP 65536
+#define TEST_RANGE 4096
+#define TEST_BUDGET 65536
+#define TEST_COST 1024
+
+static unsigned long
+cache_hash(const void *tag, void *pdata)
+{
+    return (unsigned long)(uintptr_t)tag;
+}
+
+static long
+cache_find(const void *node, const void *tag, void *pdata)
+{
+    return node != tag;
+}
+
+static const bfdev_cache_ops_t
+cache_ops = {
+    .hash = cache_hash,
+    .find = cache_find,
+};
+
+static unsigned long
+test_cost(unsigned long value)
+{
+    /* Costs range over three orders of magnitude */
+    return (value * 2654435761UL) % TEST_COST + 1;
+}
+
+static int
+test_weight(const char *name)
+{
+    bfdev_cache_head_t *cache;
+    bfdev_cache_node_t *node;
+    bfdev_cache_stats_t stats;
+    unsigned long count, value, weight;
+    unsigned int seed;
+    int retval;
+
+    cache = bfdev_cache_create(name, NULL, &cache_ops, TEST_SIZE, 1, NULL);
+    if (!cache)
+        return -BFDEV_ENOMEM;
+
+    retval = -BFDEV_EFAULT;
+    bfdev_cache_budget(cache, TEST_BUDGET);
+
+    seed = TEST_LOOP;
+    for (count = 0; count < TEST_LOOP; ++count) {
+        value = rand_r(&seed) % TEST_RANGE + 1;
+        node = bfdev_cache_get(cache, (void *)value);
+        if (!node)
+            goto failed;
+
+        if (node->status == BFDEV_CACHE_PENDING) {
+            node->data = (void *)value;
+            bfdev_cache_committed(cache);
+
+            if (bfdev_cache_weight(cache, node, test_cost(value)))
+                goto failed;
+        }
+
+        if (node->cost != test_cost(value))
+            goto failed;
+
+        bfdev_cache_put(cache, node);
+        if (cache->weight > TEST_BUDGET) {
+            bfdev_log_err("%s: weight %lu over budget\n", name, cache->weight);
+            goto failed;
+        }
+    }
+
+    /* The total must match the resident elements exactly */
+    weight = 0;
+    for (count = 0; count < TEST_SIZE; ++count) {
+        node = cache->nodes[count];
+        if (node->status != BFDEV_CACHE_FREED)
+            weight += node->cost;
+    }
+
+    bfdev_cache_stats(cache, &stats);
+    if (stats.weight != weight || stats.peak < weight ||
+        stats.peak > TEST_BUDGET + TEST_COST) {
+        bfdev_log_err("%s: weight %lu peak %lu expect %lu\n", name,
+                      stats.weight, stats.peak, weight);
+        goto failed;
+    }
+
+    /* Shrinking the budget evicts at once */
+    bfdev_cache_budget(cache, TEST_BUDGET / 4);
+    if (cache->weight > TEST_BUDGET / 4)
+        goto failed;
+
+    retval = -BFDEV_ENOERR;
+
+failed:
+    bfdev_cache_destroy(cache);
+    return retval;
+}
+
+TESTSUITE(
+    "cache:weight", NULL, NULL,
+    "cache weighted capacity test"
+) {
+    const char *algos[] = {
+        "lru", "lfu", "lfuo1", "clock",
+        "clockpro", "arc", "tinylfu",
+    };
+    unsigned int index;
+    int retval;
+
+    for (index = 0; index < BFDEV_ARRAY_SIZE(algos); ++index) {
+        retval = test_weight(algos[index]);
+        if (retval)
+            return retval;
+    }
+
+    return -BFDEV_ENOERR;
+}
@@ -10,6 +10,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <bfdev/fifo.h>
+#include <bfdev/fifo-spsc.h>
 #include <bfdev/log.h>
 #include <testsuite.h>
 
@@ -428,3 +429,156 @@ TESTSUITE(
 
     return -BFDEV_ENOERR;
 }
+
+static unsigned long
+span_fill(bfdev_span_t *span, long value)
+{
+    unsigned long count, index;
+    long *data;
+
+    for (count = index = 0; index < 2; ++index) {
+        for (data = span[index].base; (void *)data <
+             span[index].base + span[index].len; ++data)
+            *data = value + count++;
+    }
+
+    return count;
+}
+
+static unsigned long
+span_check(bfdev_span_t *span, long value)
+{
+    unsigned long count, index;
+    long *data;
+
+    for (count = index = 0; index < 2; ++index) {
+        for (data = span[index].base; (void *)data <
+             span[index].base + span[index].len; ++data) {
+            if (*data != value + (long)count++)
+                return 0;
+        }
+    }
+
+    return count;
+}
+
+TESTSUITE(
+    "fifo:span", NULL, NULL,
+    "fifo zero-copy span test"
+) {
+    BFDEV_DECLARE_FIFO(fifo, long, TEST_LOOP);
+    bfdev_span_t span[2];
+    unsigned long length;
+    long value, check;
+    unsigned int count;
+
+    fifo = BFDEV_FIFO_INIT(&fifo);
+    value = check = 0;
+
+    for (count = 1; count < TEST_LOOP * 4; ++count) {
+        length = bfdev_fifo_reserve(&fifo, span, count % TEST_LOOP + 1);
+        bfdev_log_debug("span reserve %lu\n", length);
+        if (bfdev_span_len(span) != length * sizeof(long) ||
+            span_fill(span, value) != length)
+            return -BFDEV_EFAULT;
+
+        value += bfdev_fifo_commit(&fifo, length);
+        if (bfdev_fifo_len(&fifo) != (unsigned long)(value - check))
+            return -BFDEV_EFAULT;
+
+        /* Leave a few behind so that spans keep wrapping */
+        length = bfdev_fifo_peek_span(&fifo, span, count % 5 + 1);
+        bfdev_log_debug("span peek %lu\n", length);
+        if (span_check(span, check) != length)
+            return -BFDEV_EFAULT;
+
+        check += bfdev_fifo_consume(&fifo, length);
+    }
+
+    return -BFDEV_ENOERR;
+}
+
+TESTSUITE(
+    "fifo:mirror", NULL, NULL,
+    "fifo mirrored record test"
+) {
+    BFDEV_DECLARE_FIFO_DYNAMIC_RECORD(fifo, char, 2);
+    bfdev_span_t span[2];
+    char buffer[TEST_LOOP * 32];
+    unsigned long length, count, index, loop;
+    int retval;
+
+    fifo = BFDEV_FIFO_DYNAMIC_INIT(&fifo);
+    retval = bfdev_fifo_alloc_mirror(&fifo, TEST_LOOP);
+    if (retval == -BFDEV_EOPNOTSUPP)
+        return -BFDEV_ENOERR;
+    else if (retval)
+        return retval;
+
+    for (index = 0; index < sizeof(buffer); ++index)
+        buffer[index] = (char)index;
+
+    /* Keep several records queued so that they wrap around */
+    for (loop = 0; loop < bfdev_fifo_size(&fifo) / 8; ++loop) {
+        count = (loop * 37) % sizeof(buffer) + 1;
+        while (!bfdev_fifo_in(&fifo, buffer, count)) {
+            length = bfdev_fifo_peek_span(&fifo, span, sizeof(buffer));
+            if (span[1].len || memcmp(span[0].base, buffer, length))
+                return -BFDEV_EFAULT;
+            if (bfdev_fifo_consume(&fifo, 0) != length)
+                return -BFDEV_EFAULT;
+        }
+    }
+
+    while (!bfdev_fifo_check_empty(&fifo)) {
+        length = bfdev_fifo_peek_span(&fifo, span, sizeof(buffer));
+        if (span[1].len || memcmp(span[0].base, buffer, length))
+            return -BFDEV_EFAULT;
+        bfdev_fifo_consume(&fifo, 0);
+    }
+
+    bfdev_fifo_free(&fifo);
+
+    return -BFDEV_ENOERR;
+}
+
+TESTSUITE(
+    "fifo:spsc", NULL, NULL,
+    "fifo spsc storage test"
+) {
+    bfdev_fifo_spsc_t spsc;
+    long buffer[TEST_LOOP], value;
+    unsigned int count;
+    int retval;
+
+    retval = bfdev_fifo_spsc_init(&spsc, buffer, sizeof(long), TEST_LOOP);
+    if (retval)
+        return retval;
+
+    for (count = 0; count < TEST_LOOP * 4; ++count) {
+        value = longtest_table[count % TEST_LOOP];
+        if (bfdev_fifo_spsc_in(&spsc, &value, 1) != 1)
+            return -BFDEV_EFAULT;
+        if (bfdev_fifo_spsc_out(&spsc, &value, 1) != 1 ||
+            value != longtest_table[count % TEST_LOOP])
+            return -BFDEV_EFAULT;
+    }
+
+    /* Caller buffers must survive */
+    bfdev_fifo_spsc_free(&spsc);
+    if (spsc.data != buffer)
+        return -BFDEV_EFAULT;
+
+    retval = bfdev_fifo_spsc_alloc(&spsc, NULL, sizeof(long), TEST_LOOP);
+    if (retval)
+        return retval;
+
+    if (bfdev_fifo_spsc_in(&spsc, longtest_table, TEST_LOOP) != TEST_LOOP ||
+        bfdev_fifo_spsc_out(&spsc, buffer, TEST_LOOP) != TEST_LOOP ||
+        memcmp(buffer, longtest_table, sizeof(buffer)))
+        return -BFDEV_EFAULT;
+
+    bfdev_fifo_spsc_free(&spsc);
+
+    return -BFDEV_ENOERR;
+}
@@ -0,0 +1,168 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "flatmap-fuzzy"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <bfdev/log.h>
+#include <bfdev/flatmap.h>
+#include <testsuite.h>
+
+#define TEST_KEYS 4096
+#define TEST_LOOP 262144
+
+struct test_node {
+    unsigned long value;
+    bool inserted;
+};
+
+static unsigned long
+test_hash_key(const void *key, void *pdata)
+{
+    /* Deliberately weak to provoke long probe sequences */
+    return (unsigned long)key & ~0xfUL;
+}
+
+static unsigned long
+test_hash_node(const void *node, void *pdata)
+{
+    const struct test_node *tnode;
+
+    tnode = node;
+
+    return tnode->value & ~0xfUL;
+}
+
+static long
+test_equal(const void *node1, const void *node2, void *pdata)
+{
+    const struct test_node *tnode1, *tnode2;
+
+    tnode1 = node1;
+    tnode2 = node2;
+
+    return tnode1->value - tnode2->value;
+}
+
+static long
+test_find(const void *node, const void *key, void *pdata)
+{
+    const struct test_node *tnode;
+
+    tnode = node;
+
+    return tnode->value - (unsigned long)key;
+}
+
+static bfdev_flatmap_ops_t
+test_ops = {
+    .hash_key = test_hash_key,
+    .hash_node = test_hash_node,
+    .equal = test_equal,
+    .find = test_find,
+};
+
+static void *
+test_prepare(int argc, const char *argv[])
+{
+    struct test_node *nodes;
+
+    nodes = malloc(sizeof(*nodes) * TEST_KEYS);
+    if (!nodes)
+        return BFDEV_ERR_PTR(-BFDEV_ENOMEM);
+
+    return nodes;
+}
+
+static void
+test_release(void *data)
+{
+    free(data);
+}
+
+TESTSUITE(
+    "flatmap:fuzzy",
+    test_prepare, test_release,
+    "flatmap random insert and delete fuzzy test"
+) {
+    struct test_node *nodes, *node, *find;
+    unsigned long used, value, index;
+    unsigned int count;
+    int retval;
+
+    BFDEV_DEFINE_FLATMAP(test_map, NULL, &test_ops, NULL);
+    nodes = data;
+    used = 0;
+
+    for (count = 0; count < TEST_KEYS; ++count) {
+        nodes[count].value = count;
+        nodes[count].inserted = false;
+    }
+
+    srand(time(NULL));
+    for (count = 0; count < TEST_LOOP; ++count) {
+        value = (unsigned int)rand() % TEST_KEYS;
+        node = &nodes[value];
+
+        if (node->inserted) {
+            retval = bfdev_flatmap_del(&test_map, (void *)value, (void **)&find);
+            if (retval || find != node) {
+                bfdev_log_err("delete %lu failed\n", value);
+                retval = -BFDEV_EFAULT;
+                goto failed;
+            }
+
+            node->inserted = false;
+            used--;
+        } else {
+            retval = bfdev_flatmap_add(&test_map, node);
+            if (retval) {
+                bfdev_log_err("insert %lu failed\n", value);
+                goto failed;
+            }
+
+            node->inserted = true;
+            used++;
+        }
+
+        value = (unsigned int)rand() % TEST_KEYS;
+        find = bfdev_flatmap_find(&test_map, (void *)value);
+        if (find != (nodes[value].inserted ? &nodes[value] : NULL)) {
+            bfdev_log_err("lookup %lu mismatch\n", value);
+            retval = -BFDEV_EFAULT;
+            goto failed;
+        }
+    }
+
+    if (test_map.used != used) {
+        bfdev_log_err("used count leak %lu -> %lu\n", used, test_map.used);
+        retval = -BFDEV_EFAULT;
+        goto failed;
+    }
+
+    bfdev_flatmap_for_each(find, &test_map, index) {
+        if (!find->inserted) {
+            bfdev_log_err("stale node %lu\n", find->value);
+            retval = -BFDEV_EFAULT;
+            goto failed;
+        }
+        used--;
+    }
+
+    if (used) {
+        bfdev_log_err("iterate missing %lu nodes\n", used);
+        retval = -BFDEV_EFAULT;
+        goto failed;
+    }
+
+    retval = -BFDEV_ENOERR;
+
+failed:
+    bfdev_flatmap_release(&test_map);
+    return retval;
+}
@@ -0,0 +1,306 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "hashmap-fuzzy"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <bfdev/log.h>
+#include <bfdev/hashmap.h>
+#include <testsuite.h>
+
+#define TEST_KEYS 4096
+#define TEST_LOOP 262144
+#define TEST_BATCH 37
+
+struct test_node {
+    bfdev_hashmap_node_t node;
+    unsigned long value;
+    bool inserted;
+};
+
+#define node_to_test(ptr) \
+    bfdev_container_of(ptr, struct test_node, node.node)
+
+static unsigned long
+test_hash_key(const void *key, void *pdata)
+{
+    return (unsigned long)key;
+}
+
+static unsigned long
+test_hash_node(const bfdev_hlist_node_t *node, void *pdata)
+{
+    struct test_node *tnode;
+
+    tnode = node_to_test(node);
+
+    return tnode->value;
+}
+
+static long
+test_equal(const bfdev_hlist_node_t *node1,
+           const bfdev_hlist_node_t *node2, void *pdata)
+{
+    struct test_node *tnode1, *tnode2;
+
+    tnode1 = node_to_test(node1);
+    tnode2 = node_to_test(node2);
+
+    return tnode1->value - tnode2->value;
+}
+
+static long
+test_find(const bfdev_hlist_node_t *node, const void *key, void *pdata)
+{
+    struct test_node *tnode;
+
+    tnode = node_to_test(node);
+
+    return tnode->value - (unsigned long)key;
+}
+
+static bfdev_hashmap_ops_t
+test_ops = {
+    .hash_key = test_hash_key,
+    .hash_node = test_hash_node,
+    .equal = test_equal,
+    .find = test_find,
+};
+
+static int
+test_batch(bfdev_hashmap_t *hashmap, struct test_node *nodes)
+{
+    bfdev_hlist_node_t *hnodes[TEST_BATCH];
+    const void *keys[TEST_BATCH];
+    unsigned int count, found, expect;
+    unsigned long value;
+
+    expect = 0;
+    for (count = 0; count < TEST_BATCH; ++count) {
+        value = (unsigned int)rand() % TEST_KEYS;
+        keys[count] = (void *)value;
+        expect += nodes[value].inserted;
+    }
+
+    found = bfdev_hashmap_find_batch(hashmap, keys, hnodes, TEST_BATCH);
+    if (found != expect) {
+        bfdev_log_err("batch found %u expect %u\n", found, expect);
+        return -BFDEV_EFAULT;
+    }
+
+    for (count = 0; count < TEST_BATCH; ++count) {
+        value = (unsigned long)keys[count];
+        if (hnodes[count] != (nodes[value].inserted ? &nodes[value].node.node : NULL)) {
+            bfdev_log_err("batch lookup %lu mismatch\n", value);
+            return -BFDEV_EFAULT;
+        }
+    }
+
+    return -BFDEV_ENOERR;
+}
+
+static int
+test_hashmap(struct test_node *nodes, unsigned long flags)
+{
+    struct test_node *node, *find;
+    bfdev_hlist_node_t *hnode;
+    unsigned long used, value, index;
+    unsigned int count;
+    int retval;
+
+    BFDEV_DEFINE_HASHMAP(test_map, NULL, &test_ops, NULL);
+    test_map.flags = flags;
+
+    for (count = 0; count < TEST_KEYS; ++count) {
+        nodes[count].value = count;
+        nodes[count].inserted = false;
+    }
+
+    used = 0;
+    srand(time(NULL));
+
+    for (count = 0; count < TEST_LOOP; ++count) {
+        value = (unsigned int)rand() % TEST_KEYS;
+        node = &nodes[value];
+
+        /* Bias toward growing first, then shrinking */
+        if (node->inserted && (count > TEST_LOOP / 2 || rand() % 4 == 0)) {
+            retval = bfdev_hashmap_del(&test_map, (void *)value, &hnode);
+            if (retval || hnode != &node->node.node) {
+                bfdev_log_err("delete %lu failed\n", value);
+                retval = -BFDEV_EFAULT;
+                goto failed;
+            }
+
+            node->inserted = false;
+            used--;
+        } else if (!node->inserted) {
+            retval = bfdev_hashmap_add(&test_map, &node->node.node);
+            if (retval) {
+                bfdev_log_err("insert %lu failed\n", value);
+                goto failed;
+            }
+
+            node->inserted = true;
+            used++;
+        }
+
+        value = (unsigned int)rand() % TEST_KEYS;
+        hnode = bfdev_hashmap_find(&test_map, (void *)value);
+        if (hnode != (nodes[value].inserted ? &nodes[value].node.node : NULL)) {
+            bfdev_log_err("lookup %lu mismatch\n", value);
+            retval = -BFDEV_EFAULT;
+            goto failed;
+        }
+
+        if (count % 64 == 0) {
+            retval = test_batch(&test_map, nodes);
+            if (retval)
+                goto failed;
+        }
+    }
+
+    if (test_map.used != used) {
+        bfdev_log_err("used count leak %lu -> %lu\n", used, test_map.used);
+        retval = -BFDEV_EFAULT;
+        goto failed;
+    }
+
+    bfdev_hashmap_for_each_entry(find, &test_map, node.node, index) {
+        if (!find->inserted) {
+            bfdev_log_err("stale node %lu\n", find->value);
+            retval = -BFDEV_EFAULT;
+            goto failed;
+        }
+        used--;
+    }
+
+    if (used) {
+        bfdev_log_err("iterate missing %lu nodes\n", used);
+        retval = -BFDEV_EFAULT;
+        goto failed;
+    }
+
+    retval = -BFDEV_ENOERR;
+
+failed:
+    bfdev_hashmap_release(&test_map);
+    return retval;
+}
+
+static bool
+test_bounded(bfdev_hashmap_t *hashmap, bfdev_hlist_head_t *obuckets,
+             unsigned long ocapacity, unsigned long migrate)
+{
+    /* A migration in flight only advances by one step per operation */
+    if (!obuckets)
+        return true;
+
+    if (hashmap->obuckets == obuckets)
+        return hashmap->migrate - migrate <= hashmap->mstep;
+
+    return ocapacity - migrate <= hashmap->mstep;
+}
+
+static int
+test_drain(struct test_node *nodes)
+{
+    bfdev_hlist_head_t *obuckets;
+    unsigned long ocapacity, migrate, value;
+    int retval;
+
+    BFDEV_DEFINE_HASHMAP(test_map, NULL, &test_ops, NULL);
+    test_map.flags = BFDEV_HASHMAP_INCREMENTAL;
+
+    for (value = 0; value < TEST_KEYS * 2; ++value) {
+        obuckets = test_map.obuckets;
+        ocapacity = test_map.ocapacity;
+        migrate = test_map.migrate;
+
+        if (value < TEST_KEYS) {
+            nodes[value].value = value;
+            retval = bfdev_hashmap_add(&test_map, &nodes[value].node.node);
+        } else
+            retval = bfdev_hashmap_del(&test_map,
+                                       (void *)(value - TEST_KEYS), NULL);
+
+        if (retval) {
+            bfdev_log_err("drain %lu failed\n", value);
+            goto failed;
+        }
+
+        if (!test_bounded(&test_map, obuckets, ocapacity, migrate)) {
+            bfdev_log_err("drain %lu migrated in one go\n", value);
+            retval = -BFDEV_EFAULT;
+            goto failed;
+        }
+    }
+
+    /* Deferred shrinks still catch up with the drain */
+    if (test_map.capacity > TEST_KEYS / 16) {
+        bfdev_log_err("drain left %lu buckets\n", test_map.capacity);
+        retval = -BFDEV_EFAULT;
+        goto failed;
+    }
+
+    retval = -BFDEV_ENOERR;
+
+failed:
+    bfdev_hashmap_release(&test_map);
+    return retval;
+}
+
+static void *
+test_prepare(int argc, const char *argv[])
+{
+    struct test_node *nodes;
+
+    nodes = malloc(sizeof(*nodes) * TEST_KEYS);
+    if (!nodes)
+        return BFDEV_ERR_PTR(-BFDEV_ENOMEM);
+
+    return nodes;
+}
+
+static void
+test_release(void *data)
+{
+    free(data);
+}
+
+TESTSUITE(
+    "hashmap:burst",
+    test_prepare, test_release,
+    "hashmap burst rehash fuzzy test"
+) {
+    return test_hashmap(data, 0);
+}
+
+TESTSUITE(
+    "hashmap:incremental",
+    test_prepare, test_release,
+    "hashmap incremental rehash fuzzy test"
+) {
+    return test_hashmap(data, BFDEV_HASHMAP_INCREMENTAL);
+}
+
+TESTSUITE(
+    "hashmap:cached",
+    test_prepare, test_release,
+    "hashmap cached hash incremental rehash fuzzy test"
+) {
+    return test_hashmap(data, BFDEV_HASHMAP_INCREMENTAL | BFDEV_HASHMAP_CACHED);
+}
+
+TESTSUITE(
+    "hashmap:drain",
+    test_prepare, test_release,
+    "hashmap incremental rehash drain test"
+) {
+    return test_drain(data);
+}
@@ -109,6 +109,22 @@ NAME(int argc, const char *argv[])                      \
     return pool;                                        \
 }
 
+static void *
+tlsf_prepare(int argc, const char *argv[])
+{
+    bfdev_memalloc_tlsf_t *tlsf;
+    void *memory;
+
+    tlsf = malloc(sizeof(*tlsf) + POOL_SIZE);
+    if (!tlsf)
+        return BFDEV_ERR_PTR(-BFDEV_ENOMEM);
+
+    memory = (void *)tlsf + sizeof(*tlsf);
+    bfdev_memalloc_tlsf_init(tlsf, memory, POOL_SIZE);
+
+    return &tlsf->head;
+}
+
 static void
 test_release(void *data)
 {
@@ -142,3 +158,35 @@ TESTSUITE(
 ) {
     return test_memalloc(data);
 }
+
+TESTSUITE(
+    "memalloc:tlsf",
+    tlsf_prepare, test_release,
+    "memalloc tlsf fuzzy test"
+) {
+    return test_memalloc(data);
+}
+
+TESTSUITE(
+    "memalloc:tlsf-plain", NULL, NULL,
+    "memalloc tlsf on a plain head"
+) {
+    bfdev_memalloc_head_t *head;
+    void *memory;
+    int retval;
+
+    /* The head alone, no room behind it for the tlsf bins */
+    head = malloc(sizeof(*head));
+    memory = malloc(BFDEV_SZ_64KiB);
+    retval = -BFDEV_ENOMEM;
+    if (!head || !memory)
+        goto failed;
+
+    bfdev_memalloc_init(head, bfdev_memalloc_tlsf, memory, BFDEV_SZ_64KiB);
+    retval = bfdev_memalloc_alloc(head, 64) ? -BFDEV_EFAULT : -BFDEV_ENOERR;
+
+failed:
+    free(memory);
+    free(head);
+    return retval;
+}
@@ -0,0 +1,261 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright(c) 2025 John Sanpe <sanpeqf@gmail.com>
+ */
+
+#define MODULE_NAME "shardmap-fuzzy"
+#define bfdev_log_fmt(fmt) MODULE_NAME ": " fmt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <bfdev/log.h>
+#include <bfdev/shardmap.h>
+#include <testsuite.h>
+
+#define TEST_BITS 10
+#define TEST_KEYS 4096
+#define TEST_LOOP 65536
+#define TEST_THREADS 4
+#define TEST_PENDING 16
+
+enum test_state {
+    TEST_FREE = 0,
+    TEST_INSERTED,
+    TEST_PENDING_FREE,
+};
+
+struct test_node {
+    bfdev_hlist_node_t node;
+    unsigned long value;
+    enum test_state state;
+};
+
+struct test_thread {
+    pthread_t thread;
+    bfdev_shardmap_t *shardmap;
+    struct test_node *nodes;
+    unsigned int index;
+    unsigned int seed;
+    int retval;
+};
+
+#define node_to_test(ptr) \
+    bfdev_container_of(ptr, struct test_node, node)
+
+static unsigned long
+test_hash_key(const void *key, void *pdata)
+{
+    /* Deliberately weak to provoke long chains */
+    return (unsigned long)key & ~0x7UL;
+}
+
+static unsigned long
+test_hash_node(const bfdev_hlist_node_t *node, void *pdata)
+{
+    struct test_node *tnode;
+
+    tnode = node_to_test(node);
+
+    return tnode->value & ~0x7UL;
+}
+
+static long
+test_equal(const bfdev_hlist_node_t *node1,
+           const bfdev_hlist_node_t *node2, void *pdata)
+{
+    struct test_node *tnode1, *tnode2;
+
+    tnode1 = node_to_test(node1);
+    tnode2 = node_to_test(node2);
+
+    return tnode1->value - tnode2->value;
+}
+
+static long
+test_find(const bfdev_hlist_node_t *node, const void *key, void *pdata)
+{
+    struct test_node *tnode;
+
+    tnode = node_to_test(node);
+
+    return tnode->value - (unsigned long)key;
+}
+
+static bfdev_hashmap_ops_t
+test_ops = {
+    .hash_key = test_hash_key,
+    .hash_node = test_hash_node,
+    .equal = test_equal,
+    .find = test_find,
+};
+
+static int
+test_lookup(struct test_thread *tdata, bfdev_epoch_reader_t *reader,
+            unsigned long value, bool own)
+{
+    bfdev_hlist_node_t *hnode;
+    struct test_node *node;
+    int retval;
+
+    retval = -BFDEV_ENOERR;
+    bfdev_shardmap_read_lock(tdata->shardmap, reader);
+
+    hnode = bfdev_shardmap_find(tdata->shardmap, (void *)value);
+    if (hnode && node_to_test(hnode)->value != value) {
+        bfdev_log_err("lookup %lu returned %lu\n", value,
+                      node_to_test(hnode)->value);
+        retval = -BFDEV_EFAULT;
+    }
+
+    /* Nobody else writes our own keys, the answer must be exact */
+    node = &tdata->nodes[value];
+    if (own && !hnode != (node->state != TEST_INSERTED)) {
+        bfdev_log_err("lookup %lu mismatch\n", value);
+        retval = -BFDEV_EFAULT;
+    }
+
+    bfdev_shardmap_read_unlock(tdata->shardmap, reader);
+
+    return retval;
+}
+
+static void *
+test_worker(void *data)
+{
+    struct test_node *pending[TEST_PENDING];
+    struct test_thread *tdata;
+    bfdev_epoch_reader_t reader;
+    struct test_node *node;
+    unsigned long value;
+    unsigned int count, npending, index;
+    int retval;
+
+    tdata = data;
+    npending = 0;
+    retval = -BFDEV_ENOERR;
+    bfdev_shardmap_reader_register(tdata->shardmap, &reader);
+
+    for (count = 0; count < TEST_LOOP; ++count) {
+        value = rand_r(&tdata->seed) % (TEST_KEYS / TEST_THREADS);
+        value = value * TEST_THREADS + tdata->index;
+        node = &tdata->nodes[value];
+
+        if (node->state == TEST_INSERTED) {
+            retval = bfdev_shardmap_del(tdata->shardmap, (void *)value, NULL);
+            if (retval) {
+                bfdev_log_err("delete %lu failed\n", value);
+                break;
+            }
+
+            node->state = TEST_PENDING_FREE;
+            pending[npending++] = node;
+
+            if (npending == TEST_PENDING) {
+                bfdev_shardmap_synchronize(tdata->shardmap);
+                for (index = 0; index < npending; ++index)
+                    pending[index]->state = TEST_FREE;
+                npending = 0;
+            }
+        } else if (node->state == TEST_FREE) {
+            retval = bfdev_shardmap_add(tdata->shardmap, &node->node);
+            if (retval) {
+                bfdev_log_err("insert %lu failed\n", value);
+                break;
+            }
+
+            node->state = TEST_INSERTED;
+        }
+
+        retval = test_lookup(tdata, &reader, value, true);
+        if (retval)
+            break;
+
+        value = rand_r(&tdata->seed) % TEST_KEYS;
+        retval = test_lookup(tdata, &reader, value, false);
+        if (retval)
+            break;
+    }
+
+    bfdev_shardmap_reader_unregister(tdata->shardmap, &reader);
+    tdata->retval = retval;
+
+    return NULL;
+}
+
+static void *
+test_prepare(int argc, const char *argv[])
+{
+    struct test_node *nodes;
+
+    nodes = malloc(sizeof(*nodes) * TEST_KEYS);
+    if (!nodes)
+        return BFDEV_ERR_PTR(-BFDEV_ENOMEM);
+
+    return nodes;
+}
+
+static void
+test_release(void *data)
+{
+    free(data);
+}
+
+TESTSUITE(
+    "shardmap:fuzzy",
+    test_prepare, test_release,
+    "shardmap concurrent insert delete and lookup fuzzy test"
+) {
+    struct test_thread tdata[TEST_THREADS];
+    bfdev_shardmap_t test_map;
+    struct test_node *nodes;
+    unsigned long used;
+    unsigned int count;
+    int retval;
+
+    nodes = data;
+    for (count = 0; count < TEST_KEYS; ++count) {
+        nodes[count].value = count;
+        nodes[count].state = TEST_FREE;
+    }
+
+    retval = bfdev_shardmap_init(&test_map, NULL, &test_ops,
+                                 TEST_BITS, 2, NULL);
+    if (retval)
+        return retval;
+
+    srand(time(NULL));
+    for (count = 0; count < TEST_THREADS; ++count) {
+        tdata[count].shardmap = &test_map;
+        tdata[count].nodes = nodes;
+        tdata[count].index = count;
+        tdata[count].seed = rand();
+        pthread_create(&tdata[count].thread, NULL, test_worker, &tdata[count]);
+    }
+
+    for (count = 0; count < TEST_THREADS; ++count) {
+        pthread_join(tdata[count].thread, NULL);
+        if (tdata[count].retval)
+            retval = tdata[count].retval;
+    }
+
+    if (retval)
+        goto failed;
+
+    used = 0;
+    for (count = 0; count < TEST_KEYS; ++count) {
+        if (nodes[count].state == TEST_INSERTED)
+            used++;
+    }
+
+    if (bfdev_shardmap_used(&test_map) != used) {
+        bfdev_log_err("used count leak %lu -> %lu\n", used,
+                      bfdev_shardmap_used(&test_map));
+        retval = -BFDEV_EFAULT;
+    }
+
+failed:
+    bfdev_shardmap_release(&test_map);
+    return retval;
+}